@@ -0,0 +1,167 @@
+#include "Arena.h"
+#include <string.h>
+
+// Every block is preceded by a header holding its size
+typedef struct
+{
+  size_t size;
+  size_t previous;  // Offset of the previous block header, or SIZE_MAX
+} ARENA_BLOCK;
+
+static size_t Arena_AlignUp(size_t n)
+{
+  return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static ARENA_BLOCK *Arena_Header(void *ptr)
+{
+  return (ARENA_BLOCK *)((uint8_t *)ptr - Arena_AlignUp(sizeof(ARENA_BLOCK)));
+}
+
+/**
+ * Initializes an arena over a caller-supplied buffer
+ *
+ * @param arena Arena to initialize
+ * @param buffer Backing buffer, aligned to ARENA_ALIGN
+ * @param capacity Size of the buffer in bytes
+ */
+void Arena_Init(ARENA *arena, void *buffer, size_t capacity)
+{
+  arena->base = (uint8_t *)buffer;
+  arena->capacity = buffer != NULL ? capacity : 0;
+  arena->used = 0;
+  arena->highWater = 0;
+  arena->last = SIZE_MAX;
+}
+
+/**
+ * Allocates a block from the arena
+ *
+ * @param arena Arena to allocate from
+ * @param size Size of the block in bytes
+ * @return Pointer to the block, or NULL if the arena is full
+ */
+void *Arena_Alloc(ARENA *arena, size_t size)
+{
+  size_t headerSize = Arena_AlignUp(sizeof(ARENA_BLOCK));
+  size_t blockSize = headerSize + Arena_AlignUp(size);
+
+  if (size == 0 || blockSize < size || blockSize > arena->capacity - arena->used) {
+    return NULL;
+  }
+
+  ARENA_BLOCK *header = (ARENA_BLOCK *)(arena->base + arena->used);
+  header->size = size;
+  header->previous = arena->last;
+  arena->last = arena->used;
+  arena->used += blockSize;
+  if (arena->used > arena->highWater) {
+    arena->highWater = arena->used;
+  }
+  return (uint8_t *)header + headerSize;
+}
+
+/**
+ * Resizes a block
+ *
+ * The most recent block is resized in place; any other block is copied
+ * to a new one, and its old space is only reclaimed by Arena_Reset.
+ *
+ * @param arena Arena the block belongs to
+ * @param ptr Block to resize, or NULL to allocate a new one
+ * @param size New size in bytes
+ * @return Pointer to the resized block, or NULL if the arena is full
+ */
+void *Arena_Realloc(ARENA *arena, void *ptr, size_t size)
+{
+  if (ptr == NULL) {
+    return Arena_Alloc(arena, size);
+  }
+
+  ARENA_BLOCK *header = Arena_Header(ptr);
+  size_t offset = (uint8_t *)header - arena->base;
+
+  if (offset == arena->last) {
+    size_t blockSize = Arena_AlignUp(sizeof(ARENA_BLOCK)) + Arena_AlignUp(size);
+    if (size == 0 || blockSize < size || blockSize > arena->capacity - offset) {
+      return NULL;
+    }
+    header->size = size;
+    arena->used = offset + blockSize;
+    if (arena->used > arena->highWater) {
+      arena->highWater = arena->used;
+    }
+    return ptr;
+  }
+
+  void *block = Arena_Alloc(arena, size);
+  if (block != NULL) {
+    memcpy(block, ptr, header->size < size ? header->size : size);
+  }
+  return block;
+}
+
+/**
+ * Releases a block
+ *
+ * Space is given back only if the block is the most recent one;
+ * everything else is reclaimed by Arena_Reset.
+ *
+ * @param arena Arena the block belongs to
+ * @param ptr Block to release, may be NULL
+ */
+void Arena_Free(ARENA *arena, void *ptr)
+{
+  if (ptr == NULL) {
+    return;
+  }
+
+  ARENA_BLOCK *header = Arena_Header(ptr);
+  size_t offset = (uint8_t *)header - arena->base;
+  if (offset == arena->last) {
+    arena->last = header->previous;
+    arena->used = offset;
+  }
+}
+
+/**
+ * Releases every block at once
+ *
+ * The high-water mark is kept so it can be reported afterwards.
+ *
+ * @param arena Arena to reset
+ */
+void Arena_Reset(ARENA *arena)
+{
+  arena->used = 0;
+  arena->last = SIZE_MAX;
+}
+
+/**
+ * Records the current top of the arena
+ *
+ * @param arena Arena to mark
+ * @return Mark to pass to Arena_Rewind
+ */
+ARENA_MARK Arena_Mark(const ARENA *arena)
+{
+  ARENA_MARK mark = {arena->used, arena->last};
+  return mark;
+}
+
+/**
+ * Releases every block allocated since a mark
+ *
+ * Lets a loop reuse the same space for each iteration, e.g. one JSON
+ * document per array element.
+ *
+ * @param arena Arena the mark was taken from
+ * @param mark Mark returned by Arena_Mark
+ */
+void Arena_Rewind(ARENA *arena, ARENA_MARK mark)
+{
+  if (mark.used <= arena->used) {
+    arena->used = mark.used;
+    arena->last = mark.last;
+  }
+}
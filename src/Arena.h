@@ -0,0 +1,43 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Bump allocator for memory that lives for one wake cycle
+ *
+ * Allocations are carved sequentially out of one buffer and released all
+ * at once with Arena_Reset. Only the most recent block can be grown in
+ * place or given back, which matches how JSON documents grow. The
+ * buffer is supplied by the caller: PSRAM on the device, a plain array on
+ * the host. The response body does not pass through it: its chunks are
+ * copied through the pipeline's queue in internal RAM.
+ */
+
+#define ARENA_ALIGN 8  // Alignment of every block
+
+typedef struct
+{
+  uint8_t *base;      // Start of the buffer
+  size_t capacity;    // Size of the buffer in bytes
+  size_t used;        // Bytes in use, including block headers
+  size_t highWater;   // Largest value of used since Arena_Init
+  size_t last;        // Offset of the most recent block header, or SIZE_MAX
+} ARENA;
+
+typedef struct
+{
+  size_t used;
+  size_t last;
+} ARENA_MARK;
+
+void Arena_Init(ARENA *arena, void *buffer, size_t capacity);
+void *Arena_Alloc(ARENA *arena, size_t size);
+void *Arena_Realloc(ARENA *arena, void *ptr, size_t size);
+void Arena_Free(ARENA *arena, void *ptr);
+void Arena_Reset(ARENA *arena);
+ARENA_MARK Arena_Mark(const ARENA *arena);
+void Arena_Rewind(ARENA *arena, ARENA_MARK mark);
+
+#endif
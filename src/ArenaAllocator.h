@@ -0,0 +1,33 @@
+#ifndef _ARENA_ALLOCATOR_H_
+#define _ARENA_ALLOCATOR_H_
+
+#include <ArduinoJson.h>
+#include "Arena.h"
+
+/**
+ * ArduinoJson allocator drawing from an arena
+ *
+ * Pass it to a JsonDocument so the whole document lives in the arena
+ * and is dropped with Arena_Reset.
+ */
+class ArenaAllocator : public ArduinoJson::Allocator {
+ public:
+  explicit ArenaAllocator(ARENA* arena) : arena_(arena) {}
+
+  void* allocate(size_t size) override {
+    return Arena_Alloc(arena_, size);
+  }
+
+  void deallocate(void* ptr) override {
+    Arena_Free(arena_, ptr);
+  }
+
+  void* reallocate(void* ptr, size_t new_size) override {
+    return Arena_Realloc(arena_, ptr, new_size);
+  }
+
+ private:
+  ARENA* arena_;
+};
+
+#endif
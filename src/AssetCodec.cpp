@@ -0,0 +1,162 @@
+#include "AssetCodec.h"
+#include <string.h>
+
+/**
+ * Walks one encoded row, writing it to row unless row is NULL
+ *
+ * @param dec Decoder state
+ * @param row Output buffer of Asset_RowBytes() bytes, or NULL to skip the row
+ * @return true if a whole row was consumed, false on a truncated or corrupt stream
+ */
+static bool Asset_ProcessRow(ASSET_DECODER *dec, uint8_t *row)
+{
+  const COMPRESSED_ASSET *asset = dec->asset;
+  const uint16_t rowBytes = Asset_RowBytes(asset);
+  uint16_t filled = 0;
+
+  if (dec->row >= asset->height) {
+    return false;
+  }
+
+  while (filled < rowBytes) {
+    if (dec->pos >= asset->dataSize) {
+      return false;
+    }
+    uint8_t control = asset->data[dec->pos++];
+
+    if (control < 0x80) {
+      // Literal run
+      uint16_t count = control + 1;
+      if (filled + count > rowBytes || dec->pos + count > asset->dataSize) {
+        return false;
+      }
+      if (row) {
+        memcpy(row + filled, asset->data + dec->pos, count);
+      }
+      dec->pos += count;
+      filled += count;
+    } else {
+      // Repeat run
+      uint16_t count = control - 0x80 + ASSET_MIN_REPEAT;
+      if (filled + count > rowBytes || dec->pos >= asset->dataSize) {
+        return false;
+      }
+      if (row) {
+        memset(row + filled, asset->data[dec->pos], count);
+      }
+      dec->pos++;
+      filled += count;
+    }
+  }
+
+  dec->row++;
+  return true;
+}
+
+/**
+ * Prepares a decoder to start at the given row
+ *
+ * Seeks to the nearest restart point at or before firstRow and skips
+ * the remaining rows without expanding them.
+ *
+ * @param dec Decoder state to initialize
+ * @param asset Asset to decode
+ * @param firstRow First row to be returned by Asset_DecodeRow
+ */
+void Asset_DecoderInit(ASSET_DECODER *dec, const COMPRESSED_ASSET *asset, uint16_t firstRow)
+{
+  dec->asset = asset;
+  dec->pos = 0;
+  dec->row = 0;
+
+  if (firstRow >= asset->height) {
+    dec->row = asset->height;
+    return;
+  }
+
+  uint16_t restart = firstRow / ASSET_RESTART_INTERVAL;
+  dec->pos = asset->restarts[restart];
+  dec->row = restart * ASSET_RESTART_INTERVAL;
+
+  while (dec->row < firstRow) {
+    if (!Asset_SkipRow(dec)) {
+      dec->row = asset->height;
+      return;
+    }
+  }
+}
+
+/**
+ * Decodes the next row of the asset
+ *
+ * @param dec Decoder state
+ * @param row Output buffer of Asset_RowBytes() bytes
+ * @return true on success, false at the end of the asset or on a corrupt stream
+ */
+bool Asset_DecodeRow(ASSET_DECODER *dec, uint8_t *row)
+{
+  return Asset_ProcessRow(dec, row);
+}
+
+/**
+ * Skips the next row of the asset without expanding it
+ *
+ * @param dec Decoder state
+ * @return true on success, false at the end of the asset or on a corrupt stream
+ */
+bool Asset_SkipRow(ASSET_DECODER *dec)
+{
+  return Asset_ProcessRow(dec, NULL);
+}
+
+/**
+ * Encodes one row with PackBits
+ *
+ * @param row Row to encode
+ * @param rowBytes Number of bytes in the row
+ * @param out Output buffer
+ * @param outCapacity Size of the output buffer
+ * @return Number of bytes written, or 0 if the output buffer is too small
+ */
+size_t Asset_EncodeRow(const uint8_t *row, uint16_t rowBytes, uint8_t *out, size_t outCapacity)
+{
+  size_t outPos = 0;
+  uint16_t i = 0;
+
+  while (i < rowBytes) {
+    // Measure the repeat run starting here
+    uint16_t run = 1;
+    while (i + run < rowBytes && run < ASSET_MAX_REPEAT && row[i + run] == row[i]) {
+      run++;
+    }
+
+    if (run >= ASSET_MIN_REPEAT) {
+      if (outPos + 2 > outCapacity) {
+        return 0;
+      }
+      out[outPos++] = (uint8_t)(0x80 + run - ASSET_MIN_REPEAT);
+      out[outPos++] = row[i];
+      i += run;
+      continue;
+    }
+
+    // Collect literals until the next repeat run worth encoding
+    uint16_t start = i;
+    while (i < rowBytes && i - start < ASSET_MAX_LITERAL) {
+      if (i + 2 < rowBytes && row[i] == row[i + 1] && row[i] == row[i + 2]) {
+        break;
+      }
+      i++;
+    }
+
+    uint16_t count = i - start;
+    if (outPos + 1 + count > outCapacity) {
+      return 0;
+    }
+    out[outPos++] = (uint8_t)(count - 1);
+    memcpy(out + outPos, row + start, count);
+    outPos += count;
+  }
+
+  return outPos;
+}
@@ -0,0 +1,55 @@
+#ifndef _ASSET_CODEC_H_
+#define _ASSET_CODEC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Compressed 1-bpp asset format
+ *
+ * Pixel rows use the same layout as the bitmaps accepted by EPD_ShowPicture
+ * (MSB first, one bit per pixel, rows padded to whole bytes).
+ * Every row is PackBits-encoded on its own, so a run never crosses a row
+ * boundary and decoding can start at any row:
+ *   - control byte 0x00..0x7F: copy the next (n + 1) bytes literally
+ *   - control byte 0x80..0xFF: repeat the next byte (n - 0x80 + 3) times
+ *
+ * A restart table holds the stream offset of every ASSET_RESTART_INTERVAL-th
+ * row, so a decoder can seek to a row without walking the whole stream.
+ */
+
+#define ASSET_RESTART_INTERVAL 16  // Rows between restart points
+#define ASSET_MAX_LITERAL 128      // Longest literal run of one control byte
+#define ASSET_MIN_REPEAT 3         // Shortest repeat run worth encoding
+#define ASSET_MAX_REPEAT 130       // Longest repeat run of one control byte
+
+typedef struct
+{
+  uint16_t width;            // Width in pixels
+  uint16_t height;           // Height in pixels
+  uint32_t dataSize;         // Size of the compressed stream in bytes
+  const uint16_t *restarts;  // Stream offset of every ASSET_RESTART_INTERVAL-th row
+  const uint8_t *data;       // Compressed stream
+} COMPRESSED_ASSET;
+
+typedef struct
+{
+  const COMPRESSED_ASSET *asset;
+  uint32_t pos;              // Read position in the compressed stream
+  uint16_t row;              // Next row to be decoded
+} ASSET_DECODER;
+
+/**
+ * Returns the number of bytes in one decoded row of the asset
+ */
+static inline uint16_t Asset_RowBytes(const COMPRESSED_ASSET *asset)
+{
+  return (asset->width + 7) / 8;
+}
+
+void Asset_DecoderInit(ASSET_DECODER *dec, const COMPRESSED_ASSET *asset, uint16_t firstRow);
+bool Asset_DecodeRow(ASSET_DECODER *dec, uint8_t *row);
+bool Asset_SkipRow(ASSET_DECODER *dec);
+size_t Asset_EncodeRow(const uint8_t *row, uint16_t rowBytes, uint8_t *out, size_t outCapacity);
+
+#endif
@@ -0,0 +1,237 @@
+#include "AssetPack.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_partition.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR < 5
+#include <esp_spi_flash.h>
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Attaches a pack to an already mapped memory region and validates it
+ *
+ * @param pack Pack to initialize
+ * @param base Start of the mapped region
+ * @param size Size of the mapped region in bytes
+ * @return true if the region holds a valid pack
+ */
+bool AssetPack_Attach(ASSET_PACK *pack, const void *base, size_t size)
+{
+  memset(pack, 0, sizeof(*pack));
+
+  if (size < sizeof(ASSET_PACK_HEADER)) {
+    return false;
+  }
+
+  const ASSET_PACK_HEADER *header = (const ASSET_PACK_HEADER *)base;
+  if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION) {
+    return false;
+  }
+  if (header->totalSize > size || header->totalSize < sizeof(ASSET_PACK_HEADER) ||
+      header->directoryOffset % ASSET_PACK_ALIGN != 0) {
+    return false;
+  }
+
+  // The pack can be replaced on its own, so no sum here may wrap around
+  if (header->directoryOffset > header->totalSize ||
+      header->entryCount > (header->totalSize - header->directoryOffset) / sizeof(ASSET_PACK_ENTRY)) {
+    return false;
+  }
+
+  const uint8_t *bytes = (const uint8_t *)base;
+  const ASSET_PACK_ENTRY *entries = (const ASSET_PACK_ENTRY *)(bytes + header->directoryOffset);
+
+  // Reject entries pointing outside the pack, so lookups need no further checks
+  for (uint16_t i = 0; i < header->entryCount; i++) {
+    if (entries[i].offset % ASSET_PACK_ALIGN != 0 ||
+        entries[i].offset > header->totalSize ||
+        entries[i].size > header->totalSize - entries[i].offset) {
+      return false;
+    }
+  }
+
+  pack->base = bytes;
+  pack->size = header->totalSize;
+  pack->entries = entries;
+  pack->entryCount = header->entryCount;
+  return true;
+}
+
+/**
+ * Looks up an asset by name
+ *
+ * @param pack Pack to search
+ * @param name Asset name
+ * @return Directory entry, or NULL if not found
+ */
+const ASSET_PACK_ENTRY *AssetPack_Find(const ASSET_PACK *pack, const char *name)
+{
+  for (uint16_t i = 0; i < pack->entryCount; i++) {
+    if (strncmp(pack->entries[i].name, name, ASSET_PACK_NAME_LENGTH) == 0) {
+      return &pack->entries[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Returns a pointer to the blob of an asset inside the mapping
+ *
+ * @param pack Pack the entry belongs to
+ * @param entry Directory entry
+ * @return Pointer to the first byte of the blob
+ */
+const uint8_t *AssetPack_Data(const ASSET_PACK *pack, const ASSET_PACK_ENTRY *entry)
+{
+  return pack->base + entry->offset;
+}
+
+/**
+ * Describes a compressed bitmap in the pack without copying it
+ *
+ * @param pack Pack the entry belongs to
+ * @param entry Directory entry of type ASSET_TYPE_RLE_BITMAP
+ * @param asset Filled with pointers into the mapping
+ * @return true on success, false if the entry is not a valid compressed bitmap
+ */
+bool AssetPack_GetCompressed(const ASSET_PACK *pack, const ASSET_PACK_ENTRY *entry, COMPRESSED_ASSET *asset)
+{
+  if (entry->type != ASSET_TYPE_RLE_BITMAP) {
+    return false;
+  }
+
+  uint32_t restartBytes = ((entry->height + ASSET_RESTART_INTERVAL - 1) / ASSET_RESTART_INTERVAL) * sizeof(uint16_t);
+  if (entry->size < restartBytes) {
+    return false;
+  }
+
+  const uint8_t *blob = AssetPack_Data(pack, entry);
+  asset->width = entry->width;
+  asset->height = entry->height;
+  asset->restarts = (const uint16_t *)blob;
+  asset->data = blob + restartBytes;
+  asset->dataSize = entry->size - restartBytes;
+  return true;
+}
+
+#ifdef ARDUINO
+
+/**
+ * Maps the asset partition into the data address space
+ *
+ * @param pack Pack to initialize
+ * @param source Partition label
+ * @return true if the partition holds a valid pack
+ */
+bool AssetPack_Open(ASSET_PACK *pack, const char *source)
+{
+  memset(pack, 0, sizeof(*pack));
+
+  const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, source);
+  if (partition == NULL) {
+    return false;
+  }
+
+  const void *base;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_partition_mmap_handle_t handle;
+  if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &base, &handle) != ESP_OK) {
+    return false;
+  }
+#else
+  spi_flash_mmap_handle_t handle;
+  if (esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &base, &handle) != ESP_OK) {
+    return false;
+  }
+#endif
+
+  if (!AssetPack_Attach(pack, base, partition->size)) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_munmap(handle);
+#else
+    spi_flash_munmap(handle);
+#endif
+    return false;
+  }
+
+  pack->handle = (uintptr_t)handle;
+  return true;
+}
+
+/**
+ * Releases the mapping of the asset partition
+ *
+ * @param pack Pack to close
+ */
+void AssetPack_Close(ASSET_PACK *pack)
+{
+  if (pack->base != NULL) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_munmap((esp_partition_mmap_handle_t)pack->handle);
+#else
+    spi_flash_munmap((spi_flash_mmap_handle_t)pack->handle);
+#endif
+  }
+  memset(pack, 0, sizeof(*pack));
+}
+
+#else
+
+/**
+ * Maps a pack file into memory
+ *
+ * @param pack Pack to initialize
+ * @param source Path of the pack file
+ * @return true if the file holds a valid pack
+ */
+bool AssetPack_Open(ASSET_PACK *pack, const char *source)
+{
+  memset(pack, 0, sizeof(*pack));
+
+  int fd = open(source, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  void *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+
+  if (!AssetPack_Attach(pack, base, st.st_size)) {
+    munmap(base, st.st_size);
+    return false;
+  }
+
+  pack->handle = (uintptr_t)st.st_size;  // Mapping length, needed by munmap
+  return true;
+}
+
+/**
+ * Unmaps a pack file
+ *
+ * @param pack Pack to close
+ */
+void AssetPack_Close(ASSET_PACK *pack)
+{
+  if (pack->base != NULL) {
+    munmap((void *)pack->base, (size_t)pack->handle);
+  }
+  memset(pack, 0, sizeof(*pack));
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef _ASSET_PACK_H_
+#define _ASSET_PACK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "AssetCodec.h"
+
+/**
+ * Asset pack
+ *
+ * A read-only container for fonts and icons, stored in its own flash data
+ * partition so it can be replaced without reflashing the firmware.
+ * On the device the partition is memory-mapped; on the host the pack file
+ * is mmap()ed. Lookups return pointers into the mapping, nothing is copied.
+ *
+ * Layout (all fields little-endian):
+ *   ASSET_PACK_HEADER
+ *   ASSET_PACK_ENTRY x entryCount, at directoryOffset
+ *   blobs, each starting at a multiple of ASSET_PACK_ALIGN
+ *
+ * Packs are built by tools/build_assetpack.py.
+ */
+
+#define ASSET_PACK_MAGIC 0x4B415045   // "EPAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGN 16
+#define ASSET_PACK_NAME_LENGTH 20
+#define ASSET_PACK_PARTITION "assets" // Partition label in partitions.csv
+
+// Asset types
+#define ASSET_TYPE_BITMAP 1      // Rows in EPD_ShowPicture format
+#define ASSET_TYPE_RLE_BITMAP 2  // Restart table followed by a stream (see AssetCodec.h)
+#define ASSET_TYPE_FONT 3        // Glyphs in EPD_ShowChar format, starting at ' '
+
+typedef struct
+{
+  uint32_t magic;            // ASSET_PACK_MAGIC
+  uint16_t version;          // ASSET_PACK_VERSION
+  uint16_t entryCount;       // Number of directory entries
+  uint32_t directoryOffset;  // Offset of the first directory entry
+  uint32_t totalSize;        // Size of the whole pack in bytes
+} ASSET_PACK_HEADER;
+
+typedef struct
+{
+  char name[ASSET_PACK_NAME_LENGTH];  // NUL-padded name
+  uint8_t type;              // ASSET_TYPE_*
+  uint8_t reserved;
+  uint16_t width;            // Bitmap width, or font size for fonts
+  uint16_t height;           // Bitmap height, or number of glyphs for fonts
+  uint16_t stride;           // Bytes per row for bitmaps, bytes per glyph for fonts
+  uint32_t offset;           // Offset of the blob from the start of the pack
+  uint32_t size;             // Size of the blob in bytes
+} ASSET_PACK_ENTRY;
+
+typedef struct
+{
+  const uint8_t *base;             // Start of the mapping
+  size_t size;                     // Size of the pack
+  const ASSET_PACK_ENTRY *entries; // Directory
+  uint16_t entryCount;
+  uintptr_t handle;                // Platform mapping handle
+} ASSET_PACK;
+
+bool AssetPack_Open(ASSET_PACK *pack, const char *source);
+void AssetPack_Close(ASSET_PACK *pack);
+bool AssetPack_Attach(ASSET_PACK *pack, const void *base, size_t size);
+const ASSET_PACK_ENTRY *AssetPack_Find(const ASSET_PACK *pack, const char *name);
+const uint8_t *AssetPack_Data(const ASSET_PACK *pack, const ASSET_PACK_ENTRY *entry);
+bool AssetPack_GetCompressed(const ASSET_PACK *pack, const ASSET_PACK_ENTRY *entry, COMPRESSED_ASSET *asset);
+
+#endif
@@ -0,0 +1,175 @@
+#include "Battery.h"
+#include <string.h>
+
+#define BATTERY_MAGIC 0x42415431  // "BAT1"
+
+/**
+ * Prepares the state unless it already holds valid data
+ *
+ * @param state State kept in RTC memory
+ */
+void Battery_Init(BatteryState* state) {
+  if (state->magic != BATTERY_MAGIC) {
+    memset(state, 0, sizeof(*state));
+    state->magic = BATTERY_MAGIC;
+  }
+}
+
+/**
+ * Averages ADC samples, leaving out the lowest and highest quarter
+ *
+ * @param samples Samples in millivolts
+ * @param count Number of samples, at most BATTERY_MAX_SAMPLES
+ * @return Mean of the middle samples, 0 without samples
+ */
+uint16_t Battery_Average(const uint16_t* samples, int count) {
+  uint16_t sorted[BATTERY_MAX_SAMPLES];
+  if (count <= 0) {
+    return 0;
+  }
+  if (count > BATTERY_MAX_SAMPLES) {
+    count = BATTERY_MAX_SAMPLES;
+  }
+
+  // Insertion sort, count is small
+  for (int i = 0; i < count; i++) {
+    int j = i;
+    for (; j > 0 && sorted[j - 1] > samples[i]; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = samples[i];
+  }
+
+  int skip = count / 4;
+  uint32_t sum = 0;
+  for (int i = skip; i < count - skip; i++) {
+    sum += sorted[i];
+  }
+  return (uint16_t)(sum / (count - 2 * skip));
+}
+
+/**
+ * Remaining capacity at a voltage, interpolated along the discharge curve
+ *
+ * @param policy Policy holding the curve
+ * @param millivolts Battery voltage
+ * @return Capacity in percent, clamped to the ends of the curve
+ */
+uint8_t Battery_Percent(const BatteryPolicy* policy, uint16_t millivolts) {
+  const BatteryCurvePoint* curve = policy->curve;
+  int points = policy->curvePoints;
+  if (points == 0) {
+    return 100;
+  }
+  if (millivolts >= curve[0].millivolts) {
+    return curve[0].percent;
+  }
+
+  for (int i = 1; i < points; i++) {
+    if (millivolts >= curve[i].millivolts) {
+      const BatteryCurvePoint& high = curve[i - 1];
+      const BatteryCurvePoint& low = curve[i];
+      int span = high.millivolts - low.millivolts;
+      return (uint8_t)(low.percent + ((int)high.percent - low.percent) * (millivolts - low.millivolts) / span);
+    }
+  }
+  return curve[points - 1].percent;
+}
+
+/**
+ * Counts the steps that apply below a capacity, steps being sorted by
+ * falling belowPercent
+ */
+static uint8_t Battery_StepsBelow(const BatteryPolicy* policy, int percent) {
+  uint8_t level = 0;
+  while (level < policy->stepCount && percent < policy->steps[level].belowPercent) {
+    level++;
+  }
+  return level;
+}
+
+/**
+ * Takes a new reading and updates the capacity and the policy step
+ *
+ * Readings are smoothed with an exponential moving average of weight 1/4,
+ * except for the first one and sudden rises from charging.
+ *
+ * @param state Battery state
+ * @param policy Battery policy
+ * @param millivolts Averaged voltage of this wake, e.g., from Battery_Average
+ */
+void Battery_Update(BatteryState* state, const BatteryPolicy* policy, uint16_t millivolts) {
+  if (state->millivolts == 0 || millivolts >= state->millivolts + BATTERY_CHARGE_JUMP_MV) {
+    state->millivolts = millivolts;
+  } else {
+    state->millivolts = (uint16_t)((state->millivolts * 3 + millivolts) / 4);
+  }
+
+  state->external = policy->externalMillivolts != 0 && state->millivolts >= policy->externalMillivolts;
+  state->percent = state->external ? 100 : Battery_Percent(policy, state->millivolts);
+
+  // Deeper steps apply at once, shallower ones only past the margin
+  uint8_t down = Battery_StepsBelow(policy, state->percent);
+  uint8_t up = Battery_StepsBelow(policy, state->percent - policy->hysteresisPercent);
+  if (down > state->level) {
+    state->level = down;
+  } else if (up < state->level) {
+    state->level = up;
+  }
+}
+
+/**
+ * Update interval for the battery state
+ *
+ * @param state Battery state
+ * @param policy Battery policy
+ * @param intervalSeconds Interval on a full battery
+ * @return Interval in seconds
+ */
+uint32_t Battery_IntervalSeconds(const BatteryState* state, const BatteryPolicy* policy, uint32_t intervalSeconds) {
+  if (state->level == 0 || state->level > policy->stepCount) {
+    return intervalSeconds;
+  }
+  return intervalSeconds * policy->steps[state->level - 1].intervalScale;
+}
+
+/**
+ * Partial updates allowed between full refreshes for the battery state
+ *
+ * @param state Battery state
+ * @param policy Battery policy
+ * @param maxPartialUpdates Partial updates on a full battery
+ */
+uint16_t Battery_MaxPartialUpdates(const BatteryState* state, const BatteryPolicy* policy, uint16_t maxPartialUpdates) {
+  if (state->level == 0 || state->level > policy->stepCount) {
+    return maxPartialUpdates;
+  }
+  return policy->steps[state->level - 1].maxPartialUpdates;
+}
+
+/**
+ * Bars of a battery glyph showing the capacity
+ *
+ * A change by one bar needs the capacity BATTERY_BAR_MARGIN_PERCENT past
+ * the boundary, so the glyph does not flicker between two bars.
+ *
+ * @param state Battery state
+ * @param fullBars Bars of a full battery
+ * @param shownBars Bars shown now, -1 if none
+ * @return 0 to fullBars, rounded to the nearest bar
+ */
+uint8_t Battery_Bars(const BatteryState* state, uint8_t fullBars, int shownBars) {
+  int bars = (state->percent * fullBars + 50) / 100;
+  if (shownBars >= 0 && (bars == shownBars + 1 || bars == shownBars - 1)) {
+    // Boundary between the two, in hundredths of a percent
+    int boundary = ((bars < shownBars ? bars : shownBars) * 100 + 50) * 100 / fullBars;
+    int distance = state->percent * 100 - boundary;
+    if (distance < 0) {
+      distance = -distance;
+    }
+    if (distance < BATTERY_BAR_MARGIN_PERCENT * 100) {
+      return (uint8_t)shownBars;
+    }
+  }
+  return (uint8_t)bars;
+}
@@ -0,0 +1,67 @@
+#ifndef _BATTERY_H_
+#define _BATTERY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Battery capacity estimate and the update policy it drives
+ *
+ * The supply voltage is sampled several times per wake and averaged with
+ * the outliers dropped, then smoothed across wakes in RTC memory. A
+ * discharge curve turns it into a remaining capacity, and the capacity
+ * selects a step of the policy: each step stretches the update interval
+ * and allows more partial updates between full refreshes, which cost the
+ * most. Steps are left only once the capacity has risen a margin above
+ * them, so a voltage wavering at a threshold does not switch back and
+ * forth. Voltages are passed in, so recorded traces can drive the policy
+ * on the host.
+ */
+
+#define BATTERY_MAX_SAMPLES 32       // Samples averaged per reading
+#define BATTERY_CHARGE_JUMP_MV 100   // A rise this large is charging, taken without smoothing
+#define BATTERY_BAR_MARGIN_PERCENT 2 // Distance past a bar boundary before the glyph changes by a bar
+
+/**
+ * Point of a discharge curve
+ */
+struct BatteryCurvePoint {
+  uint16_t millivolts;
+  uint8_t percent;
+};
+
+/**
+ * Step of the policy, applying below a capacity
+ */
+struct BatteryStep {
+  uint8_t belowPercent;              // Applies while the capacity is below this
+  uint8_t intervalScale;             // Multiplier of the update interval
+  uint16_t maxPartialUpdates;        // Partial updates between full refreshes
+};
+
+struct BatteryPolicy {
+  const BatteryCurvePoint* curve;    // Discharge curve, voltages falling
+  uint8_t curvePoints;
+  const BatteryStep* steps;          // Steps, capacities falling
+  uint8_t stepCount;
+  uint8_t hysteresisPercent;         // Rise above a step needed to leave it
+  uint16_t externalMillivolts;       // At or above this, on external power
+};
+
+struct BatteryState {
+  uint32_t magic;                    // Valid when set by Battery_Init
+  uint16_t millivolts;               // Smoothed voltage, 0 before the first reading
+  uint8_t percent;                   // Remaining capacity
+  uint8_t level;                     // Steps applying: steps[level - 1] is in effect, 0 for none
+  bool external;                     // On external power
+};
+
+void Battery_Init(BatteryState* state);
+uint16_t Battery_Average(const uint16_t* samples, int count);
+uint8_t Battery_Percent(const BatteryPolicy* policy, uint16_t millivolts);
+void Battery_Update(BatteryState* state, const BatteryPolicy* policy, uint16_t millivolts);
+uint32_t Battery_IntervalSeconds(const BatteryState* state, const BatteryPolicy* policy, uint32_t intervalSeconds);
+uint16_t Battery_MaxPartialUpdates(const BatteryState* state, const BatteryPolicy* policy, uint16_t maxPartialUpdates);
+uint8_t Battery_Bars(const BatteryState* state, uint8_t fullBars, int shownBars);
+
+#endif
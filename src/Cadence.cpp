@@ -0,0 +1,132 @@
+#include "Cadence.h"
+
+#define CADENCE_MINUTES_PER_DAY 1440
+
+/**
+ * Icon as far as the weather goes: clear day and clear night are the same
+ */
+static uint8_t Cadence_WeatherIcon(uint8_t icon) {
+  return icon == ICON_CLEAR_NIGHT ? (uint8_t)ICON_CLEAR_DAY : icon;
+}
+
+/**
+ * Scores how much the forecast changes over the display horizon
+ *
+ * Each hour is compared with the one before it, from the hour containing
+ * now to horizonHours later.
+ *
+ * @param cache Cached hourly series
+ * @param now Current time (UTC)
+ * @param horizonHours Hours looked ahead
+ * @return Sum of the CADENCE_*_POINTS of every change; 0 without a series
+ */
+uint16_t Cadence_Volatility(const ForecastCache* cache, int32_t now, uint8_t horizonHours) {
+  if (!ForecastCache_IsValid(cache) || now < cache->firstHour) {
+    return 0;
+  }
+
+  int present = (now - cache->firstHour) / 3600;
+  ForecastInfo previous, hour;
+  if (!ForecastCache_Get(cache, present, &previous)) {
+    return 0;
+  }
+
+  uint32_t score = 0;
+  for (int i = present + 1; i <= present + horizonHours && ForecastCache_Get(cache, i, &hour); i++) {
+    int degrees = (hour.temperature - previous.temperature) / 100;
+    int popTens = ((int)hour.pop - previous.pop) / 10;
+    score += (degrees < 0 ? -degrees : degrees) * CADENCE_TEMPERATURE_POINTS;
+    score += (popTens < 0 ? -popTens : popTens) * CADENCE_POP_POINTS;
+    if (Cadence_WeatherIcon(hour.iconNumber) != Cadence_WeatherIcon(previous.iconNumber)) {
+      score += CADENCE_ICON_POINTS;
+    }
+    previous = hour;
+  }
+  return (uint16_t)(score > UINT16_MAX ? UINT16_MAX : score);
+}
+
+/**
+ * Places a value between two bounds by the volatility: lo when fully
+ * volatile, hi when stable
+ */
+static uint32_t Cadence_Scale(const CadenceConfig* config, uint32_t lo, uint32_t hi, uint16_t score) {
+  if (hi <= lo || score >= config->volatileScore || config->volatileScore <= config->stableScore) {
+    return lo;
+  }
+  if (score <= config->stableScore) {
+    return hi;
+  }
+  uint32_t range = config->volatileScore - config->stableScore;
+  return hi - (uint32_t)((uint64_t)(hi - lo) * (score - config->stableScore) / range);
+}
+
+/**
+ * Plans the next wake from the cached series
+ *
+ * Without a usable series the plan is the shortest interval and age, so
+ * the next wake fetches.
+ *
+ * @param config Cadence settings
+ * @param cache Cached hourly series
+ * @param now Current time (UTC)
+ * @param plan Receives the plan
+ */
+void Cadence_Plan(const CadenceConfig* config, const ForecastCache* cache, int32_t now, CadencePlan* plan) {
+  if (!ForecastCache_IsValid(cache) || now < cache->firstHour) {
+    plan->score = config->volatileScore;
+  } else {
+    plan->score = Cadence_Volatility(cache, now, config->horizonHours);
+  }
+  plan->intervalSeconds = Cadence_Scale(config, config->minSeconds, config->maxSeconds, plan->score);
+  plan->maxAgeSeconds = Cadence_Scale(config, config->minAgeSeconds, config->maxAgeSeconds, plan->score);
+}
+
+/**
+ * Minutes from a local minute of the day to the end of the quiet window
+ * containing it
+ *
+ * @return 0 when the minute is in no window
+ */
+static int Cadence_QuietMinutesLeft(const CadenceConfig* config, int minute) {
+  int longest = 0;
+  for (int i = 0; i < config->quietCount; i++) {
+    int start = config->quiet[i].startMinute;
+    int end = config->quiet[i].endMinute;
+    int left = 0;
+    if (start <= end) {
+      left = minute >= start && minute < end ? end - minute : 0;
+    } else if (minute >= start) {
+      left = CADENCE_MINUTES_PER_DAY - minute + end;
+    } else if (minute < end) {
+      left = end - minute;
+    }
+    if (left > longest) {
+      longest = left;
+    }
+  }
+  return longest;
+}
+
+/**
+ * Moves a wake that falls in a quiet window to the end of the window
+ *
+ * Adjoining windows are skipped together.
+ *
+ * @param config Cadence settings with the quiet windows
+ * @param now Current time (UTC)
+ * @param intervalSeconds Planned time until the wake
+ * @return Time until the wake, at least intervalSeconds
+ */
+uint32_t Cadence_SkipQuiet(const CadenceConfig* config, int32_t now, uint32_t intervalSeconds) {
+  int64_t wake = (int64_t)now + intervalSeconds;
+  for (int i = 0; i <= config->quietCount; i++) {
+    int64_t local = wake + config->utcOffsetSeconds;
+    int minute = (int)(((local % 86400) + 86400) % 86400 / 60);
+    int left = Cadence_QuietMinutesLeft(config, minute);
+    if (left == 0) {
+      break;
+    }
+    wake += (int64_t)left * 60 - ((local % 60) + 60) % 60;  // To the end of the window, on the minute
+  }
+  return (uint32_t)(wake - now);
+}
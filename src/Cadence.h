@@ -0,0 +1,59 @@
+#ifndef _CADENCE_H_
+#define _CADENCE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ForecastCache.h"
+
+/**
+ * Update cadence chosen from the forecast itself
+ *
+ * The cached hourly series shows how much the display is about to change
+ * over its horizon: temperature steps, swings in the probability of
+ * precipitation, and weather icon transitions. A volatile series wakes at
+ * the shortest interval and fetches again at the shortest forecast age; a
+ * stable one, whose score covers little more than the daily temperature
+ * cycle, wakes at the longest interval and keeps the cached forecast up
+ * to the longest age. Scores in between are interpolated. Wakes that
+ * would fall in a quiet window (e.g., the night) are moved to its end.
+ *
+ * Times are passed in and nothing is kept between wakes, so a simulated
+ * clock and forecast history can drive the planner on the host.
+ */
+
+#define CADENCE_TEMPERATURE_POINTS 1  // Per degree of hour-to-hour change
+#define CADENCE_POP_POINTS 1          // Per 10 points of hour-to-hour change
+#define CADENCE_ICON_POINTS 3         // Per weather icon transition
+
+/**
+ * Quiet window in local time; wraps past midnight when start > end
+ */
+struct QuietWindow {
+  uint16_t startMinute;               // Minute of the day the window starts
+  uint16_t endMinute;                 // Minute of the day it ends
+};
+
+struct CadenceConfig {
+  uint32_t minSeconds;                // Wake interval of a volatile forecast
+  uint32_t maxSeconds;                // Wake interval of a stable forecast
+  uint32_t minAgeSeconds;             // Forecast age that triggers a fetch when volatile
+  uint32_t maxAgeSeconds;             // Forecast age that triggers a fetch when stable
+  uint8_t horizonHours;               // Hours of the series the display covers
+  uint16_t stableScore;               // Score at or below which the series counts as stable
+  uint16_t volatileScore;             // Score at or above which it counts as fully volatile
+  const QuietWindow* quiet;           // Quiet windows, may be NULL
+  uint8_t quietCount;
+  int32_t utcOffsetSeconds;           // Offset of local time from UTC
+};
+
+struct CadencePlan {
+  uint16_t score;                     // Volatility of the series over the horizon
+  uint32_t intervalSeconds;           // Until the next wake, before quiet windows
+  uint32_t maxAgeSeconds;             // Oldest cached forecast to display without fetching
+};
+
+uint16_t Cadence_Volatility(const ForecastCache* cache, int32_t now, uint8_t horizonHours);
+void Cadence_Plan(const CadenceConfig* config, const ForecastCache* cache, int32_t now, CadencePlan* plan);
+uint32_t Cadence_SkipQuiet(const CadenceConfig* config, int32_t now, uint32_t intervalSeconds);
+
+#endif
@@ -0,0 +1,181 @@
+#include "ClockGovernor.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_idf_version.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+#else
+#include <chrono>
+#include <mutex>
+#endif
+
+static const ClockPolicy* activePolicy = NULL;
+static int highHolds;                           // CLOCK_HIGH phases running, over all tasks
+static int64_t levelSinceUs;                    // Start of the current level
+static uint32_t levelUs[CLOCK_LEVEL_COUNT];     // Time at each level before it
+
+#ifdef ARDUINO
+static SemaphoreHandle_t governorMutex = NULL;
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t highLock = NULL;
+#endif
+#else
+static std::mutex governorMutex;
+#endif
+
+static int64_t ClockGovernor_Micros() {
+#ifdef ARDUINO
+  return esp_timer_get_time();
+#else
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static void ClockGovernor_Lock() {
+#ifdef ARDUINO
+  xSemaphoreTake(governorMutex, portMAX_DELAY);
+#else
+  governorMutex.lock();
+#endif
+}
+
+static void ClockGovernor_Unlock() {
+#ifdef ARDUINO
+  xSemaphoreGive(governorMutex);
+#else
+  governorMutex.unlock();
+#endif
+}
+
+/**
+ * Switches the clock to a level and closes the time of the previous one
+ * Called with the mutex held.
+ */
+static void ClockGovernor_Switch(ClockLevel level) {
+  int64_t now = ClockGovernor_Micros();
+  levelUs[level == CLOCK_HIGH ? CLOCK_LOW : CLOCK_HIGH] += (uint32_t)(now - levelSinceUs);
+  levelSinceUs = now;
+
+#ifdef ARDUINO
+#if CONFIG_PM_ENABLE
+  if (level == CLOCK_HIGH) {
+    esp_pm_lock_acquire(highLock);
+  } else {
+    esp_pm_lock_release(highLock);
+  }
+#else
+  setCpuFrequencyMhz(ClockGovernor_LevelMhz(level));
+#endif
+#endif
+}
+
+/**
+ * Applies a policy, starting at the low clock
+ *
+ * @param policy Policy, kept by reference
+ * @return false if the clocks could not be configured; phases then run
+ *         at the boot clock and no time is recorded
+ */
+bool ClockGovernor_Init(const ClockPolicy* policy) {
+#ifdef ARDUINO
+  if (governorMutex == NULL) {
+    governorMutex = xSemaphoreCreateMutex();
+    if (governorMutex == NULL) {
+      return false;
+    }
+  }
+#if CONFIG_PM_ENABLE
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t config;
+#else
+  esp_pm_config_esp32s3_t config;
+#endif
+  config.max_freq_mhz = policy->highMhz;
+  config.min_freq_mhz = policy->lowMhz;
+  config.light_sleep_enable = policy->lightSleep;
+  if (esp_pm_configure(&config) != ESP_OK) {
+    return false;
+  }
+  if (highLock == NULL && esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "clock-high", &highLock) != ESP_OK) {
+    return false;
+  }
+#else
+  if (!setCpuFrequencyMhz(policy->lowMhz)) {
+    return false;
+  }
+#endif
+#endif
+
+  activePolicy = policy;
+  highHolds = 0;
+  levelSinceUs = ClockGovernor_Micros();
+  memset(levelUs, 0, sizeof(levelUs));
+  return true;
+}
+
+/**
+ * Marks the start of a phase, raising the clock if the policy says so
+ */
+void ClockGovernor_Enter(WakePhase phase) {
+  if (activePolicy == NULL || activePolicy->phaseLevel[phase] != CLOCK_HIGH) {
+    return;
+  }
+  ClockGovernor_Lock();
+  if (highHolds++ == 0) {
+    ClockGovernor_Switch(CLOCK_HIGH);
+  }
+  ClockGovernor_Unlock();
+}
+
+/**
+ * Marks the end of a phase started with ClockGovernor_Enter
+ * The clock drops once no CLOCK_HIGH phase is left running.
+ */
+void ClockGovernor_Leave(WakePhase phase) {
+  if (activePolicy == NULL || activePolicy->phaseLevel[phase] != CLOCK_HIGH) {
+    return;
+  }
+  ClockGovernor_Lock();
+  if (highHolds > 0 && --highHolds == 0) {
+    ClockGovernor_Switch(CLOCK_LOW);
+  }
+  ClockGovernor_Unlock();
+}
+
+/**
+ * Clock of a level
+ *
+ * @return Frequency in MHz, 0 before ClockGovernor_Init
+ */
+uint16_t ClockGovernor_LevelMhz(ClockLevel level) {
+  if (activePolicy == NULL) {
+    return 0;
+  }
+  return level == CLOCK_HIGH ? activePolicy->highMhz : activePolicy->lowMhz;
+}
+
+/**
+ * Time spent at a level since ClockGovernor_Init, including light sleep
+ * at the low clock
+ *
+ * @return Time in microseconds
+ */
+uint32_t ClockGovernor_LevelUs(ClockLevel level) {
+  if (activePolicy == NULL) {
+    return 0;
+  }
+  ClockGovernor_Lock();
+  uint32_t us = levelUs[level];
+  if ((highHolds > 0) == (level == CLOCK_HIGH)) {
+    us += (uint32_t)(ClockGovernor_Micros() - levelSinceUs);
+  }
+  ClockGovernor_Unlock();
+  return us;
+}
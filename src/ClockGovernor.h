@@ -0,0 +1,45 @@
+#ifndef _CLOCK_GOVERNOR_H_
+#define _CLOCK_GOVERNOR_H_
+
+#include <stdint.h>
+#include "WakeProfile.h"
+
+/**
+ * CPU clock chosen by the phase of the wake
+ *
+ * A ClockPolicy gives each WakePhase a clock level. While any phase with
+ * CLOCK_HIGH runs, on any task, the CPU is held at the high clock;
+ * otherwise it drops to the low clock and, when idle, to automatic light
+ * sleep. Phases are marked with WAKE_PHASE_BEGIN/END, which also time
+ * them for WakeProfile.
+ *
+ * On the device the high clock is an ESP power-management lock when the
+ * SDK has CONFIG_PM_ENABLE; light sleep also needs tickless idle
+ * (CONFIG_FREERTOS_USE_TICKLESS_IDLE). Without CONFIG_PM_ENABLE the clock
+ * is switched with setCpuFrequencyMhz(), without light sleep. On the host nothing is switched, but the time at each
+ * level is still recorded.
+ */
+
+enum ClockLevel {
+  CLOCK_LOW,    // I/O waits: radio, network, panel BUSY
+  CLOCK_HIGH,   // Compute and bus bursts
+  CLOCK_LEVEL_COUNT
+};
+
+struct ClockPolicy {
+  uint16_t highMhz;                       // Clock while a CLOCK_HIGH phase runs
+  uint16_t lowMhz;                        // Clock otherwise, at least 80 with Wi-Fi on
+  bool lightSleep;                        // Light sleep when idle at lowMhz
+  uint8_t phaseLevel[WAKE_PHASE_COUNT];   // ClockLevel of each phase
+};
+
+#define WAKE_PHASE_BEGIN(phase) do { WAKE_PROFILE_BEGIN(phase); ClockGovernor_Enter(phase); } while (0)
+#define WAKE_PHASE_END(phase) do { ClockGovernor_Leave(phase); WAKE_PROFILE_END(phase); } while (0)
+
+bool ClockGovernor_Init(const ClockPolicy* policy);
+void ClockGovernor_Enter(WakePhase phase);
+void ClockGovernor_Leave(WakePhase phase);
+uint16_t ClockGovernor_LevelMhz(ClockLevel level);
+uint32_t ClockGovernor_LevelUs(ClockLevel level);
+
+#endif
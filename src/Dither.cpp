@@ -0,0 +1,98 @@
+#include "Dither.h"
+#include "EPD.h"
+#include <string.h>
+
+// 8x8 Bayer matrix, values 0..63
+static const uint8_t BAYER_8X8[8][8] = {
+  { 0, 32,  8, 40,  2, 34, 10, 42},
+  {48, 16, 56, 24, 50, 18, 58, 26},
+  {12, 44,  4, 36, 14, 46,  6, 38},
+  {60, 28, 52, 20, 62, 30, 54, 22},
+  { 3, 35, 11, 43,  1, 33,  9, 41},
+  {51, 19, 59, 27, 49, 17, 57, 25},
+  {15, 47,  7, 39, 13, 45,  5, 37},
+  {63, 31, 55, 23, 61, 29, 53, 21}
+};
+
+/**
+ * Starts dithering a new image
+ *
+ * @param dither State to initialize
+ * @param mode Dithering algorithm
+ * @param x Image x coordinate
+ * @param y Image y coordinate
+ * @param width Row width in pixels
+ * @return false if the width is not supported
+ */
+bool Dither_Begin(DITHER *dither, DITHER_MODE mode, uint16_t x, uint16_t y, uint16_t width)
+{
+  if (width == 0 || width > DITHER_MAX_WIDTH) {
+    return false;
+  }
+
+  dither->mode = mode;
+  dither->x = x;
+  dither->y = y;
+  dither->width = width;
+  dither->row = 0;
+  memset(dither->error, 0, sizeof(dither->error));
+  return true;
+}
+
+/**
+ * Dithers one grayscale row and draws it below the previous one
+ *
+ * @param dither State from Dither_Begin
+ * @param gray Row of width 8-bit samples, 0 = black and 255 = white
+ */
+void Dither_WriteRow(DITHER *dither, const uint8_t *gray)
+{
+  uint8_t bits[DITHER_MAX_WIDTH / 8];
+  uint16_t width = dither->width;
+
+  memset(bits, 0, (width + 7) / 8);
+
+  if (dither->mode == DITHER_ORDERED) {
+    const uint8_t *thresholds = BAYER_8X8[dither->row % 8];
+    for (uint16_t i = 0; i < width; i++) {
+      // Scale 0..63 to thresholds 2..254
+      if (gray[i] < thresholds[i % 8] * 4 + 2) {
+        bits[i / 8] |= 0x80 >> (i % 8);  // Dark pixel
+      }
+    }
+  } else {
+    int16_t *current = dither->error[dither->row % 2];
+    int16_t *next = dither->error[(dither->row + 1) % 2];
+    bool reverse = dither->row % 2;
+    int step = reverse ? -1 : 1;
+
+    for (uint16_t n = 0; n < width; n++) {
+      uint16_t i = reverse ? width - 1 - n : n;
+      int16_t *here = &current[i + 1];
+      int16_t *below = &next[i + 1];
+
+      int16_t value = gray[i] + *here;
+      int16_t error;
+      if (value < 128) {
+        bits[i / 8] |= 0x80 >> (i % 8);  // Dark pixel
+        error = value;
+      } else {
+        error = value - 255;
+      }
+      *here = 0;
+
+      // Floyd-Steinberg weights 7/16, 3/16, 5/16 and 1/16; the remainder
+      // of the integer division goes to the last term so no error is lost
+      int16_t e7 = error * 7 / 16;
+      int16_t e3 = error * 3 / 16;
+      int16_t e5 = error * 5 / 16;
+      here[step] += e7;
+      below[-step] += e3;
+      below[0] += e5;
+      below[step] += error - e7 - e3 - e5;
+    }
+  }
+
+  Paint_BlitRow(dither->x, dither->y + dither->row, bits, width, WHITE);
+  dither->row++;
+}
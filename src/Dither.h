@@ -0,0 +1,36 @@
+#ifndef _DITHER_H_
+#define _DITHER_H_
+
+#include <stdint.h>
+
+/**
+ * Grayscale to 1-bpp dithering
+ *
+ * Takes 8-bit grayscale rows (0 = black, 255 = white) one at a time and
+ * draws them into the current Paint image through Paint_BlitRow.
+ * Only integer arithmetic is used, and the state holds at most two rows
+ * of error terms, so memory stays proportional to the image width.
+ */
+
+#define DITHER_MAX_WIDTH 800  // Widest supported row in pixels
+
+typedef enum
+{
+  DITHER_ORDERED,          // 8x8 Bayer matrix, no state between rows
+  DITHER_FLOYD_STEINBERG   // Error diffusion with serpentine scanning
+} DITHER_MODE;
+
+typedef struct
+{
+  DITHER_MODE mode;
+  uint16_t x;              // Image x coordinate
+  uint16_t y;              // Image y coordinate
+  uint16_t width;          // Row width in pixels
+  uint16_t row;            // Index of the next row
+  int16_t error[2][DITHER_MAX_WIDTH + 2];  // Current and next row errors, one pixel of margin on each side
+} DITHER;
+
+bool Dither_Begin(DITHER *dither, DITHER_MODE mode, uint16_t x, uint16_t y, uint16_t width);
+void Dither_WriteRow(DITHER *dither, const uint8_t *gray);
+
+#endif
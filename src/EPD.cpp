@@ -1,10 +1,11 @@
 #include "EPD.h"
 #include "EPDfont.h"
 #include "ChivoMonoFont.h"
+#include "FrameOps.h"
 #include "string.h"
 #include <map>
 
-PAINT Paint;
+thread_local PAINT Paint;
 
 /*******************************************************************
     Function Description: Create Image Cache Array
@@ -25,6 +26,8 @@ void Paint_NewImage(uint8_t *image, uint16_t Width, uint16_t Height, uint16_t Ro
     Paint.heightMemory = Height;
     Paint.widthByte = (Width % 8 == 0) ? (Width / 8) : (Width / 8 + 1);
     Paint.heightByte = Height;
+    Paint.clipStart = 0;
+    Paint.clipEnd = Paint.widthByte;
     Paint.rotate = Rotate;
     if (Rotate == 0 || Rotate == 180)
     {
@@ -42,19 +45,21 @@ void Paint_NewImage(uint8_t *image, uint16_t Width, uint16_t Height, uint16_t Ro
     Function Description: Clear Buffer
     Interface Description:
                Color  Pixel color parameter
+    Description: Only the clip window is cleared
     Return Value: None
 *******************************************************************/
 void Paint_Clear(uint8_t Color)
 {
-    uint16_t X, Y;
-    uint32_t Addr;
+    uint16_t Y;
+    uint16_t Bytes = Paint.clipEnd - Paint.clipStart;
+    if (Bytes == Paint.widthByte)
+    {
+        FrameOps_Fill(Paint.Image, Color, (uint32_t)Paint.widthByte * Paint.heightByte); // Whole image in one pass
+        return;
+    }
     for (Y = 0; Y < Paint.heightByte; Y++)
     {
-        for (X = 0; X < Paint.widthByte; X++)
-        {
-            Addr = X + Y * Paint.widthByte; // 8 pixel =  1 byte
-            Paint.Image[Addr] = Color;
-        }
+        FrameOps_Fill(Paint.Image + Paint.clipStart + Y * Paint.widthByte, Color, Bytes); // 8 pixel =  1 byte
     }
 }
 
@@ -109,6 +114,10 @@ void Paint_SetPixel(uint16_t Xpoint, uint16_t Ypoint, uint16_t Color)
     default:
         return;
     }
+    if (X / 8 < Paint.clipStart || X / 8 >= Paint.clipEnd || Y >= Paint.heightMemory)
+    {
+        return; // Outside the clip window or below the buffer
+    }
     Addr = X / 8 + Y * Paint.widthByte;
     Rdata = Paint.Image[Addr];
     if (Color == BLACK)
@@ -263,6 +272,34 @@ void EPD_DrawCircle(uint16_t X_Center, uint16_t Y_Center, uint16_t Radius, uint1
     }
 }
 
+// Mapping of font size to font data and bytes per character
+struct FontInfo {
+    const unsigned char* data;
+    uint16_t bytes_per_char;
+    uint16_t glyph_count;
+};
+static std::map<uint16_t, FontInfo> font_map = {
+    {24, {(const unsigned char*)ascii_2412, 36, sizeof(ascii_2412) / sizeof(ascii_2412[0])}},                 // ascii_2412[][36]
+    {36, {(const unsigned char*)chivo_mono_3618, 96, sizeof(chivo_mono_3618) / sizeof(chivo_mono_3618[0])}}, // chivo_mono_3618[][96]
+    {44, {(const unsigned char*)chivo_mono_4422, 132, sizeof(chivo_mono_4422) / sizeof(chivo_mono_4422[0])}} // chivo_mono_4422[][132]
+};
+
+/*******************************************************************
+    Function Description: Replace the Font of a Given Size
+    Interface Description:
+              size1           Character font size
+              data            Glyph data starting at ' ', same format as ascii_2412
+              bytes_per_char  Bytes per glyph
+              glyph_count     Number of glyphs
+    Description: The data is used in place and must stay valid,
+                 e.g. a font in a memory-mapped asset pack
+    Return Value: None
+*******************************************************************/
+void EPD_SetFont(uint16_t size1, const unsigned char *data, uint16_t bytes_per_char, uint16_t glyph_count)
+{
+    font_map[size1] = {data, bytes_per_char, glyph_count};
+}
+
 /*******************************************************************
     Function Description: Display Single Character
     Interface Description:
@@ -279,17 +316,6 @@ void EPD_ShowChar(uint16_t x, uint16_t y, uint16_t chr, uint16_t size1, uint16_t
     uint16_t x0, y0;
     x0 = x, y0 = y;
     
-    // Mapping of font size to font data and bytes per character
-    struct FontInfo {
-        const unsigned char* data;
-        uint16_t bytes_per_char;
-    };
-    static std::map<uint16_t, FontInfo> font_map = {
-        {24, {(const unsigned char*)ascii_2412, 36}},      // ascii_2412[][36]
-        {36, {(const unsigned char*)chivo_mono_3618, 96}}, // chivo_mono_3618[][96]
-        {44, {(const unsigned char*)chivo_mono_4422, 132}} // chivo_mono_4422[][132]
-    };
-    
     chr1 = chr - ' ';                                               // Calculate the offset value
     
     // Get corresponding font data from font map
@@ -298,6 +324,10 @@ void EPD_ShowChar(uint16_t x, uint16_t y, uint16_t chr, uint16_t size1, uint16_t
     {
         return; // Unsupported font size
     }
+    if (chr1 >= font_it->second.glyph_count)
+    {
+        return; // Character not in font
+    }
     
     const unsigned char* font_data = font_it->second.data;
     uint16_t bytes_per_char = font_it->second.bytes_per_char;
@@ -359,31 +389,150 @@ void EPD_ShowString(uint16_t x, uint16_t y, const char *chr, uint16_t size1, uin
 *******************************************************************/
 void EPD_ShowPicture(uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, const uint8_t BMP[], uint16_t Color)
 {
-    uint16_t j = 0, t;
-    uint16_t i, temp, x0, TypefaceNum = sizey * (sizex / 8 + ((sizex % 8) ? 1 : 0));
-    x0 = x;
-    for (i = 0; i < TypefaceNum; i++)
+    uint16_t i;
+    uint16_t rowBytes = sizex / 8 + ((sizex % 8) ? 1 : 0);
+    for (i = 0; i < sizey; i++)
     {
-        temp = BMP[j];
-        for (t = 0; t < 8; t++)
+        Paint_BlitRow(x, y + i, BMP + i * rowBytes, sizex, Color);
+    }
+}
+
+/*******************************************************************
+    Function Description: Copy Bits Into One Buffer Row
+    Interface Description:
+              y       Row in the image buffer
+              dstX    First destination column in buffer memory
+              src     Source bits, MSB first
+              srcBit  First source bit
+              n       Number of bits to copy
+              invert  0xFF to invert the source bits, 0x00 to keep them
+    Return Value: None
+*******************************************************************/
+static void Paint_BlitBits(uint16_t y, uint16_t dstX, const uint8_t *src, uint16_t srcBit, uint16_t n, uint8_t invert)
+{
+    uint8_t *dst;
+    uint16_t srcBytes;
+    uint16_t window;
+    uint8_t count, bitOff, bits, mask;
+    uint16_t clipLeft = Paint.clipStart * 8;
+    uint16_t clipRight = Paint.clipEnd * 8 < Paint.widthMemory ? Paint.clipEnd * 8 : Paint.widthMemory;
+
+    if (dstX < clipLeft)
+    {
+        if (n <= clipLeft - dstX)
         {
-            if (temp & 0x80)
-            {
-                Paint_SetPixel(x, y, !Color);
-            }
-            else
-            {
-                Paint_SetPixel(x, y, Color);
-            }
-            x++;
-            temp <<= 1;
+            return;
         }
-        if ((x - x0) == sizex)
+        srcBit += clipLeft - dstX; // Skip the bits left of the clip window
+        n -= clipLeft - dstX;
+        dstX = clipLeft;
+    }
+    if (dstX >= clipRight)
+    {
+        return;
+    }
+    if (n > clipRight - dstX)
+    {
+        n = clipRight - dstX; // Clip at the right edge of the clip window
+    }
+
+    dst = Paint.Image + y * Paint.widthByte;
+    srcBytes = (srcBit + n + 7) / 8;
+    while (n > 0)
+    {
+        bitOff = dstX % 8;
+        count = 8 - bitOff;
+        if (count > n)
         {
-            x = x0;
-            y++;
+            count = n;
+        }
+
+        // Fetch 8 source bits starting at srcBit
+        window = src[srcBit / 8] << 8;
+        if (srcBit / 8 + 1 < srcBytes)
+        {
+            window |= src[srcBit / 8 + 1];
+        }
+        bits = (uint8_t)((window << (srcBit % 8)) >> 8) ^ invert;
+
+        mask = (uint8_t)(0xFF << (8 - count)) >> bitOff;
+        dst[dstX / 8] = (dst[dstX / 8] & ~mask) | ((bits >> bitOff) & mask);
+
+        dstX += count;
+        srcBit += count;
+        n -= count;
+    }
+}
+
+/*******************************************************************
+    Function Description: Display One Row of a Picture
+    Interface Description:
+              x      Row x coordinate parameter
+              y      Row y coordinate parameter
+              row    Row bitmap, same format as one row of EPD_ShowPicture
+              sizex  Row width in pixels
+              Color  Pixel color parameter
+    Description: Copies whole bytes into the buffer instead of setting
+                 pixels one by one. Set bits are drawn in !Color and
+                 clear bits in Color, as in EPD_ShowPicture.
+    Return Value: None
+*******************************************************************/
+void Paint_BlitRow(uint16_t x, uint16_t y, const uint8_t *row, uint16_t sizex, uint16_t Color)
+{
+    uint16_t i, left;
+    uint8_t invert = (Color != BLACK) ? 0xFF : 0x00;
+
+    if (Paint.rotate != 0)
+    {
+        for (i = 0; i < sizex; i++)
+        {
+            Paint_SetPixel(x + i, y, (row[i / 8] & (0x80 >> (i % 8))) ? !Color : Color);
         }
-        j++;
-        // delayMicroseconds(10); // delay in microseconds
+        return;
+    }
+    if (y >= Paint.heightMemory)
+    {
+        return;
+    }
+
+    // Skip the 8 columns between the two driver ICs, as Paint_SetPixel does
+    left = 0;
+    if (x < 396)
+    {
+        left = (sizex < 396 - x) ? sizex : 396 - x;
+        Paint_BlitBits(y, x, row, 0, left, invert);
+        x = 396;
+    }
+    if (left < sizex)
+    {
+        Paint_BlitBits(y, x + 8, row, left, sizex - left, invert);
+    }
+}
+
+/*******************************************************************
+    Function Description: Display Compressed Picture
+    Interface Description:
+              x      Picture x coordinate parameter
+              y      Picture y coordinate parameter
+              asset  Compressed picture (see AssetCodec.h)
+              Color  Pixel color parameter
+    Description: Rows are expanded one at a time into a row buffer and
+                 copied straight into the image buffer.
+    Return Value: None
+*******************************************************************/
+void EPD_ShowCompressedPicture(uint16_t x, uint16_t y, const COMPRESSED_ASSET *asset, uint16_t Color)
+{
+    uint8_t row[EPD_W / 8];
+    ASSET_DECODER dec;
+
+    if (Asset_RowBytes(asset) > sizeof(row))
+    {
+        return; // Wider than the display
+    }
+
+    Asset_DecoderInit(&dec, asset, 0);
+    while (Asset_DecodeRow(&dec, row))
+    {
+        Paint_BlitRow(x, y++, row, asset->width, Color);
     }
 }
@@ -2,6 +2,7 @@
 #define _EPD_GUI_H_
 
 #include "EPD_Init.h"
+#include "AssetCodec.h"
 
 typedef struct
 {
@@ -14,9 +15,12 @@ typedef struct
     uint16_t rotate;
     uint16_t widthByte;
     uint16_t heightByte;
+    uint16_t clipStart; // First byte column that may be drawn
+    uint16_t clipEnd;   // Byte column after the last one that may be drawn
 
 } PAINT;
-extern PAINT Paint;
+// Each task draws into its own Paint image, so tiles can be drawn in parallel (see TileRender.h)
+extern thread_local PAINT Paint;
 
 // Define the orientation of the E-Paper display
 /*******************
@@ -33,10 +37,13 @@ void Paint_Clear(uint8_t Color);
 void EPD_DrawLine(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t Yend, uint16_t Color);
 void EPD_DrawRectangle(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t Yend, uint16_t Color, uint8_t mode);
 void EPD_DrawCircle(uint16_t X_Center, uint16_t Y_Center, uint16_t Radius, uint16_t Color, uint8_t mode);
+void EPD_SetFont(uint16_t size1, const unsigned char *data, uint16_t bytes_per_char, uint16_t glyph_count);
 void EPD_ShowChar(uint16_t x, uint16_t y, uint16_t chr, uint16_t size1, uint16_t color);
 void EPD_ShowString(uint16_t x, uint16_t y, const char *chr, uint16_t size1, uint16_t color);
 void EPD_ShowNum(uint16_t x, uint16_t y, uint32_t num, uint16_t len, uint16_t size1, uint16_t color);
 void EPD_ShowPicture(uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, const uint8_t BMP[], uint16_t Color);
+void EPD_ShowCompressedPicture(uint16_t x, uint16_t y, const COMPRESSED_ASSET *asset, uint16_t Color);
+void Paint_BlitRow(uint16_t x, uint16_t y, const uint8_t *row, uint16_t sizex, uint16_t Color);
 void EPD_ClearWindows(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye, uint16_t color);
 void EPD_ShowFloatNum1(uint16_t x, uint16_t y, float num, uint8_t len, uint8_t pre, uint8_t sizey, uint8_t color);
 void EPD_ShowWatch(uint16_t x, uint16_t y, float num, uint8_t len, uint8_t pre, uint8_t sizey, uint8_t color);
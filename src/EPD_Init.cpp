@@ -1,20 +1,26 @@
 #include "EPD_Init.h"
 #include "EPD.h"
+#include "FrameOps.h"
+#include "ClockGovernor.h"
 
 /*******************************************************************
     Function Description: Busy Check Function
     Input Parameters: None
-    Description: Busy state is 1
+    Description: Busy state is 1. Polls every millisecond, leaving
+                 the CPU idle (and free to light sleep) in between
 *******************************************************************/
 void EPD_READBUSY(void)
 {
+  WAKE_PHASE_BEGIN(WAKE_PHASE_BUSY);
   while (1)
   {
     if (EPD_ReadBUSY == 0)
     {
       break;
     }
+    delay(1);
   }
+  WAKE_PHASE_END(WAKE_PHASE_BUSY);
 }
 
 /*******************************************************************
@@ -74,7 +80,8 @@ void EPD_FastUpdate(void)
 /*******************************************************************
     Function Description: Sleep Function
     Input Parameters: None
-    Description: Screen enters low power mode
+    Description: Screen enters low power mode once any refresh in
+                 progress has finished, as signalled by BUSY
 *******************************************************************/
 void EPD_DeepSleep(void)
 {
@@ -82,9 +89,9 @@ void EPD_DeepSleep(void)
   //    EPD_WR_DATA8(0x01);
   //    EPD_READBUSY();
 
+  EPD_READBUSY();
   EPD_WR_REG(0x10);
   EPD_WR_DATA8(0x01);
-  delay(5);
 }
 
 void EPD_Init(void)
@@ -173,6 +180,7 @@ void EPD_SetRAMSA(void)
 void EPD_Clear_R26A6H(void)
 {
   uint16_t i, j;
+  WAKE_PHASE_BEGIN(WAKE_PHASE_TRANSFER);
   EPD_SetRAMMA();
   EPD_WR_REG(0x26);
   for (i = 0; i < Gate_BITS; i++)
@@ -191,11 +199,13 @@ void EPD_Clear_R26A6H(void)
       EPD_WR_DATA8(0xFF);
     }
   }
+  WAKE_PHASE_END(WAKE_PHASE_TRANSFER);
 }
 
 void EPD_Display_Clear(void)
 {
   uint16_t i, j;
+  WAKE_PHASE_BEGIN(WAKE_PHASE_TRANSFER);
   EPD_SetRAMMP();
   EPD_SetRAMMA();
   EPD_WR_REG(0x24);
@@ -234,6 +244,7 @@ void EPD_Display_Clear(void)
       EPD_WR_DATA8(0x00);
     }
   }
+  WAKE_PHASE_END(WAKE_PHASE_TRANSFER);
 }
 
 void EPD_Display(const uint8_t *ImageBW)
@@ -242,6 +253,7 @@ void EPD_Display(const uint8_t *ImageBW)
   uint8_t tempOriginal;
   uint32_t tempcol = 0;
   uint32_t templine = 0;
+  WAKE_PHASE_BEGIN(WAKE_PHASE_TRANSFER);
   EPD_SetRAMMP();
   EPD_SetRAMMA();
   EPD_WR_REG(0x24);
@@ -270,15 +282,78 @@ void EPD_Display(const uint8_t *ImageBW)
     }
     EPD_WR_DATA8(tempOriginal);
   }
+  WAKE_PHASE_END(WAKE_PHASE_TRANSFER);
+}
+
+/*******************************************************************
+    Function Description: Write Previous Image Function
+    Input Parameters: ImageBW  Image currently shown on the panel
+    Description: Writes the image to the old-data RAM (0x26/0xA6),
+                 so a partial update only drives the pixels that
+                 differ from the image written by EPD_Display
+*******************************************************************/
+void EPD_DisplayOld(const uint8_t *ImageBW)
+{
+  uint32_t i;
+  uint32_t tempcol = 0;
+  uint32_t templine = 0;
+  WAKE_PHASE_BEGIN(WAKE_PHASE_TRANSFER);
+  EPD_SetRAMMP();
+  EPD_SetRAMMA();
+  EPD_WR_REG(0x26);
+  for (i = 0; i < ALLSCREEN_BYTES; i++)
+  {
+    EPD_WR_DATA8(*(ImageBW + templine * Source_BYTES * 2 + tempcol));
+    templine++;
+    if (templine >= Gate_BITS)
+    {
+      tempcol++;
+      templine = 0;
+    }
+  }
+  EPD_SetRAMSP();
+  EPD_SetRAMSA();
+  EPD_WR_REG(0xA6);
+  for (i = 0; i < ALLSCREEN_BYTES; i++)
+  {
+    EPD_WR_DATA8(*(ImageBW + templine * Source_BYTES * 2 + tempcol));
+    templine++;
+    if (templine >= Gate_BITS)
+    {
+      tempcol++;
+      templine = 0;
+    }
+  }
+  WAKE_PHASE_END(WAKE_PHASE_TRANSFER);
+}
+
+/*******************************************************************
+    Function Description: Write Inverted Columns Function
+    Input Parameters: datas        Image in EPD_Display layout
+                      firstColumn  First byte column to write
+    Description: Writes Source_BYTES byte columns, each from the top
+                 row down, with every bit inverted; each column is
+                 gathered and inverted in one pass before it is sent
+*******************************************************************/
+static void EPD_WriteInvertedColumns(const unsigned char *datas, uint16_t firstColumn)
+{
+  alignas(FRAMEOPS_ALIGN) uint8_t column[Gate_BITS];
+  uint16_t i, j;
+  for (i = 0; i < Source_BYTES; i++)
+  {
+    FrameOps_Transpose(column, datas + firstColumn + i, Gate_BITS, 1, Source_BYTES * 2);
+    FrameOps_Invert(column, column, Gate_BITS);
+    for (j = 0; j < Gate_BITS; j++)
+    {
+      EPD_WR_DATA8(column[j]);
+    }
+  }
 }
 
 // Horizontal scanning, from right to left, from bottom to top
 void EPD_WhiteScreen_ALL_Fast(const unsigned char *datas)
 {
   unsigned int i;
-  unsigned char tempOriginal;
-  unsigned int tempcol = 0;
-  unsigned int templine = 0;
 
   EPD_WR_REG(0x11);
   EPD_WR_DATA8(0x05);
@@ -301,17 +376,7 @@ void EPD_WhiteScreen_ALL_Fast(const unsigned char *datas)
 
   EPD_READBUSY();
   EPD_WR_REG(0x24); // write RAM for black(0)/white (1)
-  for (i = 0; i < Source_BYTES * Gate_BITS; i++)
-  {
-    tempOriginal = *(datas + templine * Source_BYTES * 2 + tempcol);
-    templine++;
-    if (templine >= Gate_BITS)
-    {
-      tempcol++;
-      templine = 0;
-    }
-    EPD_WR_DATA8(~tempOriginal);
-  }
+  EPD_WriteInvertedColumns(datas, 0);
 
   EPD_WR_REG(0x26); // write RAM for black(0)/white (1)
   for (i = 0; i < Source_BYTES * Gate_BITS; i++)
@@ -340,20 +405,8 @@ void EPD_WhiteScreen_ALL_Fast(const unsigned char *datas)
 
   EPD_READBUSY();
 
-  tempcol = tempcol - 1; // Byte dislocation processing
-  templine = 0;
   EPD_WR_REG(0xa4); // write RAM for black(0)/white (1)
-  for (i = 0; i < Source_BYTES * Gate_BITS; i++)
-  {
-    tempOriginal = *(datas + templine * Source_BYTES * 2 + tempcol);
-    templine++;
-    if (templine >= Gate_BITS)
-    {
-      tempcol++;
-      templine = 0;
-    }
-    EPD_WR_DATA8(~tempOriginal);
-  }
+  EPD_WriteInvertedColumns(datas, Source_BYTES - 1); // Byte dislocation processing
 
   EPD_WR_REG(0xa6); // write RAM for black(0)/white (1)
   for (i = 0; i < Source_BYTES * Gate_BITS; i++)
@@ -0,0 +1,104 @@
+#include "Forecast.h"
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+
+/**
+ * Formats a forecast time as local "H:MM", right-aligned to 5 characters
+ *
+ * @param buffer Output buffer
+ * @param size Size of the output buffer
+ * @param unixTime Unix timestamp (UTC)
+ * @param utcOffsetSeconds Offset of the local time from UTC
+ * @return Number of characters written
+ */
+size_t Forecast_FormatTime(char* buffer, size_t size, int32_t unixTime, int32_t utcOffsetSeconds) {
+  time_t localTime = (time_t)unixTime + utcOffsetSeconds;
+  struct tm timeinfo;
+  gmtime_r(&localTime, &timeinfo);
+  return strftime(buffer, size, "%k:%M", &timeinfo);
+}
+
+/**
+ * Rounds a temperature in 1/100 degrees to whole degrees, half away from zero
+ *
+ * @param temperature Temperature in 1/100 degrees
+ * @return Temperature in degrees
+ */
+int Forecast_RoundTemperature(int16_t temperature) {
+  return temperature >= 0 ? (temperature + 50) / 100 : -((-temperature + 50) / 100);
+}
+
+/**
+ * Formats a temperature as "%3d C"
+ *
+ * @param buffer Output buffer
+ * @param size Size of the output buffer
+ * @param temperature Temperature in 1/100 degrees
+ * @param unit Unit letter ('C' or 'F')
+ * @return Number of characters written
+ */
+size_t Forecast_FormatTemperature(char* buffer, size_t size, int16_t temperature, char unit) {
+  int length = snprintf(buffer, size, "%3d %c", Forecast_RoundTemperature(temperature), unit);
+  return length < 0 ? 0 : (size_t)length;
+}
+
+/**
+ * Formats a probability of precipitation as "%3d %"
+ *
+ * @param buffer Output buffer
+ * @param size Size of the output buffer
+ * @param pop Probability of precipitation (%)
+ * @return Number of characters written
+ */
+size_t Forecast_FormatPop(char* buffer, size_t size, uint8_t pop) {
+  int length = snprintf(buffer, size, "%3d %%", pop);
+  return length < 0 ? 0 : (size_t)length;
+}
+
+/**
+ * Formats everything a forecast column displays
+ *
+ * @param text Receives the column text
+ * @param info Forecast of the column; an empty slot if time is 0
+ * @param utcOffsetSeconds Offset of the local time from UTC
+ * @param unit Unit letter ('C' or 'F')
+ * @param showPop true to show the probability of precipitation
+ * @param lastUpdated Time of an out-of-date forecast (UTC), 0 if current
+ */
+void Forecast_FormatSlot(ForecastSlotText* text, const ForecastInfo* info, int32_t utcOffsetSeconds, char unit,
+                         bool showPop, int32_t lastUpdated) {
+  memset(text, 0, sizeof(*text));
+  text->iconNumber = ICON_UNKNOWN;
+
+  if (info->time != 0) {
+    size_t length = Forecast_FormatTime(text->time, sizeof(text->time) - 1, info->time, utcOffsetSeconds);
+    text->time[length] = ' ';
+    Forecast_FormatTemperature(text->temperature, sizeof(text->temperature), info->temperature, unit);
+    if (showPop) {
+      Forecast_FormatPop(text->pop, sizeof(text->pop), info->pop);
+    }
+    text->iconNumber = info->iconNumber;
+  }
+  if (lastUpdated != 0) {
+    Forecast_FormatTime(text->updated, sizeof(text->updated), lastUpdated, utcOffsetSeconds);
+  }
+}
+
+/**
+ * FNV-1a hash of a forecast column's text and icon
+ *
+ * Equal fingerprints mean the column draws the same pixels.
+ *
+ * @param text Column text
+ * @return Fingerprint
+ */
+uint32_t Forecast_Fingerprint(const ForecastSlotText* text) {
+  // The strings are zero-padded by Forecast_FormatSlot, so hashing the bytes is exact
+  const uint8_t* bytes = (const uint8_t*)text;
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < sizeof(*text); i++) {
+    hash = (hash ^ bytes[i]) * 16777619UL;
+  }
+  return hash;
+}
@@ -0,0 +1,129 @@
+#ifndef _FORECAST_H_
+#define _FORECAST_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Forecast data model
+ *
+ * Plain data and lookup tables only, with no heap allocation and no
+ * Arduino dependency, so the same code runs on the host.
+ */
+
+/**
+ * Weather icon enumeration
+ * Maps to indices in the Weather_Icons array in icons_rle.h
+ */
+enum WeatherIconNumber {
+  ICON_CLEAR_DAY = 0,
+  ICON_CLEAR_NIGHT = 1,
+  ICON_CLOUDS = 2,
+  ICON_RAIN = 3,
+  ICON_THUNDERSTORM = 4,
+  ICON_SNOW = 5,
+  ICON_MIST = 6,
+  ICON_COUNT,
+  ICON_UNKNOWN = 0xFF
+};
+
+/**
+ * Forecast information structure
+ * Stores weather forecast data for a specific time period
+ */
+struct ForecastInfo {
+  int32_t time;         // Unix timestamp (UTC), 0 if not set
+  int16_t temperature;  // Temperature in 1/100 degrees (C or F depending on TEMPERATURE_UNIT)
+  uint8_t pop;          // Probability of precipitation (%)
+  uint8_t iconNumber;   // Weather icon number
+};
+
+static_assert(sizeof(ForecastInfo) == 8, "ForecastInfo must stay packed");
+
+/**
+ * Text of one forecast column exactly as displayed
+ * Empty strings are not drawn.
+ */
+struct ForecastSlotText {
+  char time[8];         // "HH:MM "
+  char temperature[8];  // "%3d C"
+  char pop[8];          // "%3d %"
+  char updated[8];      // Time of an out-of-date forecast, "H:MM"
+  uint8_t iconNumber;   // Weather icon number, ICON_UNKNOWN if the slot is empty
+};
+
+/**
+ * Icon table indexed by the number of an OpenWeatherMap icon code ("NNd"/"NNn")
+ * Codes ending in "n" only differ for clear sky.
+ */
+constexpr uint8_t WEATHER_ICON_BY_CODE[51] = {
+  ICON_UNKNOWN, ICON_CLEAR_DAY, ICON_CLOUDS, ICON_CLOUDS, ICON_CLOUDS,          // 00-04
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_RAIN,            // 05-09
+  ICON_RAIN, ICON_THUNDERSTORM, ICON_UNKNOWN, ICON_SNOW, ICON_UNKNOWN,         // 10-14
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN,        // 15-19
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN,        // 20-24
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN,        // 25-29
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN,        // 30-34
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN,        // 35-39
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN,        // 40-44
+  ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN, ICON_UNKNOWN,        // 45-49
+  ICON_MIST                                                                    // 50
+};
+
+/**
+ * Icon table indexed by the group (hundreds digit) of an OpenWeatherMap condition id
+ */
+constexpr uint8_t WEATHER_ICON_BY_GROUP[9] = {
+  ICON_UNKNOWN,       // 0xx
+  ICON_UNKNOWN,       // 1xx
+  ICON_THUNDERSTORM,  // 2xx Thunderstorm
+  ICON_RAIN,          // 3xx Drizzle
+  ICON_UNKNOWN,       // 4xx
+  ICON_RAIN,          // 5xx Rain
+  ICON_SNOW,          // 6xx Snow
+  ICON_MIST,          // 7xx Atmosphere
+  ICON_CLOUDS         // 8xx Clouds (800 is handled separately)
+};
+
+/**
+ * Maps an OpenWeatherMap condition id to an icon number
+ *
+ * @param id Condition id (e.g., 500)
+ * @param night true for a night-time condition
+ * @return Icon number, or ICON_UNKNOWN
+ */
+constexpr uint8_t Forecast_IconFromConditionId(uint16_t id, bool night) {
+  return id == 800 ? (uint8_t)(night ? ICON_CLEAR_NIGHT : ICON_CLEAR_DAY) :
+         id == 511 ? (uint8_t)ICON_SNOW :  // Freezing rain uses the snow icon
+         id < 900 ? WEATHER_ICON_BY_GROUP[id / 100] :
+         (uint8_t)ICON_UNKNOWN;
+}
+
+/**
+ * Maps an OpenWeatherMap icon code to an icon number
+ *
+ * @param code Icon code (e.g., "01d"), may be NULL
+ * @return Icon number, or ICON_UNKNOWN
+ */
+constexpr uint8_t Forecast_IconFromCode(const char* code) {
+  return (code == nullptr ||
+          code[0] < '0' || code[0] > '5' || code[1] < '0' || code[1] > '9') ? (uint8_t)ICON_UNKNOWN :
+         ((code[0] - '0') * 10 + (code[1] - '0')) > 50 ? (uint8_t)ICON_UNKNOWN :
+         (code[0] == '0' && code[1] == '1' && code[2] == 'n') ? (uint8_t)ICON_CLEAR_NIGHT :
+         WEATHER_ICON_BY_CODE[(code[0] - '0') * 10 + (code[1] - '0')];
+}
+
+static_assert(Forecast_IconFromCode("01n") == ICON_CLEAR_NIGHT, "icon table");
+static_assert(Forecast_IconFromCode("10d") == ICON_RAIN, "icon table");
+static_assert(Forecast_IconFromConditionId(511, false) == ICON_SNOW, "condition table");
+static_assert(Forecast_IconFromConditionId(804, true) == ICON_CLOUDS, "condition table");
+
+size_t Forecast_FormatTime(char* buffer, size_t size, int32_t unixTime, int32_t utcOffsetSeconds);
+int Forecast_RoundTemperature(int16_t temperature);
+size_t Forecast_FormatTemperature(char* buffer, size_t size, int16_t temperature, char unit);
+size_t Forecast_FormatPop(char* buffer, size_t size, uint8_t pop);
+void Forecast_FormatSlot(ForecastSlotText* text, const ForecastInfo* info, int32_t utcOffsetSeconds, char unit,
+                         bool showPop, int32_t lastUpdated);
+uint32_t Forecast_Fingerprint(const ForecastSlotText* text);
+
+#endif
@@ -0,0 +1,157 @@
+#include "ForecastCache.h"
+#include <string.h>
+
+#define FORECAST_CACHE_MAGIC 0x46434331  // "FCC1"
+#define FORECAST_CACHE_ICON_MASK ((1 << FORECAST_CACHE_ICON_BITS) - 1)
+
+/**
+ * Converts 1/100 degrees to 1/10 degrees, truncating towards zero
+ *
+ * Truncation keeps Forecast_RoundTemperature of the cached value equal to
+ * that of the original: 2.45 is kept as 2.4 and shown as 2, where rounding
+ * to 2.5 first would show 3.
+ */
+static int ForecastCache_ToTenths(int16_t temperature) {
+  return temperature / 10;
+}
+
+/**
+ * Starts a new series, discarding the cached one
+ *
+ * @param cache Cache to fill
+ * @param current Current conditions of the response
+ */
+void ForecastCache_Begin(ForecastCache* cache, const ForecastInfo* current) {
+  memset(cache, 0, sizeof(*cache));
+  cache->current = *current;
+  cache->fetchedAt = current->time;
+  cache->magic = FORECAST_CACHE_MAGIC;
+}
+
+/**
+ * Appends the next hourly entry
+ *
+ * Deltas are taken from the reconstructed previous temperature, so
+ * quantisation errors do not accumulate along the series. Steps larger
+ * than the int8 range are clamped and caught up by the following hours.
+ *
+ * @param cache Cache to fill
+ * @param hour Hourly entry, one hour after the previous one
+ * @return false if the cache is full or the entry is not the next hour
+ */
+bool ForecastCache_Append(ForecastCache* cache, const ForecastInfo* hour) {
+  if (cache->count >= FORECAST_CACHE_HOURS) {
+    return false;
+  }
+
+  int tenths = ForecastCache_ToTenths(hour->temperature);
+  if (cache->count == 0) {
+    cache->firstHour = hour->time;
+    cache->firstTemperature = (int16_t)tenths;
+    cache->temperatureDelta[0] = 0;
+  } else {
+    if (hour->time != cache->firstHour + cache->count * 3600) {
+      return false;
+    }
+    ForecastInfo previous;
+    ForecastCache_Get(cache, cache->count - 1, &previous);
+    int delta = tenths - previous.temperature / 10;
+    cache->temperatureDelta[cache->count] = (int8_t)(delta < -128 ? -128 : delta > 127 ? 127 : delta);
+  }
+
+  uint8_t popSteps = (hour->pop + FORECAST_CACHE_POP_STEP / 2) / FORECAST_CACHE_POP_STEP;
+  uint8_t icon = hour->iconNumber < ICON_COUNT ? hour->iconNumber : FORECAST_CACHE_ICON_MASK;
+  cache->popIcon[cache->count] = (uint8_t)((popSteps << FORECAST_CACHE_ICON_BITS) | icon);
+  cache->count++;
+  return true;
+}
+
+/**
+ * Expands one hourly entry
+ *
+ * @param cache Cache to read
+ * @param index Hour index, 0 being the first hourly entry
+ * @param hour Receives the entry; temperature has 1/10 degree resolution and
+ *             rounds to the same whole degrees as the appended one
+ * @return false if the index is outside the series
+ */
+bool ForecastCache_Get(const ForecastCache* cache, int index, ForecastInfo* hour) {
+  if (index < 0 || index >= cache->count) {
+    return false;
+  }
+
+  int tenths = cache->firstTemperature;
+  for (int i = 1; i <= index; i++) {
+    tenths += cache->temperatureDelta[i];
+  }
+
+  uint8_t icon = cache->popIcon[index] & FORECAST_CACHE_ICON_MASK;
+  hour->time = cache->firstHour + index * 3600;
+  hour->temperature = (int16_t)(tenths * 10);
+  hour->pop = (uint8_t)((cache->popIcon[index] >> FORECAST_CACHE_ICON_BITS) * FORECAST_CACHE_POP_STEP);
+  hour->iconNumber = icon < ICON_COUNT ? icon : (uint8_t)ICON_UNKNOWN;
+  return true;
+}
+
+/**
+ * Marks the cache as empty
+ */
+void ForecastCache_Invalidate(ForecastCache* cache) {
+  cache->magic = 0;
+}
+
+/**
+ * Checks that the cache holds a series
+ */
+bool ForecastCache_IsValid(const ForecastCache* cache) {
+  return cache->magic == FORECAST_CACHE_MAGIC && cache->count > 0;
+}
+
+/**
+ * Returns the age of the cached response
+ *
+ * @param cache Cache to check
+ * @param now Current time (UTC)
+ * @return Age in seconds, or -1 if the cache is empty or the clock is behind it
+ */
+int32_t ForecastCache_Age(const ForecastCache* cache, int32_t now) {
+  if (!ForecastCache_IsValid(cache) || now < cache->fetchedAt) {
+    return -1;
+  }
+  return now - cache->fetchedAt;
+}
+
+/**
+ * Builds the display slots for the given time
+ *
+ * Slot 0 is the present: the current conditions while still within the
+ * hour they were fetched in, the hourly entry containing now afterwards,
+ * with its time set to now. The other slots are the hourly entries
+ * hourOffsets[i] hours after the present one.
+ *
+ * @param cache Cache to read
+ * @param now Current time (UTC)
+ * @param hourOffsets Hours from the present for each slot, hourOffsets[0] being 0
+ * @param count Number of slots
+ * @param slots Receives the slots
+ * @return Number of slots filled; less than count when the series runs out
+ */
+int ForecastCache_Window(const ForecastCache* cache, int32_t now, const uint8_t* hourOffsets, int count,
+                         ForecastInfo* slots) {
+  if (!ForecastCache_IsValid(cache) || now < cache->firstHour) {
+    return 0;
+  }
+
+  int present = (now - cache->firstHour) / 3600;
+  for (int i = 0; i < count; i++) {
+    if (i == 0 && present == (cache->fetchedAt - cache->firstHour) / 3600) {
+      slots[0] = cache->current;
+    } else if (!ForecastCache_Get(cache, present + hourOffsets[i], &slots[i])) {
+      return i;
+    }
+  }
+  if (count > 0) {
+    slots[0].time = now;
+  }
+  return count;
+}
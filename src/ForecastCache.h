@@ -0,0 +1,46 @@
+#ifndef _FORECAST_CACHE_H_
+#define _FORECAST_CACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Forecast.h"
+
+/**
+ * Compact cache of the hourly forecast series
+ *
+ * Holds the whole hourly series of one One Call response (48 hours) in
+ * about 120 bytes, small enough for RTC memory. Temperatures are stored
+ * as 1/10 degree deltas from the previous hour, and each hour's
+ * probability of precipitation (5% steps) and icon share one byte.
+ * Wakes that find the cache fresh build the display from it and leave
+ * the radio off.
+ */
+
+#define FORECAST_CACHE_HOURS 48
+#define FORECAST_CACHE_POP_STEP 5    // Probability of precipitation resolution (%)
+#define FORECAST_CACHE_ICON_BITS 3   // Enough for ICON_COUNT icons and one unknown value
+
+static_assert(ICON_COUNT < (1 << FORECAST_CACHE_ICON_BITS), "icon numbers must fit the cache");
+
+struct ForecastCache {
+  uint32_t magic;                 // Valid when set by ForecastCache_Begin
+  int32_t fetchedAt;              // Time of the response (UTC), current.dt
+  int32_t firstHour;              // Time of the first hourly entry (UTC)
+  int16_t firstTemperature;       // Temperature of the first hourly entry in 1/10 degrees
+  uint8_t count;                  // Number of hourly entries
+  uint8_t reserved;
+  ForecastInfo current;           // Current conditions at fetchedAt
+  int8_t temperatureDelta[FORECAST_CACHE_HOURS];  // 1/10 degrees from the previous hour
+  uint8_t popIcon[FORECAST_CACHE_HOURS];          // Pop steps in the high bits, icon in the low bits
+};
+
+void ForecastCache_Begin(ForecastCache* cache, const ForecastInfo* current);
+bool ForecastCache_Append(ForecastCache* cache, const ForecastInfo* hour);
+bool ForecastCache_Get(const ForecastCache* cache, int index, ForecastInfo* hour);
+void ForecastCache_Invalidate(ForecastCache* cache);
+bool ForecastCache_IsValid(const ForecastCache* cache);
+int32_t ForecastCache_Age(const ForecastCache* cache, int32_t now);
+int ForecastCache_Window(const ForecastCache* cache, int32_t now, const uint8_t* hourOffsets, int count,
+                         ForecastInfo* slots);
+
+#endif
@@ -0,0 +1,116 @@
+#include "ForecastView.h"
+#include "EPD.h"
+
+/**
+ * Draws a weather icon, preferring a custom one
+ */
+static void ForecastView_DrawIcon(const ForecastView* view, uint16_t x, uint16_t y, int iconNumber) {
+  if (view->drawImage == NULL || !view->drawImage(view->imageContext, iconNumber, x, y)) {
+    EPD_ShowCompressedPicture(x, y, view->icons[iconNumber], WHITE);
+  }
+}
+
+/**
+ * Draws one forecast column
+ *
+ * @param view Frame to draw
+ * @param index Column index
+ */
+void ForecastView_DrawSlot(const ForecastView* view, int index) {
+  const ForecastSlotText& text = view->slots[index];
+  int baseX = FORECAST_VIEW_COLUMN_WIDTH * index;
+
+  if (text.time[0] != '\0') {
+    // Display Time
+    EPD_ShowString(26 + baseX, 18, text.time, 44, BLACK);
+
+    // Display Weather Icon
+    if (text.iconNumber < ICON_COUNT) {
+      ForecastView_DrawIcon(view, 16 + baseX, 60, text.iconNumber);
+    }
+
+    // Display Temperature with appropriate unit
+    EPD_ShowString(30 + baseX, 190, text.temperature, 36, BLACK);
+    EPD_DrawCircle(100 + baseX, 201, 2, BLACK, false);
+    EPD_DrawCircle(100 + baseX, 201, 3, BLACK, false);
+
+    // Display Probability of precipitation
+    if (text.pop[0] != '\0') {
+      EPD_ShowString(30 + baseX, 225, text.pop, 36, BLACK);
+    }
+  }
+
+  // Mark an Out-of-Date Forecast With a "last updated" Badge
+  if (text.updated[0] != '\0') {
+    EPD_DrawRectangle(4 + baseX, 226, 154 + baseX, 272, BLACK, true);
+    EPD_ShowString(10 + baseX, 226, "last updated", 24, WHITE);
+    EPD_ShowString(46 + baseX, 248, text.updated, 24, WHITE);
+  }
+}
+
+/**
+ * Draws the battery glyph above the time of the last column
+ *
+ * @param bars Filled bars, 0 for an empty outline
+ */
+void ForecastView_DrawBattery(uint8_t bars) {
+  const int left = 758, top = 3;  // Outline 26 x 12, terminal on the right
+
+  EPD_DrawRectangle(left, top, left + 30, top + 12, WHITE, true);
+  EPD_DrawRectangle(left, top, left + 26, top + 12, BLACK, false);
+  EPD_DrawRectangle(left + 27, top + 4, left + 29, top + 8, BLACK, true);
+  for (int i = 0; i < bars && i < FORECAST_VIEW_BATTERY_BARS; i++) {
+    EPD_DrawRectangle(left + 3 + i * 6, top + 3, left + 7 + i * 6, top + 9, BLACK, true);
+  }
+}
+
+/**
+ * Draws forecast columns, or the part of them inside a tile
+ *
+ * Columns outside slotMask are left as they are, so only changed columns
+ * are redrawn, unless wholeFrame is set. Columns that cannot reach the
+ * tile are skipped; the clip window takes care of the rest.
+ *
+ * @param view ForecastView to draw; void* so it can be passed to TileRender_Frame
+ * @param tile Tile to draw
+ */
+void ForecastView_Draw(void* view, const TILE* tile) {
+  const ForecastView* frame = (const ForecastView*)view;
+
+  if (frame->wholeFrame) {
+    Paint_Clear(WHITE);
+
+    // Display Background Image If Provided
+    if (frame->drawImage != NULL) {
+      frame->drawImage(frame->imageContext, FORECAST_VIEW_BACKGROUND, 0, 0);
+    }
+  }
+
+  for (int i = 0; i < FORECAST_VIEW_COLUMNS; i++) {
+    int left = FORECAST_VIEW_COLUMN_WIDTH * i;
+    int right = FORECAST_VIEW_COLUMN_WIDTH * (i + 1) + 2;  // Past the column's clearing rectangle
+    if (left >= tile->xEnd || right <= tile->xStart) {
+      continue;
+    }
+
+    if (frame->wholeFrame || (frame->slotMask & (1 << i))) {
+      if (!frame->wholeFrame) {
+        // Clear the column between its separator lines
+        int clearLeft = i == 0 ? 0 : 3 + FORECAST_VIEW_COLUMN_WIDTH * i;
+        int clearRight = i == FORECAST_VIEW_COLUMNS - 1 ? 791 : 1 + FORECAST_VIEW_COLUMN_WIDTH * (i + 1);
+        EPD_DrawRectangle(clearLeft, 0, clearRight, 272, WHITE, true);
+      }
+      ForecastView_DrawSlot(frame, i);
+    }
+  }
+
+  // Draw Separator Lines
+  for (int i = 1; i < FORECAST_VIEW_COLUMNS; i++) {
+    EPD_DrawLine(2 + FORECAST_VIEW_COLUMN_WIDTH * i, 0, 2 + FORECAST_VIEW_COLUMN_WIDTH * i, 271, BLACK);
+  }
+
+  // Battery Glyph, Also Drawn When No Column Changed
+  if (frame->showBattery) {
+    ForecastView_DrawBattery(frame->batteryBars);
+  }
+}
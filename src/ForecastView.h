@@ -0,0 +1,44 @@
+#ifndef _FORECAST_VIEW_H_
+#define _FORECAST_VIEW_H_
+
+#include <stdint.h>
+#include "Forecast.h"
+#include "AssetCodec.h"
+#include "TileRender.h"
+
+/**
+ * Layout of the forecast columns
+ *
+ * Draws the text of each column (see Forecast_FormatSlot) into the
+ * current Paint image. Custom images are drawn through a callback, so
+ * the layout has no file system dependency and renders the same frames
+ * on the host, e.g. for previews. Drawing can be split into tiles with
+ * TileRender_Frame.
+ */
+
+#define FORECAST_VIEW_COLUMNS 5
+#define FORECAST_VIEW_COLUMN_WIDTH 158
+#define FORECAST_VIEW_ALL_COLUMNS ((1 << FORECAST_VIEW_COLUMNS) - 1)
+#define FORECAST_VIEW_BACKGROUND -1  // Image number of the full-screen background
+#define FORECAST_VIEW_BATTERY_BARS 4 // Bars of a full battery glyph
+
+struct ForecastView {
+  const ForecastSlotText* slots;          // Text of each column
+  uint8_t slotMask;                       // Columns to draw, FORECAST_VIEW_ALL_COLUMNS for a whole frame
+  bool wholeFrame;                        // Clear and redraw every column, e.g. over a custom background
+  const COMPRESSED_ASSET* const* icons;   // Built-in icons indexed by icon number
+
+  // Draws a custom icon (icon number) or background (FORECAST_VIEW_BACKGROUND),
+  // returning false when there is none; may be NULL
+  bool (*drawImage)(void* context, int image, uint16_t x, uint16_t y);
+  void* imageContext;
+
+  bool showBattery;                       // Draw the battery glyph in the top right corner
+  uint8_t batteryBars;                    // Bars of the glyph, 0 to FORECAST_VIEW_BATTERY_BARS
+};
+
+void ForecastView_DrawSlot(const ForecastView* view, int index);
+void ForecastView_DrawBattery(uint8_t bars);
+void ForecastView_Draw(void* view, const TILE* tile);
+
+#endif
@@ -0,0 +1,173 @@
+#include "FrameCodec.h"
+#include "FrameOps.h"
+#include <string.h>
+
+#define FRAME_CODEC_MAX_ROW_BYTES 256  // Widest supported row
+
+/**
+ * Bytes of a mask with one bit per item
+ */
+static size_t FrameCodec_MaskBytes(size_t items)
+{
+  return (items + 7) / 8;
+}
+
+/**
+ * Encodes one row delta after its group mask
+ *
+ * @param delta Row XOR the row above
+ * @param rowBytes Bytes per row
+ * @param groupMask Receives the group mask, zeroed by the caller
+ * @param out Receives the byte masks and nonzero bytes
+ * @param capacity Size of out
+ * @return Bytes written to out, or SIZE_MAX if they do not fit
+ */
+static size_t FrameCodec_EncodeRow(const uint8_t *delta, uint16_t rowBytes, uint8_t *groupMask, uint8_t *out,
+                                   size_t capacity)
+{
+  size_t length = 0;
+  for (uint16_t g = 0; g * FRAME_CODEC_GROUP < rowBytes; g++) {
+    uint16_t start = g * FRAME_CODEC_GROUP;
+    uint16_t end = start + FRAME_CODEC_GROUP < rowBytes ? start + FRAME_CODEC_GROUP : rowBytes;
+    uint8_t byteMask = 0;
+    for (uint16_t i = start; i < end; i++) {
+      if (delta[i] != 0) {
+        byteMask |= 1 << (i - start);
+      }
+    }
+    if (byteMask == 0) {
+      continue;
+    }
+
+    if (capacity - length < 1u + (end - start)) {
+      return SIZE_MAX;
+    }
+    groupMask[g >> 3] |= 1 << (g & 7);
+    out[length++] = byteMask;
+    for (uint16_t i = start; i < end; i++) {
+      if (delta[i] != 0) {
+        out[length++] = delta[i];
+      }
+    }
+  }
+  return length;
+}
+
+/**
+ * Encodes a frame
+ *
+ * @param frame Frame to encode, rows stored back to back
+ * @param rowBytes Bytes per row, at most 256
+ * @param rows Number of rows
+ * @param out Receives the encoded frame
+ * @param capacity Size of out; FRAME_CODEC_MAX_SIZE always suffices
+ * @return Encoded size in bytes, or 0 if it does not fit out
+ */
+size_t FrameCodec_Encode(const uint8_t *frame, uint16_t rowBytes, uint16_t rows, uint8_t *out, size_t capacity)
+{
+  alignas(FRAMEOPS_ALIGN) uint8_t delta[FRAME_CODEC_MAX_ROW_BYTES];
+  size_t rowMaskBytes = FrameCodec_MaskBytes(rows);
+  size_t groupMaskBytes = FrameCodec_MaskBytes(FrameCodec_MaskBytes(rowBytes));
+
+  if (rowBytes == 0 || rowBytes > FRAME_CODEC_MAX_ROW_BYTES || capacity < rowMaskBytes) {
+    return 0;
+  }
+  uint8_t *rowMask = out;
+  memset(rowMask, 0, rowMaskBytes);
+  size_t length = rowMaskBytes;
+
+  for (uint16_t r = 0; r < rows; r++) {
+    const uint8_t *row = frame + (size_t)r * rowBytes;
+    if (r == 0) {
+      FrameOps_Invert(delta, row, rowBytes);  // Against a white row
+    } else if (FrameOps_XorDiff(delta, row, row - rowBytes, rowBytes, 1, NULL) == 0) {
+      continue;  // Same as the row above
+    }
+
+    if (capacity - length < groupMaskBytes) {
+      return 0;
+    }
+    uint8_t *groupMask = out + length;
+    memset(groupMask, 0, groupMaskBytes);
+    size_t rowLength = FrameCodec_EncodeRow(delta, rowBytes, groupMask, out + length + groupMaskBytes,
+                                            capacity - length - groupMaskBytes);
+    if (rowLength == SIZE_MAX) {
+      return 0;
+    }
+    if (rowLength > 0) {
+      rowMask[r >> 3] |= 1 << (r & 7);
+      length += groupMaskBytes + rowLength;
+    }
+  }
+  return length;
+}
+
+/**
+ * Decodes a frame written by FrameCodec_Encode
+ *
+ * @param data Encoded frame
+ * @param length Encoded size in bytes
+ * @param frame Receives the frame
+ * @param rowBytes Bytes per row, as when encoded
+ * @param rows Number of rows, as when encoded
+ * @return false if the data is not exactly one frame of this size
+ */
+bool FrameCodec_Decode(const uint8_t *data, size_t length, uint8_t *frame, uint16_t rowBytes, uint16_t rows)
+{
+  size_t rowMaskBytes = FrameCodec_MaskBytes(rows);
+  uint16_t groups = FrameCodec_MaskBytes(rowBytes);
+  size_t groupMaskBytes = FrameCodec_MaskBytes(groups);
+
+  if (rowBytes == 0 || rowBytes > FRAME_CODEC_MAX_ROW_BYTES || length < rowMaskBytes) {
+    return false;
+  }
+  const uint8_t *rowMask = data;
+  size_t pos = rowMaskBytes;
+
+  for (uint16_t r = 0; r < rows; r++) {
+    uint8_t *row = frame + (size_t)r * rowBytes;
+    memset(row, 0, rowBytes);
+
+    if (rowMask[r >> 3] & (1 << (r & 7))) {
+      if (length - pos < groupMaskBytes) {
+        return false;
+      }
+      const uint8_t *groupMask = data + pos;
+      pos += groupMaskBytes;
+      for (uint16_t g = 0; g < groupMaskBytes * 8; g++) {
+        if (!(groupMask[g >> 3] & (1 << (g & 7)))) {
+          continue;
+        }
+        uint16_t start = g * FRAME_CODEC_GROUP;
+        if (g >= groups || pos >= length) {
+          return false;
+        }
+        uint8_t byteMask = data[pos++];
+        for (uint16_t i = 0; i < FRAME_CODEC_GROUP && byteMask != 0; i++, byteMask >>= 1) {
+          if (!(byteMask & 1)) {
+            continue;
+          }
+          if (start + i >= rowBytes || pos >= length) {
+            return false;
+          }
+          row[start + i] = data[pos++];
+        }
+      }
+    }
+
+    // Undo the delta against the row above
+    if (r == 0) {
+      FrameOps_Invert(row, row, rowBytes);
+    } else {
+      FrameOps_XorDiff(row, row, row - rowBytes, rowBytes, 1, NULL);
+    }
+  }
+
+  // Unused mask bits must be clear, and every byte used
+  for (uint16_t r = rows; r < rowMaskBytes * 8; r++) {
+    if (rowMask[r >> 3] & (1 << (r & 7))) {
+      return false;
+    }
+  }
+  return pos == length;
+}
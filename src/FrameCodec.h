@@ -0,0 +1,39 @@
+#ifndef _FRAME_CODEC_H_
+#define _FRAME_CODEC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Lossless codec for 1-bpp frames
+ *
+ * Tuned for forecast frames: mostly white, with sparse glyphs and icons
+ * that repeat from one row to the next. Each row is XORed with the row
+ * above it (the first row with white), which turns white space and
+ * vertical edges into zero bytes. Only the nonzero bytes are stored,
+ * located by masks:
+ *
+ *   row mask     one bit per row, set where the row differs from the one above
+ *   then for each such row:
+ *     group mask   one bit per group of 8 bytes, set where a byte is nonzero
+ *     then for each such group:
+ *       byte mask  one bit per byte of the group, set where it is nonzero
+ *       the nonzero bytes
+ *
+ * Masks are LSB first. The row mask is the dirty-row bitmap of
+ * FrameOps_XorDiff, so unchanged rows are skipped without looking at
+ * their bytes. A blank frame takes one byte per 8 rows.
+ */
+
+#define FRAME_CODEC_GROUP 8  // Bytes per group
+
+// Worst case encoded size: every byte nonzero
+#define FRAME_CODEC_MAX_SIZE(rowBytes, rows) \
+  (((size_t)(rows) + 7) / 8 + (size_t)(rows) * \
+   (((rowBytes) + FRAME_CODEC_GROUP * 8 - 1) / (FRAME_CODEC_GROUP * 8) + \
+    ((rowBytes) + FRAME_CODEC_GROUP - 1) / FRAME_CODEC_GROUP + (rowBytes)))
+
+size_t FrameCodec_Encode(const uint8_t *frame, uint16_t rowBytes, uint16_t rows, uint8_t *out, size_t capacity);
+bool FrameCodec_Decode(const uint8_t *data, size_t length, uint8_t *frame, uint16_t rowBytes, uint16_t rows);
+
+#endif
@@ -0,0 +1,352 @@
+#include "FrameOps.h"
+#include <string.h>
+
+#define FRAMEOPS_BLOCK 16  // Bytes per vector register
+
+static uint32_t FrameOps_Load32(const uint8_t *p)
+{
+  uint32_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+static void FrameOps_Store32(uint8_t *p, uint32_t word)
+{
+  memcpy(p, &word, sizeof(word));
+}
+
+/**
+ * Inverts bytes a word at a time
+ */
+static void FrameOps_InvertWords(uint8_t *dst, const uint8_t *src, size_t length)
+{
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    FrameOps_Store32(dst + i, ~FrameOps_Load32(src + i));
+  }
+  for (; i < length; i++) {
+    dst[i] = ~src[i];
+  }
+}
+
+/**
+ * XORs bytes a word at a time
+ *
+ * @param diff Receives a ^ b, may be NULL
+ * @return Nonzero if a and b differ
+ */
+static uint32_t FrameOps_XorWords(uint8_t *diff, const uint8_t *a, const uint8_t *b, size_t length)
+{
+  uint32_t any = 0;
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    uint32_t word = FrameOps_Load32(a + i) ^ FrameOps_Load32(b + i);
+    any |= word;
+    if (diff) {
+      FrameOps_Store32(diff + i, word);
+    }
+  }
+  for (; i < length; i++) {
+    uint8_t byte = a[i] ^ b[i];
+    any |= byte;
+    if (diff) {
+      diff[i] = byte;
+    }
+  }
+  return any;
+}
+
+#if FRAMEOPS_PIE
+
+/**
+ * Bytes before the first 16-byte boundary at or after p, at most length
+ */
+static size_t FrameOps_Head(const void *p, size_t length)
+{
+  size_t head = (size_t)(-(uintptr_t)p & (FRAMEOPS_ALIGN - 1));
+  return head < length ? head : length;
+}
+
+/**
+ * True if both buffers are at the same offset from a 16-byte boundary
+ */
+static bool FrameOps_SameAlignment(const void *a, const void *b)
+{
+  return (((uintptr_t)a ^ (uintptr_t)b) & (FRAMEOPS_ALIGN - 1)) == 0;
+}
+
+/**
+ * Fills 16-byte blocks
+ *
+ * @param dst 16-byte aligned destination
+ * @param value Fill byte, broadcast to every lane
+ * @param blocks Number of blocks, at least 1
+ */
+static void FrameOps_FillBlocks(uint8_t *dst, const uint8_t *value, size_t blocks)
+{
+  asm volatile(
+    "ee.vldbc.8 q0, %[value]\n"
+    "1:\n"
+    "ee.vst.128.ip q0, %[dst], 16\n"
+    "addi %[blocks], %[blocks], -1\n"
+    "bnez %[blocks], 1b\n"
+    : [dst] "+r"(dst), [blocks] "+r"(blocks)
+    : [value] "r"(value)
+    : "memory");
+}
+
+/**
+ * Inverts 16-byte blocks
+ *
+ * @param dst 16-byte aligned destination, may equal src
+ * @param src 16-byte aligned source
+ * @param blocks Number of blocks, at least 1
+ */
+static void FrameOps_InvertBlocks(uint8_t *dst, const uint8_t *src, size_t blocks)
+{
+  asm volatile(
+    "1:\n"
+    "ee.vld.128.ip q0, %[src], 16\n"
+    "ee.notq q1, q0\n"
+    "ee.vst.128.ip q1, %[dst], 16\n"
+    "addi %[blocks], %[blocks], -1\n"
+    "bnez %[blocks], 1b\n"
+    : [dst] "+r"(dst), [src] "+r"(src), [blocks] "+r"(blocks)
+    :
+    : "memory");
+}
+
+/**
+ * XORs 16-byte blocks
+ *
+ * @param diff 16-byte aligned, receives a ^ b, may be NULL
+ * @param a 16-byte aligned input
+ * @param b 16-byte aligned input
+ * @param blocks Number of blocks, at least 1
+ * @return Nonzero if a and b differ
+ */
+static uint32_t FrameOps_XorBlocks(uint8_t *diff, const uint8_t *a, const uint8_t *b, size_t blocks)
+{
+  uint32_t w0, w1, w2, w3;
+  if (diff) {
+    asm volatile(
+      "ee.zero.q q3\n"
+      "1:\n"
+      "ee.vld.128.ip q0, %[a], 16\n"
+      "ee.vld.128.ip q1, %[b], 16\n"
+      "ee.xorq q2, q0, q1\n"
+      "ee.orq q3, q3, q2\n"
+      "ee.vst.128.ip q2, %[diff], 16\n"
+      "addi %[blocks], %[blocks], -1\n"
+      "bnez %[blocks], 1b\n"
+      "ee.movi.32.a q3, %[w0], 0\n"
+      "ee.movi.32.a q3, %[w1], 1\n"
+      "ee.movi.32.a q3, %[w2], 2\n"
+      "ee.movi.32.a q3, %[w3], 3\n"
+      : [diff] "+r"(diff), [a] "+r"(a), [b] "+r"(b), [blocks] "+r"(blocks),
+        [w0] "=&r"(w0), [w1] "=&r"(w1), [w2] "=&r"(w2), [w3] "=&r"(w3)
+      :
+      : "memory");
+  } else {
+    asm volatile(
+      "ee.zero.q q3\n"
+      "1:\n"
+      "ee.vld.128.ip q0, %[a], 16\n"
+      "ee.vld.128.ip q1, %[b], 16\n"
+      "ee.xorq q2, q0, q1\n"
+      "ee.orq q3, q3, q2\n"
+      "addi %[blocks], %[blocks], -1\n"
+      "bnez %[blocks], 1b\n"
+      "ee.movi.32.a q3, %[w0], 0\n"
+      "ee.movi.32.a q3, %[w1], 1\n"
+      "ee.movi.32.a q3, %[w2], 2\n"
+      "ee.movi.32.a q3, %[w3], 3\n"
+      : [a] "+r"(a), [b] "+r"(b), [blocks] "+r"(blocks),
+        [w0] "=&r"(w0), [w1] "=&r"(w1), [w2] "=&r"(w2), [w3] "=&r"(w3)
+      :
+      : "memory");
+  }
+  return w0 | w1 | w2 | w3;
+}
+
+#endif
+
+/**
+ * Names the kernels this build uses
+ *
+ * @return "PIE" for the ESP32-S3 vector kernels, "portable" otherwise
+ */
+const char *FrameOps_Name(void)
+{
+  return FRAMEOPS_PIE ? "PIE" : "portable";
+}
+
+/**
+ * Sets every byte of a buffer
+ *
+ * @param dst Buffer to fill
+ * @param value Byte value
+ * @param length Size of the buffer in bytes
+ */
+void FrameOps_Fill(uint8_t *dst, uint8_t value, size_t length)
+{
+#if FRAMEOPS_PIE
+  size_t head = FrameOps_Head(dst, length);
+  memset(dst, value, head);
+  dst += head;
+  length -= head;
+  size_t blocks = length / FRAMEOPS_BLOCK;
+  if (blocks > 0) {
+    FrameOps_FillBlocks(dst, &value, blocks);
+    dst += blocks * FRAMEOPS_BLOCK;
+  }
+  memset(dst, value, length % FRAMEOPS_BLOCK);
+#else
+  memset(dst, value, length);
+#endif
+}
+
+/**
+ * Writes the bitwise inverse of a buffer
+ *
+ * @param dst Destination, may be the same as src
+ * @param src Source
+ * @param length Size of both buffers in bytes
+ */
+void FrameOps_Invert(uint8_t *dst, const uint8_t *src, size_t length)
+{
+#if FRAMEOPS_PIE
+  if (FrameOps_SameAlignment(dst, src)) {
+    size_t head = FrameOps_Head(dst, length);
+    FrameOps_InvertWords(dst, src, head);
+    dst += head;
+    src += head;
+    length -= head;
+    size_t blocks = length / FRAMEOPS_BLOCK;
+    if (blocks > 0) {
+      FrameOps_InvertBlocks(dst, src, blocks);
+      dst += blocks * FRAMEOPS_BLOCK;
+      src += blocks * FRAMEOPS_BLOCK;
+      length -= blocks * FRAMEOPS_BLOCK;
+    }
+  }
+#endif
+  FrameOps_InvertWords(dst, src, length);
+}
+
+/**
+ * XORs one row
+ *
+ * @return Nonzero if the row differs
+ */
+static uint32_t FrameOps_XorRow(uint8_t *diff, const uint8_t *a, const uint8_t *b, size_t length)
+{
+  uint32_t any = 0;
+#if FRAMEOPS_PIE
+  if (FrameOps_SameAlignment(a, b) && (diff == NULL || FrameOps_SameAlignment(a, diff))) {
+    size_t head = FrameOps_Head(a, length);
+    any |= FrameOps_XorWords(diff, a, b, head);
+    a += head;
+    b += head;
+    diff = diff ? diff + head : NULL;
+    length -= head;
+    size_t blocks = length / FRAMEOPS_BLOCK;
+    if (blocks > 0) {
+      any |= FrameOps_XorBlocks(diff, a, b, blocks);
+      a += blocks * FRAMEOPS_BLOCK;
+      b += blocks * FRAMEOPS_BLOCK;
+      diff = diff ? diff + blocks * FRAMEOPS_BLOCK : NULL;
+      length -= blocks * FRAMEOPS_BLOCK;
+    }
+  }
+#endif
+  return any | FrameOps_XorWords(diff, a, b, length);
+}
+
+/**
+ * Compares two images row by row
+ *
+ * @param diff Receives a ^ b, may be a itself, or NULL when only the dirty rows
+ *             are needed
+ * @param a First image, rows stored back to back
+ * @param b Second image of the same size
+ * @param rowBytes Bytes per row
+ * @param rows Number of rows
+ * @param dirtyRows Receives one bit per row, set where the row differs
+ *                  (row r is bit r % 8 of byte r / 8); (rows + 7) / 8 bytes,
+ *                  may be NULL
+ * @return Number of rows that differ
+ */
+uint16_t FrameOps_XorDiff(uint8_t *diff, const uint8_t *a, const uint8_t *b, uint16_t rowBytes, uint16_t rows,
+                          uint8_t *dirtyRows)
+{
+  uint16_t dirty = 0;
+  if (dirtyRows) {
+    memset(dirtyRows, 0, (rows + 7) / 8);
+  }
+
+  for (uint16_t r = 0; r < rows; r++) {
+    size_t offset = (size_t)r * rowBytes;
+    if (FrameOps_XorRow(diff ? diff + offset : NULL, a + offset, b + offset, rowBytes) != 0) {
+      dirty++;
+      if (dirtyRows) {
+        dirtyRows[r >> 3] |= 1 << (r & 7);
+      }
+    }
+  }
+  return dirty;
+}
+
+/**
+ * Counts the set bits of a buffer
+ *
+ * The PIE unit has no bit count, so both builds count a word at a time.
+ *
+ * @param src Buffer
+ * @param length Size of the buffer in bytes
+ * @return Number of bits set
+ */
+uint32_t FrameOps_Popcount(const uint8_t *src, size_t length)
+{
+  uint32_t count = 0;
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    uint32_t word = FrameOps_Load32(src + i);
+    word = word - ((word >> 1) & 0x55555555);
+    word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F;
+    count += (word * 0x01010101) >> 24;
+  }
+  for (; i < length; i++) {
+    uint8_t byte = src[i];
+    while (byte) {
+      byte &= byte - 1;
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * Transposes a matrix of bytes, so columns become contiguous
+ *
+ * This is the order in which the panel RAM takes an image: byte column
+ * by byte column, each one from the top row down. The PIE unit has no
+ * strided gather, so both builds copy byte by byte.
+ *
+ * @param dst Receives cols rows of rows bytes: dst[c * rows + r] = src[r * stride + c]
+ * @param src First byte of the matrix
+ * @param rows Number of source rows
+ * @param cols Number of source columns
+ * @param stride Bytes between source rows
+ */
+void FrameOps_Transpose(uint8_t *dst, const uint8_t *src, uint16_t rows, uint16_t cols, uint16_t stride)
+{
+  for (uint16_t c = 0; c < cols; c++) {
+    const uint8_t *column = src + c;
+    for (uint16_t r = 0; r < rows; r++) {
+      *dst++ = *column;
+      column += stride;
+    }
+  }
+}
@@ -0,0 +1,43 @@
+#ifndef _FRAME_OPS_H_
+#define _FRAME_OPS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Kernels for operations over a whole frame buffer
+ *
+ * Portable 32-bit word loops do the work by default. An ESP32-S3 build
+ * with -DFRAMEOPS_USE_PIE sends the bulk of each buffer through the
+ * 128-bit PIE vector unit instead, 16 bytes per instruction. Both give
+ * byte for byte the same results for any length and alignment, but only
+ * 16-byte aligned buffers (or buffer pairs at the same offset from a
+ * 16-byte boundary) reach the vector loops.
+ *
+ * The PIE kernels are opt-in until they have been checked on hardware:
+ * tile-worker tasks call FrameOps_Fill concurrently, and the Q registers
+ * are only safe across context switches on an IDF that saves the PIE
+ * context.
+ */
+
+#ifdef ARDUINO
+#include <sdkconfig.h>
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && defined(FRAMEOPS_USE_PIE)
+#define FRAMEOPS_PIE 1
+#else
+#define FRAMEOPS_PIE 0
+#endif
+
+#define FRAMEOPS_ALIGN 16  // Alignment that lets buffers use the vector loops
+
+const char *FrameOps_Name(void);
+void FrameOps_Fill(uint8_t *dst, uint8_t value, size_t length);
+void FrameOps_Invert(uint8_t *dst, const uint8_t *src, size_t length);
+uint16_t FrameOps_XorDiff(uint8_t *diff, const uint8_t *a, const uint8_t *b, uint16_t rowBytes, uint16_t rows,
+                          uint8_t *dirtyRows);
+uint32_t FrameOps_Popcount(const uint8_t *src, size_t length);
+void FrameOps_Transpose(uint8_t *dst, const uint8_t *src, uint16_t rows, uint16_t cols, uint16_t stride);
+
+#endif
@@ -0,0 +1,318 @@
+#include "ImageLoader.h"
+#include "EPD.h"
+#include <stdlib.h>
+
+#ifdef ARDUINO
+#include <LittleFS.h>
+#endif
+
+// Row buffer size: widest row plus BMP padding to a multiple of 4 bytes
+#define IMAGE_ROW_BUFFER_SIZE ((IMAGE_MAX_WIDTH / 8 + 3) / 4 * 4)
+
+// Dithering of grayscale images
+static DITHER_MODE ditherMode = DITHER_FLOYD_STEINBERG;
+
+// Dithering state of one grayscale image; too large for the stack, and
+// allocated per image so tiles on several workers can load images at once
+typedef struct
+{
+  DITHER dither;
+  uint8_t grayRow[IMAGE_MAX_WIDTH];
+} IMAGE_GRAY_STATE;
+
+/**
+ * Reads exactly length bytes
+ */
+static bool Image_ReadExact(IMAGE_READER *reader, uint8_t *buffer, size_t length)
+{
+  return reader->read(reader->context, buffer, length) == length;
+}
+
+/**
+ * Discards length bytes
+ */
+static bool Image_Skip(IMAGE_READER *reader, uint32_t length)
+{
+  uint8_t scratch[32];
+  while (length > 0) {
+    size_t chunk = length < sizeof(scratch) ? length : sizeof(scratch);
+    if (!Image_ReadExact(reader, scratch, chunk)) {
+      return false;
+    }
+    length -= chunk;
+  }
+  return true;
+}
+
+static uint16_t Image_Get16(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static uint32_t Image_Get32(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Reads one unsigned decimal number from a PBM header
+ *
+ * Skips leading whitespace and comments, and consumes the single
+ * whitespace character that ends the number.
+ */
+static bool Image_ReadPbmNumber(IMAGE_READER *reader, uint32_t *value)
+{
+  uint8_t c;
+
+  // Skip whitespace and comments
+  for (;;) {
+    if (!Image_ReadExact(reader, &c, 1)) {
+      return false;
+    }
+    if (c == '#') {
+      do {
+        if (!Image_ReadExact(reader, &c, 1)) {
+          return false;
+        }
+      } while (c != '\n' && c != '\r');
+    } else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+      break;
+    }
+  }
+
+  *value = 0;
+  while (c >= '0' && c <= '9') {
+    *value = *value * 10 + (c - '0');
+    if (*value > 0xFFFF || !Image_ReadExact(reader, &c, 1)) {
+      return false;
+    }
+  }
+
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Draws a PBM (P4) image whose magic number has already been read
+ *
+ * P4 rows are MSB first with 1 meaning black, which is the
+ * EPD_ShowPicture format, so rows are copied unchanged.
+ */
+static bool Image_LoadPbm(IMAGE_READER *reader, uint16_t x, uint16_t y, uint16_t Color, IMAGE_INFO *info)
+{
+  uint32_t width, height;
+  uint8_t row[IMAGE_ROW_BUFFER_SIZE];
+
+  if (!Image_ReadPbmNumber(reader, &width) || !Image_ReadPbmNumber(reader, &height)) {
+    return false;
+  }
+  if (width == 0 || width > IMAGE_MAX_WIDTH) {
+    return false;
+  }
+  if (info) {
+    info->width = width;
+    info->height = height;
+  }
+
+  uint16_t rowBytes = (width + 7) / 8;
+  for (uint32_t r = 0; r < height; r++) {
+    if (!Image_ReadExact(reader, row, rowBytes)) {
+      return false;
+    }
+    Paint_BlitRow(x, y + r, row, width, Color);
+  }
+  return true;
+}
+
+/**
+ * Draws a PGM (P5) image whose magic number has already been read
+ *
+ * Only 8-bit images (maxval up to 255) are supported. Samples are
+ * rescaled to 0..255 when maxval is smaller, then dithered.
+ */
+static bool Image_LoadPgm(IMAGE_READER *reader, uint16_t x, uint16_t y, IMAGE_INFO *info)
+{
+  uint32_t width, height, maxval;
+
+  if (!Image_ReadPbmNumber(reader, &width) || !Image_ReadPbmNumber(reader, &height) ||
+      !Image_ReadPbmNumber(reader, &maxval)) {
+    return false;
+  }
+  if (maxval == 0 || maxval > 255) {
+    return false;
+  }
+
+  IMAGE_GRAY_STATE *state = (IMAGE_GRAY_STATE *)malloc(sizeof(IMAGE_GRAY_STATE));
+  if (state == NULL || !Dither_Begin(&state->dither, ditherMode, x, y, width)) {
+    free(state);
+    return false;
+  }
+  if (info) {
+    info->width = width;
+    info->height = height;
+  }
+
+  bool result = true;
+  uint8_t *grayRow = state->grayRow;
+  for (uint32_t r = 0; r < height; r++) {
+    if (!Image_ReadExact(reader, grayRow, width)) {
+      result = false;
+      break;
+    }
+    if (maxval != 255) {
+      for (uint32_t i = 0; i < width; i++) {
+        grayRow[i] = grayRow[i] >= maxval ? 255 : grayRow[i] * 255 / maxval;
+      }
+    }
+    Dither_WriteRow(&state->dither, grayRow);
+  }
+  free(state);
+  return result;
+}
+
+/**
+ * Draws a 1-bpp BMP image whose "BM" signature has already been read
+ *
+ * Reads the file strictly front to back: bottom-up images are drawn
+ * from the last row upwards instead of seeking.
+ */
+static bool Image_LoadBmp(IMAGE_READER *reader, uint16_t x, uint16_t y, uint16_t Color, IMAGE_INFO *info)
+{
+  uint8_t header[12 + 40];  // Rest of the file header and a BITMAPINFOHEADER
+  uint8_t palette[8];
+  uint8_t row[IMAGE_ROW_BUFFER_SIZE];
+  uint32_t consumed = 2;
+
+  if (!Image_ReadExact(reader, header, sizeof(header))) {
+    return false;
+  }
+  consumed += sizeof(header);
+
+  uint32_t dataOffset = Image_Get32(header + 8);
+  uint32_t dibSize = Image_Get32(header + 12);
+  int32_t width = (int32_t)Image_Get32(header + 16);
+  int32_t height = (int32_t)Image_Get32(header + 20);
+  uint16_t bitCount = Image_Get16(header + 26);
+  uint32_t compression = Image_Get32(header + 28);
+
+  if (dibSize < 40 || bitCount != 1 || compression != 0) {
+    return false;  // Only uncompressed 1-bpp images are supported
+  }
+  if (width <= 0 || width > IMAGE_MAX_WIDTH || height == 0 || height == INT32_MIN) {
+    return false;
+  }
+
+  // The DIB header and the palette must end before the pixel data; checked
+  // before adding them up, so that no header size can wrap consumed around
+  if (dibSize > dataOffset || dataOffset - dibSize < consumed - 40 + sizeof(palette)) {
+    return false;
+  }
+
+  bool bottomUp = height > 0;
+  if (!bottomUp) {
+    height = -height;
+  }
+  if (info) {
+    info->width = width;
+    info->height = height;
+  }
+
+  // Read the two-color palette that follows the DIB header
+  if (!Image_Skip(reader, dibSize - 40) || !Image_ReadExact(reader, palette, sizeof(palette))) {
+    return false;
+  }
+  consumed += dibSize - 40 + sizeof(palette);
+  if (dataOffset < consumed || !Image_Skip(reader, dataOffset - consumed)) {
+    return false;
+  }
+
+  // Set bits must mean "dark"; invert when color 0 is the darker one
+  uint16_t luma0 = palette[0] + palette[1] + palette[2];
+  uint16_t luma1 = palette[4] + palette[5] + palette[6];
+  uint8_t invert = (luma0 < luma1) ? 0xFF : 0x00;
+
+  uint16_t rowBytes = (width + 7) / 8;
+  uint16_t stride = (rowBytes + 3) / 4 * 4;
+  for (int32_t r = 0; r < height; r++) {
+    if (!Image_ReadExact(reader, row, stride)) {
+      return false;
+    }
+    if (invert) {
+      for (uint16_t i = 0; i < rowBytes; i++) {
+        row[i] = ~row[i];
+      }
+    }
+    Paint_BlitRow(x, y + (bottomUp ? height - 1 - r : r), row, width, Color);
+  }
+  return true;
+}
+
+/**
+ * Selects the dithering algorithm for grayscale images
+ *
+ * @param mode Dithering algorithm
+ */
+void Image_SetDitherMode(DITHER_MODE mode)
+{
+  ditherMode = mode;
+}
+
+/**
+ * Draws a PBM (P4), PGM (P5) or 1-bpp BMP image into the current Paint image
+ *
+ * @param reader Byte source positioned at the start of the image
+ * @param x Image x coordinate
+ * @param y Image y coordinate
+ * @param Color Pixel color parameter, as in EPD_ShowPicture
+ * @param info Receives the image size, may be NULL
+ * @return true on success, false on an unsupported or truncated image
+ */
+bool Image_Load(IMAGE_READER *reader, uint16_t x, uint16_t y, uint16_t Color, IMAGE_INFO *info)
+{
+  uint8_t magic[2];
+  if (!Image_ReadExact(reader, magic, sizeof(magic))) {
+    return false;
+  }
+
+  if (magic[0] == 'P' && magic[1] == '4') {
+    return Image_LoadPbm(reader, x, y, Color, info);
+  }
+  if (magic[0] == 'P' && magic[1] == '5') {
+    return Image_LoadPgm(reader, x, y, info);
+  }
+  if (magic[0] == 'B' && magic[1] == 'M') {
+    return Image_LoadBmp(reader, x, y, Color, info);
+  }
+  return false;
+}
+
+#ifdef ARDUINO
+
+static size_t Image_ReadFile(void *context, uint8_t *buffer, size_t length)
+{
+  return ((fs::File *)context)->read(buffer, length);
+}
+
+/**
+ * Draws a PBM (P4), PGM (P5) or 1-bpp BMP image file from LittleFS
+ *
+ * @param path File path
+ * @param x Image x coordinate
+ * @param y Image y coordinate
+ * @param Color Pixel color parameter, as in EPD_ShowPicture
+ * @param info Receives the image size, may be NULL
+ * @return true on success, false if the file is missing or unsupported
+ */
+bool Image_LoadFile(const char *path, uint16_t x, uint16_t y, uint16_t Color, IMAGE_INFO *info)
+{
+  fs::File file = LittleFS.open(path, "r");
+  if (!file) {
+    return false;
+  }
+
+  IMAGE_READER reader = {&file, Image_ReadFile};
+  bool result = Image_Load(&reader, x, y, Color, info);
+  file.close();
+  return result;
+}
+
+#endif
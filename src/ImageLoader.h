@@ -0,0 +1,48 @@
+#ifndef _IMAGE_LOADER_H_
+#define _IMAGE_LOADER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Dither.h"
+
+/**
+ * Streaming loader for monochrome images
+ *
+ * Supports binary PBM (P4), uncompressed 1-bpp BMP and 8-bit binary
+ * PGM (P5) files. PGM images are dithered row by row (see Dither.h).
+ * Rows are read one at a time into a fixed buffer and copied into the
+ * current Paint image with Paint_BlitRow, so the decoded image is never
+ * held in memory. Call Paint_NewImage first to draw into an offscreen
+ * buffer instead of the frame buffer.
+ *
+ * Dark pixels are drawn in !Color and light pixels in Color,
+ * as in EPD_ShowPicture.
+ */
+
+#define IMAGE_MAX_WIDTH 800  // Widest supported image in pixels
+
+/**
+ * Byte source of an image
+ * read() returns the number of bytes read, which is less than length
+ * only at the end of the data or on an error.
+ */
+typedef struct
+{
+  void *context;
+  size_t (*read)(void *context, uint8_t *buffer, size_t length);
+} IMAGE_READER;
+
+typedef struct
+{
+  uint16_t width;
+  uint16_t height;
+} IMAGE_INFO;
+
+void Image_SetDitherMode(DITHER_MODE mode);
+bool Image_Load(IMAGE_READER *reader, uint16_t x, uint16_t y, uint16_t Color, IMAGE_INFO *info);
+
+#ifdef ARDUINO
+bool Image_LoadFile(const char *path, uint16_t x, uint16_t y, uint16_t Color, IMAGE_INFO *info);
+#endif
+
+#endif
@@ -0,0 +1,367 @@
+#include "NetworkSelect.h"
+#include <string.h>
+
+#define NETWORK_STATE_MAGIC 0x4E534C32  // "NSL2"
+
+// Score adjustments in dB
+#define NETWORK_UNSEEN_PENALTY 20   // Known from history but missing from the last scan
+#define NETWORK_FAILURE_PENALTY 15  // Per consecutive failed attempt
+
+/**
+ * FNV-1a hash of an SSID
+ *
+ * @param ssid Network name
+ * @return Hash value, never 0
+ */
+uint32_t Network_HashSsid(const char *ssid)
+{
+  uint32_t hash = 2166136261UL;
+  while (*ssid) {
+    hash = (hash ^ (uint8_t)*ssid++) * 16777619UL;
+  }
+  return hash != 0 ? hash : 1;
+}
+
+/**
+ * Clears the state unless it already holds valid data
+ *
+ * @param state State kept in RTC memory
+ */
+void Network_InitState(NETWORK_STATE *state)
+{
+  if (state->magic != NETWORK_STATE_MAGIC) {
+    memset(state, 0, sizeof(*state));
+    state->magic = NETWORK_STATE_MAGIC;
+  }
+}
+
+static int Network_FindCredential(const NETWORK_CREDENTIAL *credentials, int count, uint32_t ssidHash)
+{
+  for (int i = 0; i < count; i++) {
+    if (Network_HashSsid(credentials[i].ssid) == ssidHash) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static const NETWORK_HISTORY *Network_FindHistory(const NETWORK_STATE *state, uint32_t ssidHash)
+{
+  for (int i = 0; i < NETWORK_MAX_CREDENTIALS; i++) {
+    if (state->history[i].ssidHash == ssidHash) {
+      return &state->history[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Returns the history slot of a network, claiming one if needed
+ *
+ * A free slot is used first, then the slot with the most failures.
+ */
+static NETWORK_HISTORY *Network_ClaimHistory(NETWORK_STATE *state, uint32_t ssidHash)
+{
+  NETWORK_HISTORY *slot = (NETWORK_HISTORY *)Network_FindHistory(state, ssidHash);
+  if (slot != NULL) {
+    return slot;
+  }
+
+  slot = &state->history[0];
+  for (int i = 0; i < NETWORK_MAX_CREDENTIALS; i++) {
+    NETWORK_HISTORY *history = &state->history[i];
+    if (history->ssidHash == 0) {
+      slot = history;
+      break;
+    }
+    if (history->failures > slot->failures) {
+      slot = history;
+    }
+  }
+
+  memset(slot, 0, sizeof(*slot));
+  slot->ssidHash = ssidHash;
+  slot->rssiAverage = NETWORK_RSSI_UNKNOWN;
+  return slot;
+}
+
+/**
+ * Ranks the known networks, best first
+ *
+ * Networks in the cached scan are scored by their signal, averaged with
+ * the signal of past connections. Networks known only from history are
+ * scored lower, and every consecutive failure lowers the score further.
+ * Networks with neither are left out.
+ *
+ * @param state Selection state
+ * @param credentials Known networks
+ * @param count Number of known networks
+ * @param candidates Receives up to count candidates
+ * @return Number of candidates
+ */
+int Network_Rank(const NETWORK_STATE *state, const NETWORK_CREDENTIAL *credentials, int count,
+                 NETWORK_CANDIDATE *candidates)
+{
+  int found = 0;
+
+  for (int i = 0; i < count && i < NETWORK_MAX_CREDENTIALS; i++) {
+    uint32_t hash = Network_HashSsid(credentials[i].ssid);
+    const NETWORK_HISTORY *history = Network_FindHistory(state, hash);
+    const NETWORK_SCAN_RESULT *seen = NULL;
+
+    // The scan is sorted, so the first match is the strongest access point
+    for (int j = 0; j < state->scanCount && seen == NULL; j++) {
+      if (state->scan[j].ssidHash == hash) {
+        seen = &state->scan[j];
+      }
+    }
+
+    bool known = history != NULL && history->rssiAverage != NETWORK_RSSI_UNKNOWN;
+    NETWORK_CANDIDATE candidate;
+    memset(&candidate, 0, sizeof(candidate));
+    candidate.credential = i;
+
+    if (seen != NULL) {
+      candidate.score = known ? (seen->rssi + history->rssiAverage) / 2 : seen->rssi;
+      candidate.channel = seen->channel;
+      memcpy(candidate.bssid, seen->bssid, sizeof(candidate.bssid));
+    } else if (known) {
+      candidate.score = history->rssiAverage - NETWORK_UNSEEN_PENALTY;
+      candidate.channel = history->channel;
+      memcpy(candidate.bssid, history->bssid, sizeof(candidate.bssid));
+    } else {
+      continue;
+    }
+    if (history != NULL) {
+      candidate.score -= history->failures * NETWORK_FAILURE_PENALTY;
+    }
+
+    // Insertion sort, keeping the configured order for equal scores
+    int k = found++;
+    while (k > 0 && candidates[k - 1].score < candidate.score) {
+      candidates[k] = candidates[k - 1];
+      k--;
+    }
+    candidates[k] = candidate;
+  }
+
+  return found;
+}
+
+static bool Network_InScan(const NETWORK_STATE *state, uint32_t ssidHash)
+{
+  for (int i = 0; i < state->scanCount; i++) {
+    if (state->scan[i].ssidHash == ssidHash) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Returns the milliseconds left before a deadline, 0 once it has passed
+ */
+static uint32_t Network_Remaining(const NETWORK_DRIVER *driver, uint32_t deadlineMs)
+{
+  int32_t left = (int32_t)(deadlineMs - driver->millis(driver->context));
+  return left > 0 ? (uint32_t)left : 0;
+}
+
+/**
+ * Joins one network and records the outcome in its history
+ */
+static bool Network_Try(NETWORK_STATE *state, const NETWORK_CREDENTIAL *credential, const NETWORK_DRIVER *driver,
+                        const uint8_t *bssid, uint8_t channel, uint32_t timeoutMs)
+{
+  bool connected = driver->connect(driver->context, credential, bssid, channel, timeoutMs);
+  NETWORK_HISTORY *history = Network_ClaimHistory(state, Network_HashSsid(credential->ssid));
+
+  if (!connected) {
+    if (history->failures < 255) {
+      history->failures++;
+    }
+    return false;
+  }
+
+  int8_t rssi = NETWORK_RSSI_UNKNOWN;
+  driver->status(driver->context, &rssi, history->bssid, &history->channel);
+  history->failures = 0;
+  if (Network_InScan(state, history->ssidHash)) {
+    history->hidden = 0;
+  } else if (bssid == NULL) {
+    history->hidden = 1;
+  }
+  if (rssi != NETWORK_RSSI_UNKNOWN) {
+    // Exponential moving average, weight 1/4 for the new sample
+    history->rssiAverage = history->rssiAverage == NETWORK_RSSI_UNKNOWN
+                               ? rssi
+                               : (int8_t)((history->rssiAverage * 3 + rssi) / 4);
+  }
+  return true;
+}
+
+/**
+ * Tries the best ranked candidates by direct join
+ *
+ * @param searched Bit mask of credentials joined without an access point, updated
+ * @param scannedOnly Skip candidates missing from the cached scan
+ * @param deadlineMs End of the whole connection, in driver milliseconds
+ * @return Index of the connected credential, or -1
+ */
+static int Network_TryRanked(NETWORK_STATE *state, const NETWORK_CREDENTIAL *credentials, int count,
+                             const NETWORK_DRIVER *driver, uint32_t timeoutMs, uint32_t *searched, bool scannedOnly,
+                             uint32_t deadlineMs)
+{
+  NETWORK_CANDIDATE candidates[NETWORK_MAX_CREDENTIALS];
+  int found = Network_Rank(state, credentials, count, candidates);
+  int attempts = 0;
+
+  for (int i = 0; i < found && attempts < NETWORK_MAX_CANDIDATES; i++) {
+    const NETWORK_CANDIDATE *candidate = &candidates[i];
+    const NETWORK_CREDENTIAL *credential = &credentials[candidate->credential];
+    if (scannedOnly && !Network_InScan(state, Network_HashSsid(credential->ssid))) {
+      continue;
+    }
+
+    uint32_t left = Network_Remaining(driver, deadlineMs);
+    if (left == 0) {
+      return -1;
+    }
+
+    attempts++;
+    if (candidate->channel == 0) {
+      *searched |= 1UL << candidate->credential;
+    }
+    if (Network_Try(state, credential, driver, candidate->channel != 0 ? candidate->bssid : NULL,
+                    candidate->channel, timeoutMs < left ? timeoutMs : left)) {
+      return candidate->credential;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Scans and caches the access points of known networks, strongest first
+ */
+static void Network_Scan(NETWORK_STATE *state, const NETWORK_CREDENTIAL *credentials, int count,
+                         const NETWORK_DRIVER *driver)
+{
+  int total = driver->scan(driver->context);
+  state->scanCount = 0;
+
+  for (int i = 0; i < total; i++) {
+    NETWORK_SCAN_RESULT result;
+    if (!driver->scanResult(driver->context, i, &result) ||
+        Network_FindCredential(credentials, count, result.ssidHash) < 0) {
+      continue;
+    }
+
+    // Insert by signal strength, dropping the weakest when full
+    int k = state->scanCount;
+    if (k == NETWORK_MAX_SCAN_RESULTS) {
+      if (state->scan[k - 1].rssi >= result.rssi) {
+        continue;
+      }
+      k--;
+    } else {
+      state->scanCount++;
+    }
+    while (k > 0 && state->scan[k - 1].rssi < result.rssi) {
+      state->scan[k] = state->scan[k - 1];
+      k--;
+    }
+    state->scan[k] = result;
+  }
+}
+
+/**
+ * Checks whether a network is worth a searching join
+ *
+ * Searching keeps the radio on for the whole deadline when the network
+ * is not there, so it is kept for networks that may be up without being
+ * seen: those the fresh scan found but could not be joined directly,
+ * those last joined while hidden, and those never joined, which may be
+ * hidden. A network joined before and missing from the scan is down.
+ */
+static bool Network_Searchable(const NETWORK_STATE *state, const NETWORK_CREDENTIAL *credential)
+{
+  uint32_t hash = Network_HashSsid(credential->ssid);
+  const NETWORK_HISTORY *history = Network_FindHistory(state, hash);
+  return Network_InScan(state, hash) || history == NULL || history->rssiAverage == NETWORK_RSSI_UNKNOWN ||
+         history->hidden;
+}
+
+/**
+ * Connects to the best available known network
+ *
+ * 1. Joins the best candidates from the cached scan and history directly.
+ * 2. If none connects, scans, updates the cache and joins the networks
+ *    the scan found, best first.
+ * 3. Finally joins the networks not joined that way yet without a BSSID,
+ *    letting the station search for them, if they may be up without
+ *    being seen (see Network_Searchable). They share searchTimeoutMs.
+ *
+ * Every join is cut short at totalTimeoutMs from the start, and no step
+ * starts after it.
+ *
+ * @param state Selection state kept in RTC memory
+ * @param credentials Known networks
+ * @param count Number of known networks
+ * @param driver Radio operations
+ * @param directTimeoutMs Deadline for each direct join
+ * @param searchTimeoutMs Deadline shared by the joins without a known access point
+ * @param totalTimeoutMs Deadline of the whole connection
+ * @return Index of the connected credential, or -1
+ */
+int Network_Connect(NETWORK_STATE *state, const NETWORK_CREDENTIAL *credentials, int count,
+                    const NETWORK_DRIVER *driver, uint32_t directTimeoutMs, uint32_t searchTimeoutMs,
+                    uint32_t totalTimeoutMs)
+{
+  Network_InitState(state);
+  if (count > NETWORK_MAX_CREDENTIALS) {
+    count = NETWORK_MAX_CREDENTIALS;
+  }
+
+  uint32_t deadlineMs = driver->millis(driver->context) + totalTimeoutMs;
+  uint32_t searched = 0;
+
+  // Cached Ranking
+  int connected = Network_TryRanked(state, credentials, count, driver, directTimeoutMs, &searched, false, deadlineMs);
+  if (connected >= 0 || Network_Remaining(driver, deadlineMs) == 0) {
+    return connected;
+  }
+
+  // Fresh Scan
+  Network_Scan(state, credentials, count, driver);
+  connected = Network_TryRanked(state, credentials, count, driver, directTimeoutMs, &searched, true, deadlineMs);
+  if (connected >= 0) {
+    return connected;
+  }
+
+  // Networks That May Be Up Without Being Seen, Sharing One Deadline
+  int pending = 0;
+  for (int i = 0; i < count; i++) {
+    if ((searched & (1UL << i)) == 0 && Network_Searchable(state, &credentials[i])) {
+      pending++;
+    } else {
+      searched |= 1UL << i;
+    }
+  }
+  uint32_t searchLeft = searchTimeoutMs;
+  for (int i = 0; i < count && pending > 0; i++) {
+    if ((searched & (1UL << i)) != 0) {
+      continue;
+    }
+    uint32_t left = Network_Remaining(driver, deadlineMs);
+    uint32_t timeoutMs = searchLeft / pending < left ? searchLeft / pending : left;
+    if (timeoutMs == 0) {
+      break;
+    }
+    pending--;
+    searchLeft -= timeoutMs;
+    if (Network_Try(state, &credentials[i], driver, NULL, 0, timeoutMs)) {
+      return i;
+    }
+  }
+  return -1;
+}
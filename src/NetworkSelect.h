@@ -0,0 +1,96 @@
+#ifndef _NETWORK_SELECT_H_
+#define _NETWORK_SELECT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Selection among several known Wi-Fi networks
+ *
+ * Known networks are ranked from the access points of the last scan and
+ * from the signal history of earlier connections, both kept in RTC
+ * memory by the caller. The best candidates are joined directly by BSSID
+ * and channel, each with a short deadline, and a new scan is made only
+ * when none of them connects. Searching joins, which keep the radio on
+ * the longest, are kept for networks that may be there without being
+ * seen, and the whole connection has one deadline.
+ *
+ * The radio is reached through NETWORK_DRIVER, so the selection has no
+ * Arduino dependency and can be driven by a scripted driver on the host.
+ */
+
+#define NETWORK_MAX_CREDENTIALS 8   // Known networks
+#define NETWORK_MAX_SCAN_RESULTS 8  // Access points kept from the last scan
+#define NETWORK_MAX_CANDIDATES 3    // Direct joins tried before scanning
+#define NETWORK_SSID_SIZE 33        // 32 characters and a terminator
+#define NETWORK_PASSWORD_SIZE 65    // 64 characters and a terminator
+#define NETWORK_RSSI_UNKNOWN -128
+
+typedef struct
+{
+  char ssid[NETWORK_SSID_SIZE];
+  char password[NETWORK_PASSWORD_SIZE];
+} NETWORK_CREDENTIAL;
+
+typedef struct
+{
+  uint32_t ssidHash;  // Network_HashSsid() of the SSID
+  int8_t rssi;        // Signal strength in dBm
+  uint8_t channel;    // Primary channel
+  uint8_t bssid[6];   // Access point
+} NETWORK_SCAN_RESULT;
+
+typedef struct
+{
+  uint32_t ssidHash;  // 0 if the slot is free
+  int8_t rssiAverage; // Smoothed signal of past connections, or NETWORK_RSSI_UNKNOWN
+  uint8_t failures;   // Consecutive failed attempts
+  uint8_t channel;    // Access point of the last connection
+  uint8_t bssid[6];
+  uint8_t hidden;     // Last joined by searching while missing from the scan
+} NETWORK_HISTORY;
+
+typedef struct
+{
+  uint32_t magic;     // Set by Network_InitState
+  uint8_t scanCount;
+  NETWORK_SCAN_RESULT scan[NETWORK_MAX_SCAN_RESULTS];  // Known networks only, strongest first
+  NETWORK_HISTORY history[NETWORK_MAX_CREDENTIALS];
+} NETWORK_STATE;
+
+typedef struct
+{
+  uint8_t credential; // Index into the credential list
+  int16_t score;      // Higher is better
+  uint8_t channel;    // 0 if the access point is unknown
+  uint8_t bssid[6];   // Valid if channel is not 0
+} NETWORK_CANDIDATE;
+
+/**
+ * Radio operations used by the selection
+ */
+typedef struct
+{
+  void *context;
+  // Joins a network, directly if channel is not 0; true once an IP address is assigned
+  bool (*connect)(void *context, const NETWORK_CREDENTIAL *credential, const uint8_t *bssid, uint8_t channel,
+                  uint32_t timeoutMs);
+  // Scans and returns the number of access points found
+  int (*scan)(void *context);
+  // Returns one access point of the last scan
+  bool (*scanResult)(void *context, int index, NETWORK_SCAN_RESULT *result);
+  // Signal strength and access point of the current connection
+  void (*status)(void *context, int8_t *rssi, uint8_t *bssid, uint8_t *channel);
+  // Milliseconds since any fixed point, for the deadline
+  uint32_t (*millis)(void *context);
+} NETWORK_DRIVER;
+
+uint32_t Network_HashSsid(const char *ssid);
+void Network_InitState(NETWORK_STATE *state);
+int Network_Rank(const NETWORK_STATE *state, const NETWORK_CREDENTIAL *credentials, int count,
+                 NETWORK_CANDIDATE *candidates);
+int Network_Connect(NETWORK_STATE *state, const NETWORK_CREDENTIAL *credentials, int count,
+                    const NETWORK_DRIVER *driver, uint32_t directTimeoutMs, uint32_t searchTimeoutMs,
+                    uint32_t totalTimeoutMs);
+
+#endif
@@ -0,0 +1,431 @@
+#include "Pipeline.h"
+#include <string.h>
+#include <new>
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+#define PIPE_TASK_PRIORITY 1  // Same as the Arduino loop task
+
+/**
+ * Stage as started by Pipe_Run
+ */
+struct PipeTask {
+  PipeStage* stage;
+  int64_t originUs;
+#ifdef ARDUINO
+  SemaphoreHandle_t done;
+#endif
+};
+
+#ifdef ARDUINO
+
+struct PipeQueue {
+  QueueHandle_t handle;
+};
+
+static int64_t Pipe_Micros() {
+  return esp_timer_get_time();
+}
+
+static TickType_t Pipe_Ticks(uint32_t timeoutMs) {
+  return timeoutMs == PIPE_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+}
+
+#else
+
+struct PipeQueue {
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  std::vector<uint8_t> storage;
+  size_t itemSize;
+  size_t depth;
+  size_t head;   // Index of the oldest item
+  size_t count;  // Items in the queue
+};
+
+static int64_t Pipe_Micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Waits on a condition with the timeout semantics of the FreeRTOS queue
+ */
+template <typename Predicate>
+static bool Pipe_Wait(std::condition_variable& condition, std::unique_lock<std::mutex>& lock,
+                      uint32_t timeoutMs, Predicate ready) {
+  if (timeoutMs == PIPE_WAIT_FOREVER) {
+    condition.wait(lock, ready);
+    return true;
+  }
+  return condition.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+}
+
+#endif
+
+/**
+ * Creates a bounded queue
+ *
+ * @param itemSize Size of one item in bytes; items are copied in and out
+ * @param depth Number of items the queue holds before senders block
+ * @return Queue, or NULL if out of memory
+ */
+PipeQueue* Pipe_CreateQueue(size_t itemSize, size_t depth) {
+  if (itemSize == 0 || depth == 0) {
+    return NULL;
+  }
+
+#ifdef ARDUINO
+  PipeQueue* queue = new (std::nothrow) PipeQueue;
+  if (queue == NULL) {
+    return NULL;
+  }
+  queue->handle = xQueueCreate(depth, itemSize);
+  if (queue->handle == NULL) {
+    delete queue;
+    return NULL;
+  }
+#else
+  PipeQueue* queue = new PipeQueue;
+  queue->storage.resize(itemSize * depth);
+  queue->itemSize = itemSize;
+  queue->depth = depth;
+  queue->head = 0;
+  queue->count = 0;
+#endif
+  return queue;
+}
+
+/**
+ * Deletes a queue that no stage uses any more
+ *
+ * @param queue Queue to delete, may be NULL
+ */
+void Pipe_DeleteQueue(PipeQueue* queue) {
+  if (queue == NULL) {
+    return;
+  }
+#ifdef ARDUINO
+  vQueueDelete(queue->handle);
+#endif
+  delete queue;
+}
+
+/**
+ * Copies an item to the back of a queue, waiting while it is full
+ */
+static bool Pipe_SendItem(PipeQueue* queue, const void* item, uint32_t timeoutMs) {
+#ifdef ARDUINO
+  return xQueueSend(queue->handle, item, Pipe_Ticks(timeoutMs)) == pdTRUE;
+#else
+  bool sent;
+  {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    sent = Pipe_Wait(queue->notFull, lock, timeoutMs, [queue] { return queue->count < queue->depth; });
+    if (sent) {
+      size_t tail = (queue->head + queue->count) % queue->depth;
+      memcpy(&queue->storage[tail * queue->itemSize], item, queue->itemSize);
+      queue->count++;
+    }
+  }
+  if (sent) {
+    queue->notEmpty.notify_one();
+  }
+  return sent;
+#endif
+}
+
+/**
+ * Copies the item at the front of a queue out of it, waiting while it is empty
+ */
+static bool Pipe_ReceiveItem(PipeQueue* queue, void* item, uint32_t timeoutMs) {
+#ifdef ARDUINO
+  return xQueueReceive(queue->handle, item, Pipe_Ticks(timeoutMs)) == pdTRUE;
+#else
+  bool received;
+  {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    received = Pipe_Wait(queue->notEmpty, lock, timeoutMs, [queue] { return queue->count > 0; });
+    if (received) {
+      memcpy(item, &queue->storage[queue->head * queue->itemSize], queue->itemSize);
+      queue->head = (queue->head + 1) % queue->depth;
+      queue->count--;
+    }
+  }
+  if (received) {
+    queue->notFull.notify_one();
+  }
+  return received;
+#endif
+}
+
+/**
+ * Tells a stage's wait hook that it starts or stops waiting
+ */
+static void Pipe_StageWaiting(PipeStage* stage, bool waiting) {
+  if (stage != NULL && stage->waitHook != NULL) {
+    stage->waitHook(stage, waiting);
+  }
+}
+
+/**
+ * Copies an item to the back of a queue, waiting while it is full
+ *
+ * @param queue Queue to send to
+ * @param item Item of the queue's item size
+ * @param timeoutMs Longest wait, or PIPE_WAIT_FOREVER
+ * @param stage Stage charged with the waiting time, may be NULL
+ * @return false if the queue stayed full
+ */
+bool Pipe_Send(PipeQueue* queue, const void* item, uint32_t timeoutMs, PipeStage* stage) {
+  int64_t start = Pipe_Micros();
+  bool sent = Pipe_SendItem(queue, item, 0);
+  if (!sent && timeoutMs != 0) {
+    Pipe_StageWaiting(stage, true);
+    sent = Pipe_SendItem(queue, item, timeoutMs);
+    Pipe_StageWaiting(stage, false);
+  }
+  if (stage != NULL) {
+    stage->waitUs += (uint32_t)(Pipe_Micros() - start);
+  }
+  return sent;
+}
+
+/**
+ * Copies the item at the front of a queue out of it, waiting while it is empty
+ *
+ * @param queue Queue to receive from
+ * @param item Receives the item
+ * @param timeoutMs Longest wait, or PIPE_WAIT_FOREVER
+ * @param stage Stage charged with the waiting time, may be NULL
+ * @return false if the queue stayed empty
+ */
+bool Pipe_Receive(PipeQueue* queue, void* item, uint32_t timeoutMs, PipeStage* stage) {
+  int64_t start = Pipe_Micros();
+  bool received = Pipe_ReceiveItem(queue, item, 0);
+  if (!received && timeoutMs != 0) {
+    Pipe_StageWaiting(stage, true);
+    received = Pipe_ReceiveItem(queue, item, timeoutMs);
+    Pipe_StageWaiting(stage, false);
+  }
+  if (stage != NULL) {
+    stage->waitUs += (uint32_t)(Pipe_Micros() - start);
+  }
+  return received;
+}
+
+/**
+ * Runs one stage and records its timings
+ */
+static void Pipe_RunStage(PipeTask* task) {
+  PipeStage* stage = task->stage;
+  stage->startUs = (uint32_t)(Pipe_Micros() - task->originUs);
+  stage->run(stage);
+  stage->endUs = (uint32_t)(Pipe_Micros() - task->originUs);
+}
+
+#ifdef ARDUINO
+
+static void Pipe_TaskMain(void* parameter) {
+  PipeTask* task = (PipeTask*)parameter;
+  Pipe_RunStage(task);
+  xSemaphoreGive(task->done);
+  vTaskDelete(NULL);
+}
+
+/**
+ * Runs stages concurrently and waits until all of them have returned
+ *
+ * Each stage becomes a task pinned to its core. If a task cannot be
+ * created, the stages already started are still waited for; they see
+ * their queues time out.
+ *
+ * @param stages Stages to run, timings are filled in
+ * @param count Number of stages, at most PIPE_MAX_STAGES
+ * @return true if every stage ran
+ */
+bool Pipe_Run(PipeStage* stages, int count) {
+  PipeTask tasks[PIPE_MAX_STAGES];
+  if (count <= 0 || count > PIPE_MAX_STAGES) {
+    return false;
+  }
+
+  SemaphoreHandle_t done = xSemaphoreCreateCounting(count, 0);
+  if (done == NULL) {
+    return false;
+  }
+
+  int64_t origin = Pipe_Micros();
+  int started = 0;
+  for (int i = 0; i < count; i++) {
+    stages[i].startUs = stages[i].endUs = stages[i].waitUs = 0;
+    tasks[i].stage = &stages[i];
+    tasks[i].originUs = origin;
+    tasks[i].done = done;
+    if (xTaskCreatePinnedToCore(Pipe_TaskMain, stages[i].name, stages[i].stackSize, &tasks[i],
+                                PIPE_TASK_PRIORITY, NULL, stages[i].core) != pdPASS) {
+      break;
+    }
+    started++;
+  }
+
+  for (int i = 0; i < started; i++) {
+    xSemaphoreTake(done, portMAX_DELAY);
+  }
+  vSemaphoreDelete(done);
+  return started == count;
+}
+
+#else
+
+/**
+ * Runs stages concurrently and waits until all of them have returned
+ *
+ * Each stage becomes a std::thread; the core and stack size are ignored.
+ *
+ * @param stages Stages to run, timings are filled in
+ * @param count Number of stages, at most PIPE_MAX_STAGES
+ * @return true if every stage ran
+ */
+bool Pipe_Run(PipeStage* stages, int count) {
+  PipeTask tasks[PIPE_MAX_STAGES];
+  std::thread threads[PIPE_MAX_STAGES];
+  if (count <= 0 || count > PIPE_MAX_STAGES) {
+    return false;
+  }
+
+  int64_t origin = Pipe_Micros();
+  for (int i = 0; i < count; i++) {
+    stages[i].startUs = stages[i].endUs = stages[i].waitUs = 0;
+    tasks[i].stage = &stages[i];
+    tasks[i].originUs = origin;
+    threads[i] = std::thread(Pipe_RunStage, &tasks[i]);
+  }
+  for (int i = 0; i < count; i++) {
+    threads[i].join();
+  }
+  return true;
+}
+
+#endif
+
+/**
+ * Receives the next chunk
+ *
+ * @return false at the end of the stream, or if no chunk arrived in time
+ */
+bool PipeReader::fill() {
+  if (ended) {
+    return false;
+  }
+  if (!Pipe_Receive(queue, &chunk, timeoutMs, stage) || chunk.length == 0) {
+    ended = true;
+    chunk.length = 0;
+    position = 0;
+    return false;
+  }
+  position = 0;
+  return true;
+}
+
+/**
+ * Reads one byte
+ *
+ * @return Byte value, or -1 at the end of the stream
+ */
+int PipeReader::read() {
+  if (position >= chunk.length && !fill()) {
+    return -1;
+  }
+  return chunk.data[position++];
+}
+
+/**
+ * Returns the next byte without consuming it
+ *
+ * @return Byte value, or -1 at the end of the stream
+ */
+int PipeReader::peek() {
+  if (position >= chunk.length && !fill()) {
+    return -1;
+  }
+  return chunk.data[position];
+}
+
+/**
+ * Reads up to count bytes
+ *
+ * @param out Output buffer
+ * @param count Bytes to read
+ * @return Bytes read, less than count only at the end of the stream
+ */
+size_t PipeReader::readBytes(char* out, size_t count) {
+  size_t copied = 0;
+  while (copied < count) {
+    if (position >= chunk.length && !fill()) {
+      break;
+    }
+    size_t length = chunk.length - position;
+    if (length > count - copied) {
+      length = count - copied;
+    }
+    memcpy(out + copied, chunk.data + position, length);
+    position += length;
+    copied += length;
+  }
+  return copied;
+}
+
+/**
+ * Skips past the next occurrence of a pattern
+ *
+ * @param pattern Bytes to look for
+ * @return true if the pattern was found, false at the end of the stream
+ */
+bool PipeReader::find(const char* pattern) {
+  size_t length = strlen(pattern);
+  size_t matched = 0;
+
+  while (matched < length) {
+    int c = read();
+    if (c < 0) {
+      return false;
+    }
+    if (c == pattern[matched]) {
+      matched++;
+      continue;
+    }
+
+    // Fall back to the longest prefix of the pattern that ends with this byte
+    size_t next = 0;
+    for (size_t k = matched; k > 0; k--) {
+      if (pattern[k - 1] == c && memcmp(pattern, pattern + matched - k + 1, k - 1) == 0) {
+        next = k;
+        break;
+      }
+    }
+    matched = next;
+  }
+  return true;
+}
+
+/**
+ * Discards the rest of the stream, so the sending stage is never left blocked
+ */
+void PipeReader::drain() {
+  while (fill()) {
+  }
+}
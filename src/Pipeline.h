@@ -0,0 +1,86 @@
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Concurrent stages connected by bounded queues
+ *
+ * Each stage runs in its own task and passes fixed-size items to the
+ * next one through a queue; a full queue blocks the sender, so a slow
+ * stage throttles the ones before it instead of buffering without limit.
+ * On the device stages are FreeRTOS tasks pinned to a core; on the host
+ * they are std::threads and the core is ignored, so the same stage
+ * layout can be exercised without hardware.
+ *
+ * Every queue operation takes a timeout, and stages are expected to send
+ * an end marker downstream and drain their input when they stop early,
+ * so no stage is left waiting on one that has given up.
+ */
+
+#define PIPE_MAX_STAGES 8
+#define PIPE_WAIT_FOREVER UINT32_MAX
+#define PIPE_CHUNK_SIZE 512  // Bytes per chunk of a byte stream
+
+struct PipeQueue;
+
+struct PipeStage {
+  const char* name;
+  void (*run)(PipeStage* stage);  // Stage body, returns when the stage is done
+  void* context;                  // Passed to run through the stage
+  int core;                       // Core to run on (device only)
+  uint32_t stackSize;             // Task stack in bytes (device only)
+
+  // Filled by Pipe_Run, in microseconds from its start
+  uint32_t startUs;
+  uint32_t endUs;
+  uint32_t waitUs;                // Time blocked on queues
+
+  // Called with true before and false after each blocking queue wait,
+  // e.g. to lower the clock while the stage waits; may be NULL
+  void (*waitHook)(PipeStage* stage, bool waiting);
+};
+
+/**
+ * One chunk of a byte stream passed between stages
+ */
+struct PipeChunk {
+  uint16_t length;                // Bytes in data, 0 at the end of the stream
+  uint8_t data[PIPE_CHUNK_SIZE];
+};
+
+/**
+ * Reader over a queue of PipeChunk
+ * Has the read()/readBytes() interface ArduinoJson expects from a stream.
+ */
+struct PipeReader {
+  PipeQueue* queue;
+  PipeStage* stage;               // Stage charged with the waiting time
+  uint32_t timeoutMs;             // Longest wait for the next chunk
+  PipeChunk chunk;
+  size_t position;
+  bool ended;
+
+  PipeReader(PipeQueue* queue, PipeStage* stage, uint32_t timeoutMs)
+    : queue(queue), stage(stage), timeoutMs(timeoutMs), position(0), ended(false) {
+    chunk.length = 0;
+  }
+
+  int read();
+  int peek();
+  size_t readBytes(char* out, size_t count);
+  bool find(const char* pattern);
+  void drain();
+
+ private:
+  bool fill();
+};
+
+PipeQueue* Pipe_CreateQueue(size_t itemSize, size_t depth);
+void Pipe_DeleteQueue(PipeQueue* queue);
+bool Pipe_Send(PipeQueue* queue, const void* item, uint32_t timeoutMs, PipeStage* stage);
+bool Pipe_Receive(PipeQueue* queue, void* item, uint32_t timeoutMs, PipeStage* stage);
+bool Pipe_Run(PipeStage* stages, int count);
+
+#endif
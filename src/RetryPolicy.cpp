@@ -0,0 +1,213 @@
+#include "RetryPolicy.h"
+#include <string.h>
+
+#define RETRY_STATE_MAGIC 0x52545931  // "RTY1"
+
+/**
+ * Prepares the state unless it already holds valid data
+ *
+ * @param state State kept in RTC memory
+ * @param seed Seed of the jitter generator (e.g., a hardware random number)
+ */
+void Retry_Init(RetryState* state, uint32_t seed) {
+  if (state->magic != RETRY_STATE_MAGIC) {
+    memset(state, 0, sizeof(*state));
+    state->random = seed != 0 ? seed : 0x9E3779B9UL;
+    state->magic = RETRY_STATE_MAGIC;
+  }
+}
+
+/**
+ * Classifies the result of an update attempt
+ *
+ * @param code HTTP status code, a negative HTTPClient error, or RETRY_CODE_*
+ * @return RetryErrorClass
+ */
+uint8_t Retry_Classify(int code) {
+  switch (code) {
+    case 200:
+      return RETRY_NONE;
+    case 400:  // Bad request parameters
+    case 401:  // Invalid API key
+    case 404:  // Unknown location
+      return RETRY_FATAL;
+    case 429:
+      return RETRY_RATE_LIMITED;
+    default:
+      return RETRY_TRANSIENT;
+  }
+}
+
+/**
+ * Next value of the xorshift32 jitter generator
+ */
+static uint32_t Retry_Random(RetryState* state) {
+  uint32_t x = state->random;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  state->random = x;
+  return x;
+}
+
+/**
+ * Records a failed attempt and schedules the next one
+ *
+ * The backoff doubles from baseSeconds up to maxSeconds, and the delay is
+ * drawn uniformly from its upper half ("equal jitter"). A Retry-After
+ * value replaces the backoff, plus up to 10% jitter.
+ *
+ * @param state Retry state
+ * @param config Backoff bounds
+ * @param code Result of the attempt, as for Retry_Classify
+ * @param retryAfterSeconds Retry-After of the response, or -1 if absent
+ * @return Error class and delay until the next attempt
+ */
+RetryDecision Retry_OnFailure(RetryState* state, const RetryConfig* config, int code, int32_t retryAfterSeconds) {
+  RetryDecision decision;
+  decision.errorClass = Retry_Classify(code);
+  decision.delaySeconds = 0;
+
+  if (state->attempts < UINT16_MAX) {
+    state->attempts++;
+  }
+  state->lastClass = decision.errorClass;
+  state->lastCode = (int16_t)code;
+
+  if (decision.errorClass == RETRY_FATAL || decision.errorClass == RETRY_NONE) {
+    return decision;
+  }
+
+  if (decision.errorClass == RETRY_RATE_LIMITED && retryAfterSeconds >= 0) {
+    uint32_t wait = retryAfterSeconds < RETRY_AFTER_LIMIT ? (uint32_t)retryAfterSeconds : RETRY_AFTER_LIMIT;
+    uint32_t spread = wait / 10 + 1;
+    decision.delaySeconds = wait + Retry_Random(state) % spread;
+    return decision;
+  }
+
+  uint32_t backoff = config->baseSeconds;
+  for (uint16_t i = 1; i < state->attempts && backoff < config->maxSeconds; i++) {
+    backoff *= 2;
+  }
+  if (backoff > config->maxSeconds) {
+    backoff = config->maxSeconds;
+  }
+
+  uint32_t half = backoff / 2;
+  decision.delaySeconds = backoff - half + Retry_Random(state) % (half + 1);
+  return decision;
+}
+
+/**
+ * Clears the failure count after a successful attempt
+ *
+ * @param state Retry state
+ */
+void Retry_OnSuccess(RetryState* state) {
+  state->attempts = 0;
+  state->lastClass = RETRY_NONE;
+  state->lastCode = 0;
+}
+
+/**
+ * Days since 1970-01-01 of a proleptic Gregorian date
+ */
+static int32_t Retry_DaysFromCivil(int32_t year, int32_t month, int32_t day) {
+  year -= month <= 2;
+  int32_t era = (year >= 0 ? year : year - 399) / 400;
+  int32_t yearOfEra = year - era * 400;
+  int32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  int32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * Reads a fixed number of decimal digits
+ */
+static bool Retry_ReadDigits(const char* text, int count, int32_t* value) {
+  *value = 0;
+  for (int i = 0; i < count; i++) {
+    if (text[i] < '0' || text[i] > '9') {
+      return false;
+    }
+    *value = *value * 10 + (text[i] - '0');
+  }
+  return true;
+}
+
+/**
+ * Parses an HTTP-date in the IMF-fixdate form
+ *
+ * @param value Date, e.g., "Sun, 06 Nov 1994 08:49:37 GMT"; may be NULL
+ * @return Unix timestamp (UTC), or -1 if the value is absent or invalid
+ */
+int32_t Retry_ParseHttpDate(const char* value) {
+  static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+  if (value == NULL) {
+    return -1;
+  }
+  while (*value == ' ') {
+    value++;
+  }
+
+  // IMF-fixdate: "Www, DD Mmm YYYY HH:MM:SS GMT"
+  if (strlen(value) < 29 || value[3] != ',' || strncmp(value + 26, "GMT", 3) != 0) {
+    return -1;
+  }
+  int32_t day, year, hour, minute, second;
+  if (!Retry_ReadDigits(value + 5, 2, &day) || !Retry_ReadDigits(value + 12, 4, &year) ||
+      !Retry_ReadDigits(value + 17, 2, &hour) || !Retry_ReadDigits(value + 20, 2, &minute) ||
+      !Retry_ReadDigits(value + 23, 2, &second)) {
+    return -1;
+  }
+  int32_t month = 0;
+  while (month < 12 && strncmp(value + 8, MONTHS + month * 3, 3) != 0) {
+    month++;
+  }
+  if (month == 12) {
+    return -1;
+  }
+
+  return Retry_DaysFromCivil(year, month + 1, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+/**
+ * Parses a Retry-After header value
+ *
+ * Accepts delay-seconds ("120") and the IMF-fixdate form of HTTP-date
+ * ("Sun, 06 Nov 1994 08:49:37 GMT"). A date needs the current time; until
+ * the clock has been synced it is ignored, as the time since boot would
+ * put every date years ahead.
+ *
+ * @param value Header value, may be NULL or empty
+ * @param now Current time (UTC), used for dates; 0 if not known yet
+ * @return Seconds to wait, or -1 if the value is absent, invalid, or a
+ *         date while the time is not known
+ */
+int32_t Retry_ParseRetryAfter(const char* value, int32_t now) {
+  if (value == NULL) {
+    return -1;
+  }
+  while (*value == ' ') {
+    value++;
+  }
+
+  // delay-seconds
+  if (*value >= '0' && *value <= '9') {
+    int32_t seconds = 0;
+    while (*value >= '0' && *value <= '9') {
+      if (seconds > RETRY_AFTER_LIMIT) {
+        return RETRY_AFTER_LIMIT;
+      }
+      seconds = seconds * 10 + (*value++ - '0');
+    }
+    return seconds;
+  }
+
+  int32_t date = Retry_ParseHttpDate(value);
+  if (date < 0 || now <= 0) {
+    return -1;
+  }
+  return date > now ? date - now : 0;
+}
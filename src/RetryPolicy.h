@@ -0,0 +1,63 @@
+#ifndef _RETRY_POLICY_H_
+#define _RETRY_POLICY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Retry schedule for failed forecast updates
+ *
+ * Failures are classified from the HTTP status code. Fatal errors are
+ * configuration problems that retrying cannot fix; all others are retried
+ * after a delay that doubles with every consecutive failure, with random
+ * jitter so that devices failing together do not retry together. A
+ * Retry-After header on 429 takes precedence over the backoff.
+ *
+ * The state is small enough for RTC memory, so the device deep-sleeps
+ * between attempts. Time is always passed in, so the schedule can be run
+ * against a simulated clock on the host.
+ */
+
+// Codes for failures that have no HTTP status code
+#define RETRY_CODE_NO_NETWORK -100    // Wi-Fi connection failed
+#define RETRY_CODE_BAD_RESPONSE -101  // Response could not be parsed
+
+#define RETRY_AFTER_LIMIT 86400       // Longest Retry-After honoured (seconds)
+
+enum RetryErrorClass {
+  RETRY_NONE = 0,       // Success
+  RETRY_TRANSIENT,      // Network and server errors
+  RETRY_RATE_LIMITED,   // 429 Too Many Requests
+  RETRY_FATAL           // Configuration errors (400, 401, 404)
+};
+
+struct RetryConfig {
+  uint32_t baseSeconds;  // Delay after the first failure
+  uint32_t maxSeconds;   // Upper bound of the backoff
+};
+
+/**
+ * Retry state kept across deep sleep
+ */
+struct RetryState {
+  uint32_t magic;        // Valid when set by Retry_Init
+  uint16_t attempts;     // Consecutive failures
+  uint8_t lastClass;     // RetryErrorClass of the last failure
+  uint8_t reserved;
+  int16_t lastCode;      // Status code of the last failure
+  uint32_t random;       // Jitter generator state, never 0
+};
+
+struct RetryDecision {
+  uint8_t errorClass;    // RetryErrorClass
+  uint32_t delaySeconds; // Time until the next attempt, 0 if the error is fatal
+};
+
+void Retry_Init(RetryState* state, uint32_t seed);
+uint8_t Retry_Classify(int code);
+RetryDecision Retry_OnFailure(RetryState* state, const RetryConfig* config, int code, int32_t retryAfterSeconds);
+void Retry_OnSuccess(RetryState* state);
+int32_t Retry_ParseHttpDate(const char* value);
+int32_t Retry_ParseRetryAfter(const char* value, int32_t now);
+
+#endif
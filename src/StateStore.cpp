@@ -0,0 +1,260 @@
+#include "StateStore.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Preferences.h>
+#include <esp_rom_crc.h>
+#else
+#include <stdio.h>
+#endif
+
+#define STATE_STORE_MAGIC 0x53545331  // "STS1"
+#define STATE_MIRROR_SUFFIX "~"       // Key suffix of a mirror's header
+
+/**
+ * Header of a mirrored record in the backend, kept under the record's
+ * name with STATE_MIRROR_SUFFIX
+ */
+struct StateMirrorHeader {
+  uint16_t version;
+  uint16_t size;
+  uint32_t crc;                       // CRC-32 of the data
+};
+
+/**
+ * CRC-32 (IEEE 802.3), continued from a previous value
+ *
+ * @param crc 0 to start, or the CRC of the preceding bytes
+ * @param data Bytes to add
+ * @param size Number of bytes
+ * @return CRC of all bytes so far
+ */
+uint32_t StateStore_Crc32(uint32_t crc, const void* data, size_t size) {
+#ifdef ARDUINO
+  return esp_rom_crc32_le(crc, (const uint8_t*)data, size);
+#else
+  // Half-byte table, small enough to stay in cache
+  static const uint32_t TABLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  const uint8_t* bytes = (const uint8_t*)data;
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= bytes[i];
+    crc = (crc >> 4) ^ TABLE[crc & 15];
+    crc = (crc >> 4) ^ TABLE[crc & 15];
+  }
+  return ~crc;
+#endif
+}
+
+static uint32_t StateStore_HeaderCrc(const StateStore* store) {
+  return StateStore_Crc32(0, store, offsetof(StateStore, headerCrc));
+}
+
+/**
+ * Hash of the names, versions and sizes of the records
+ */
+static uint32_t StateStore_Layout(const StateRecord* records, int count) {
+  uint32_t layout = StateStore_Crc32(0, &count, sizeof(count));
+  for (int i = 0; i < count; i++) {
+    layout = StateStore_Crc32(layout, records[i].name, strlen(records[i].name) + 1);
+    layout = StateStore_Crc32(layout, &records[i].version, sizeof(records[i].version));
+    layout = StateStore_Crc32(layout, &records[i].size, sizeof(records[i].size));
+  }
+  return layout;
+}
+
+static void StateStore_MirrorKey(char* key, const char* name) {
+  strncpy(key, name, STATE_STORE_MAX_NAME);
+  key[STATE_STORE_MAX_NAME] = '\0';
+  strcat(key, STATE_MIRROR_SUFFIX);
+}
+
+/**
+ * Restores a record from the backend
+ *
+ * @return false, with the record cleared, when the copy is missing or
+ *         does not match the record's version, size or CRC
+ */
+static bool StateStore_ReadMirror(const StateRecord* record, const StateBackend* backend) {
+  char key[STATE_STORE_MAX_NAME + sizeof(STATE_MIRROR_SUFFIX)];
+  StateMirrorHeader header;
+  StateStore_MirrorKey(key, record->name);
+
+  if (backend->read(backend->context, key, &header, sizeof(header)) && header.version == record->version &&
+      header.size == record->size && backend->read(backend->context, record->name, record->data, record->size) &&
+      StateStore_Crc32(0, record->data, record->size) == header.crc) {
+    return true;
+  }
+  memset(record->data, 0, record->size);
+  return false;
+}
+
+/**
+ * Copies a record to the backend, the data first so that an interrupted
+ * write leaves a header that does not match
+ */
+static bool StateStore_WriteMirror(const StateRecord* record, const StateBackend* backend, uint32_t crc) {
+  char key[STATE_STORE_MAX_NAME + sizeof(STATE_MIRROR_SUFFIX)];
+  StateMirrorHeader header = {record->version, record->size, crc};
+  StateStore_MirrorKey(key, record->name);
+
+  return backend->write(backend->context, record->name, record->data, record->size) &&
+         backend->write(backend->context, key, &header, sizeof(header));
+}
+
+/**
+ * Checks the records after a boot
+ *
+ * Call before anything reads the records. Damaged records are cleared
+ * to zeros, and restored from the backend when mirrored.
+ *
+ * @param store Header kept in RTC memory
+ * @param records Record table, the same order on every boot
+ * @param count Number of records, up to STATE_STORE_MAX_RECORDS
+ * @param buildId Identifies the firmware build
+ * @param coldStart The reset did not preserve RTC memory
+ * @param backend Storage of the mirrored records, may be NULL
+ * @return What was kept, cleared and restored
+ */
+StateLoadResult StateStore_Load(StateStore* store, const StateRecord* records, int count, uint32_t buildId,
+                                bool coldStart, const StateBackend* backend) {
+  StateLoadResult result = {};
+  if (count > STATE_STORE_MAX_RECORDS) {
+    count = STATE_STORE_MAX_RECORDS;
+  }
+  uint32_t layout = StateStore_Layout(records, count);
+  result.warm = !coldStart && store->magic == STATE_STORE_MAGIC && store->headerCrc == StateStore_HeaderCrc(store) &&
+                store->buildId == buildId && store->layout == layout;
+
+  if (!result.warm) {
+    memset(store, 0, sizeof(*store));
+    store->magic = STATE_STORE_MAGIC;
+    store->buildId = buildId;
+    store->layout = layout;
+  }
+
+  for (int i = 0; i < count; i++) {
+    const StateRecord* record = &records[i];
+    if (result.warm && StateStore_Crc32(0, record->data, record->size) == store->crc[i]) {
+      result.kept++;
+      continue;
+    }
+
+    result.cleared++;
+    memset(record->data, 0, record->size);
+    if (record->mirrored && backend != NULL && StateStore_ReadMirror(record, backend)) {
+      result.restored++;
+      store->mirrorCrc[i] = StateStore_Crc32(0, record->data, record->size);
+    }
+  }
+
+  store->headerCrc = StateStore_HeaderCrc(store);
+  return result;
+}
+
+/**
+ * Records the state before deep sleep
+ *
+ * Mirrored records whose CRC changed since they were last copied are
+ * written to the backend.
+ *
+ * @param store Header kept in RTC memory
+ * @param records Record table given to StateStore_Load
+ * @param count Number of records
+ * @param backend Storage of the mirrored records, may be NULL
+ */
+void StateStore_Commit(StateStore* store, const StateRecord* records, int count, const StateBackend* backend) {
+  if (count > STATE_STORE_MAX_RECORDS) {
+    count = STATE_STORE_MAX_RECORDS;
+  }
+
+  for (int i = 0; i < count; i++) {
+    const StateRecord* record = &records[i];
+    uint32_t crc = StateStore_Crc32(0, record->data, record->size);
+    if (record->mirrored && backend != NULL && crc != store->mirrorCrc[i] &&
+        StateStore_WriteMirror(record, backend, crc)) {
+      store->mirrorCrc[i] = crc;
+    }
+    store->crc[i] = crc;
+  }
+
+  store->headerCrc = StateStore_HeaderCrc(store);
+}
+
+#ifdef ARDUINO
+static bool StateStore_NvsRead(void* context, const char* key, void* data, size_t size) {
+  Preferences prefs;
+  if (!prefs.begin((const char*)context, true)) {
+    return false;
+  }
+  bool read = prefs.getBytesLength(key) == size && prefs.getBytes(key, data, size) == size;
+  prefs.end();
+  return read;
+}
+
+static bool StateStore_NvsWrite(void* context, const char* key, const void* data, size_t size) {
+  Preferences prefs;
+  if (!prefs.begin((const char*)context, false)) {
+    return false;
+  }
+  bool written = prefs.putBytes(key, data, size) == size;
+  prefs.end();
+  return written;
+}
+
+/**
+ * Backend keeping each mirrored record as an NVS blob
+ *
+ * @param backend Backend to set up
+ * @param nvsNamespace NVS namespace of the records, must outlive the backend
+ */
+void StateStore_NvsBackend(StateBackend* backend, const char* nvsNamespace) {
+  backend->read = StateStore_NvsRead;
+  backend->write = StateStore_NvsWrite;
+  backend->context = (void*)nvsNamespace;
+}
+#else
+static void StateStore_FilePath(char* path, size_t size, void* context, const char* key) {
+  snprintf(path, size, "%s/%s.bin", (const char*)context, key);
+}
+
+static bool StateStore_FileRead(void* context, const char* key, void* data, size_t size) {
+  char path[256];
+  StateStore_FilePath(path, sizeof(path), context, key);
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    return false;
+  }
+  // One byte more than expected tells a longer file apart
+  uint8_t extra;
+  bool read = fread(data, 1, size, file) == size && fread(&extra, 1, 1, file) == 0;
+  fclose(file);
+  return read;
+}
+
+static bool StateStore_FileWrite(void* context, const char* key, const void* data, size_t size) {
+  char path[256];
+  StateStore_FilePath(path, sizeof(path), context, key);
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  bool written = fwrite(data, 1, size, file) == size;
+  return fclose(file) == 0 && written;
+}
+
+/**
+ * Backend keeping each mirrored record in a file, for host tools
+ *
+ * @param backend Backend to set up
+ * @param directory Existing directory of the files, must outlive the backend
+ */
+void StateStore_FileBackend(StateBackend* backend, const char* directory) {
+  backend->read = StateStore_FileRead;
+  backend->write = StateStore_FileWrite;
+  backend->context = (void*)directory;
+}
+#endif
@@ -0,0 +1,79 @@
+#ifndef _STATE_STORE_H_
+#define _STATE_STORE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Checked store of the state kept across deep sleep
+ *
+ * The records stay where the code uses them, in RTC memory; a table of
+ * StateRecord describes each one. Before deep sleep StateStore_Commit
+ * takes a CRC-32 of every record into a StateStore header, which has a
+ * CRC of its own. On the next boot StateStore_Load keeps each record
+ * whose CRC still matches and clears the others to zeros, which the
+ * modules treat as never initialized. Every record is cleared on a cold
+ * start: a damaged header, a reset that does not preserve RTC memory
+ * (power-on, brownout), another firmware build, or a change of the
+ * table, i.e. a record's name, version or size.
+ *
+ * Records marked mirrored are also copied to a StateBackend, NVS on the
+ * device or files on the host, whenever their CRC changes, and restored
+ * from it when cleared, so they survive a power loss. Loading reads each
+ * byte once and uses no heap.
+ */
+
+#define STATE_STORE_MAX_RECORDS 12
+#define STATE_STORE_MAX_NAME 13          // Longest record name, an NVS key with the mirror suffix
+
+/**
+ * Record kept across deep sleep
+ */
+struct StateRecord {
+  const char* name;                      // Unique, also the key of the mirror
+  uint16_t version;                      // Raised when the layout changes at the same size
+  uint16_t size;
+  void* data;                            // In RTC memory
+  bool mirrored;                         // Also kept in the backend
+};
+
+/**
+ * Persistent storage for mirrored records
+ */
+struct StateBackend {
+  bool (*read)(void* context, const char* key, void* data, size_t size);         // Exactly size bytes
+  bool (*write)(void* context, const char* key, const void* data, size_t size);
+  void* context;
+};
+
+/**
+ * Header kept in RTC memory
+ */
+struct StateStore {
+  uint32_t magic;
+  uint32_t buildId;                      // Firmware build that committed the records
+  uint32_t layout;                       // Hash of the record table
+  uint32_t crc[STATE_STORE_MAX_RECORDS]; // CRC-32 of each record at the last commit
+  uint32_t mirrorCrc[STATE_STORE_MAX_RECORDS];  // CRC-32 of each record in the backend
+  uint32_t headerCrc;                    // CRC-32 of the fields above
+};
+
+struct StateLoadResult {
+  bool warm;                             // The header was valid; cleared records were damaged
+  uint8_t kept;                          // Records kept from RTC memory
+  uint8_t cleared;                       // Records cleared
+  uint8_t restored;                      // Cleared records restored from the backend
+};
+
+uint32_t StateStore_Crc32(uint32_t crc, const void* data, size_t size);
+StateLoadResult StateStore_Load(StateStore* store, const StateRecord* records, int count, uint32_t buildId,
+                                bool coldStart, const StateBackend* backend);
+void StateStore_Commit(StateStore* store, const StateRecord* records, int count, const StateBackend* backend);
+
+#ifdef ARDUINO
+void StateStore_NvsBackend(StateBackend* backend, const char* nvsNamespace);
+#else
+void StateStore_FileBackend(StateBackend* backend, const char* directory);
+#endif
+
+#endif
@@ -0,0 +1,208 @@
+#include "TileRender.h"
+#include "EPD.h"
+#include <atomic>
+
+#ifndef ARDUINO
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#define TILE_STACK_SIZE 8192  // Worker task stack; custom images are decoded on it
+#define TILE_GAP_WIDTH 8      // Columns between the two driver ICs, skipped by Paint_SetPixel
+
+typedef struct
+{
+  TILE_DRAW draw;
+  void *context;
+  PAINT frame;              // Paint image of the caller
+  uint8_t tileCount;
+  std::atomic<int> next;    // Next tile to claim
+} TILE_JOB;
+
+/**
+ * Describes one tile of the current Paint image
+ *
+ * Tiles split the clip window into nearly equal runs of whole bytes.
+ *
+ * @param index Tile index
+ * @param tileCount Number of tiles
+ * @param tile Receives the tile
+ */
+void TileRender_GetTile(uint8_t index, uint8_t tileCount, TILE *tile)
+{
+  uint16_t span = Paint.clipEnd - Paint.clipStart;
+  tile->byteStart = Paint.clipStart + span * index / tileCount;
+  tile->byteEnd = Paint.clipStart + span * (index + 1) / tileCount;
+
+  if (Paint.rotate == 0) {
+    // Memory columns past the gap are drawn from x coordinates 8 lower
+    int start = tile->byteStart * 8 - TILE_GAP_WIDTH;
+    tile->xStart = start < 0 ? 0 : start;
+    tile->xEnd = tile->byteEnd * 8;
+  } else {
+    // Tiles cut across rows; any x coordinate can land in them
+    tile->xStart = 0;
+    tile->xEnd = Paint.width > Paint.height ? Paint.width : Paint.height;
+  }
+}
+
+/**
+ * Claims and draws tiles until none are left
+ */
+static void TileRender_DrawTiles(TILE_JOB *job)
+{
+  TILE tile;
+  int index;
+
+  while ((index = job->next.fetch_add(1)) < job->tileCount) {
+    Paint.clipStart = job->frame.clipStart;
+    Paint.clipEnd = job->frame.clipEnd;
+    TileRender_GetTile(index, job->tileCount, &tile);
+    Paint.clipStart = tile.byteStart;
+    Paint.clipEnd = tile.byteEnd;
+    job->draw(job->context, &tile);
+  }
+}
+
+#ifdef ARDUINO
+
+static void TileRender_Worker(PipeStage *stage)
+{
+  TILE_JOB *job = (TILE_JOB *)stage->context;
+  Paint = job->frame;
+  TileRender_DrawTiles(job);
+}
+
+/**
+ * Draws the tiles of a frame on tasks spread over both cores
+ */
+static void TileRender_Run(TILE_JOB *job, uint8_t workers)
+{
+  PipeStage stages[TILE_MAX_WORKERS];
+  for (uint8_t i = 0; i < workers; i++) {
+    stages[i].name = "tile";
+    stages[i].run = TileRender_Worker;
+    stages[i].context = job;
+    stages[i].core = i % 2;
+    stages[i].stackSize = TILE_STACK_SIZE;
+    stages[i].waitHook = NULL;
+  }
+  Pipe_Run(stages, workers);
+
+  // Tiles left when no worker could be started
+  TileRender_DrawTiles(job);
+}
+
+#else
+
+// Threads kept between frames, so a frame costs a wake-up rather than
+// thread starts; allocated once and never freed, as the threads never exit
+typedef struct
+{
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  int threadCount;
+  TILE_JOB *job;
+  uint32_t generation;  // Incremented for every frame
+  int helpers;          // Pool threads taking part in the current frame
+  int running;          // Pool threads still drawing the current frame
+} TILE_POOL;
+
+static TILE_POOL *tilePool;
+
+static void TileRender_PoolThread(int index)
+{
+  uint32_t seen = 0;
+  std::unique_lock<std::mutex> lock(tilePool->mutex);
+
+  for (;;) {
+    tilePool->wake.wait(lock, [&seen] { return tilePool->generation != seen; });
+    seen = tilePool->generation;
+    if (index >= tilePool->helpers) {
+      continue;
+    }
+
+    TILE_JOB *job = tilePool->job;
+    lock.unlock();
+    Paint = job->frame;
+    TileRender_DrawTiles(job);
+    lock.lock();
+
+    if (--tilePool->running == 0) {
+      tilePool->done.notify_one();
+    }
+  }
+}
+
+/**
+ * Draws the tiles of a frame on the calling thread and pool threads
+ */
+static void TileRender_Run(TILE_JOB *job, uint8_t workers)
+{
+  static std::once_flag created;
+  std::call_once(created, [] { tilePool = new TILE_POOL(); });
+
+  int helpers = workers - 1;
+  {
+    std::lock_guard<std::mutex> lock(tilePool->mutex);
+    while (tilePool->threadCount < helpers) {
+      std::thread(TileRender_PoolThread, tilePool->threadCount++).detach();
+    }
+    tilePool->job = job;
+    tilePool->helpers = helpers;
+    tilePool->running = helpers;
+    tilePool->generation++;
+  }
+  tilePool->wake.notify_all();
+
+  TileRender_DrawTiles(job);
+
+  std::unique_lock<std::mutex> lock(tilePool->mutex);
+  tilePool->done.wait(lock, [] { return tilePool->running == 0; });
+}
+
+#endif
+
+/**
+ * Draws a frame into the current Paint image, one tile per worker at a time
+ *
+ * With one worker or one tile, the frame is drawn in a single pass on
+ * the calling task. Tiles no worker could take are drawn there as well.
+ *
+ * @param draw Draws the frame, or the part of it inside a tile
+ * @param context Passed to draw
+ * @param tileCount Number of tiles
+ * @param workers Number of workers, at most TILE_MAX_WORKERS
+ */
+void TileRender_Frame(TILE_DRAW draw, void *context, uint8_t tileCount, uint8_t workers)
+{
+  uint16_t span = Paint.clipEnd - Paint.clipStart;
+  if (tileCount > span) {
+    tileCount = span;
+  }
+  if (workers > TILE_MAX_WORKERS) {
+    workers = TILE_MAX_WORKERS;
+  }
+  if (workers > tileCount) {
+    workers = tileCount;
+  }
+
+  if (workers <= 1) {
+    TILE tile;
+    TileRender_GetTile(0, 1, &tile);
+    draw(context, &tile);
+    return;
+  }
+
+  TILE_JOB job;
+  job.draw = draw;
+  job.context = context;
+  job.frame = Paint;
+  job.tileCount = tileCount;
+  job.next = 0;
+
+  TileRender_Run(&job, workers);
+  Paint = job.frame;
+}
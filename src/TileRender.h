@@ -0,0 +1,38 @@
+#ifndef _TILE_RENDER_H_
+#define _TILE_RENDER_H_
+
+#include <stdint.h>
+#include "Pipeline.h"
+
+/**
+ * Tile-parallel rasteriser
+ *
+ * Splits the current Paint image into vertical tiles of whole bytes and
+ * draws them on several workers at once: Pipeline stages spread over
+ * both cores on the device, the calling thread and a thread pool on the
+ * host. Every worker draws through a clip window covering its tile, so
+ * each pixel is written only by the tile that owns it and no byte is
+ * shared between workers; the frame comes out byte for byte the same as
+ * when drawn in one pass.
+ *
+ * Draw functions run concurrently. They may only draw with the Paint_*
+ * and EPD_* drawing functions, which act on the calling worker's Paint
+ * image, and may skip shapes outside the tile's x range to save time.
+ */
+
+#define TILE_MAX_WORKERS PIPE_MAX_STAGES
+
+typedef struct
+{
+  uint16_t byteStart;  // First byte column of the tile in image memory
+  uint16_t byteEnd;    // Byte column after the tile
+  int16_t xStart;      // Smallest x coordinate that can be drawn into the tile
+  int16_t xEnd;        // x coordinate after the largest one that can be drawn into the tile
+} TILE;
+
+typedef void (*TILE_DRAW)(void *context, const TILE *tile);
+
+void TileRender_GetTile(uint8_t index, uint8_t tileCount, TILE *tile);
+void TileRender_Frame(TILE_DRAW draw, void *context, uint8_t tileCount, uint8_t workers);
+
+#endif
@@ -0,0 +1,126 @@
+#include "WakeProfile.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+#define WAKE_PROFILE_MAGIC 0x57505231  // "WPR1"
+#define WAKE_PROFILE_US_PER_HOUR 3600e6f
+
+static const char* const PHASE_NAMES[WAKE_PHASE_COUNT] = {
+  "boot", "wifi", "http", "receive", "parse", "raster", "transfer", "busy", "shutdown"
+};
+
+// The wake being recorded
+static WakeRecord current;
+static int64_t phaseStartUs[WAKE_PHASE_COUNT];
+
+static int64_t WakeProfile_Micros() {
+#ifdef ARDUINO
+  return esp_timer_get_time();
+#else
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * Name of a phase, for printing
+ */
+const char* WakeProfile_PhaseName(int phase) {
+  return phase >= 0 && phase < WAKE_PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
+
+/**
+ * Prepares the log unless it already holds valid data
+ *
+ * @param log Log kept in RTC memory
+ */
+void WakeProfile_Init(WakeProfileLog* log) {
+  if (log->magic != WAKE_PROFILE_MAGIC) {
+    memset(log, 0, sizeof(*log));
+    log->magic = WAKE_PROFILE_MAGIC;
+  }
+}
+
+/**
+ * Starts timing a phase of this wake
+ */
+void WakeProfile_Begin(WakePhase phase) {
+  phaseStartUs[phase] = WakeProfile_Micros();
+}
+
+/**
+ * Stops timing a phase and adds the time since WakeProfile_Begin to it
+ */
+void WakeProfile_End(WakePhase phase) {
+  current.phaseUs[phase] += (uint32_t)(WakeProfile_Micros() - phaseStartUs[phase]);
+}
+
+/**
+ * Adds time measured elsewhere to a phase
+ */
+void WakeProfile_Add(WakePhase phase, uint32_t us) {
+  current.phaseUs[phase] += us;
+}
+
+/**
+ * Ends the record of this wake and adds it to the log
+ *
+ * @param log Log kept in RTC memory
+ * @param awakeUs Time from reset to deep sleep
+ * @param sleepSeconds Deep sleep that follows, 0 if without timer
+ */
+void WakeProfile_Finish(WakeProfileLog* log, uint32_t awakeUs, uint32_t sleepSeconds) {
+  current.awakeUs = awakeUs;
+  current.sleepSeconds = sleepSeconds;
+  log->records[log->wakes % WAKE_PROFILE_HISTORY] = current;
+  log->wakes++;
+  memset(&current, 0, sizeof(current));
+}
+
+/**
+ * Number of wakes in the log
+ */
+int WakeProfile_Count(const WakeProfileLog* log) {
+  return log->wakes < WAKE_PROFILE_HISTORY ? (int)log->wakes : WAKE_PROFILE_HISTORY;
+}
+
+/**
+ * Returns a wake of the log
+ *
+ * @param log Wake log
+ * @param age 0 for the latest wake, up to WakeProfile_Count() - 1
+ * @return Record, or NULL if there is no such wake
+ */
+const WakeRecord* WakeProfile_Get(const WakeProfileLog* log, int age) {
+  if (age < 0 || age >= WakeProfile_Count(log)) {
+    return NULL;
+  }
+  return &log->records[(log->wakes - 1 - age) % WAKE_PROFILE_HISTORY];
+}
+
+/**
+ * Estimated charge drawn while awake
+ *
+ * @return Charge in mAh
+ */
+float WakeProfile_AwakeMah(const WakeRecord* record, const WakeCurrents* currents) {
+  float maUs = record->awakeUs * currents->awakeMa;
+  for (int i = 0; i < WAKE_PHASE_COUNT; i++) {
+    maUs += record->phaseUs[i] * currents->phaseMa[i];
+  }
+  return maUs / WAKE_PROFILE_US_PER_HOUR;
+}
+
+/**
+ * Estimated charge drawn in the deep sleep after a wake
+ *
+ * @return Charge in mAh
+ */
+float WakeProfile_SleepMah(const WakeRecord* record, const WakeCurrents* currents) {
+  return record->sleepSeconds * currents->sleepMa / 3600.0f;
+}
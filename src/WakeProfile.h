@@ -0,0 +1,82 @@
+#ifndef _WAKE_PROFILE_H_
+#define _WAKE_PROFILE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Per-phase timing of each wake, with an energy estimate
+ *
+ * The phases of a wake are timed in microseconds through the
+ * WAKE_PROFILE_* macros, or WAKE_PHASE_* of ClockGovernor.h, which
+ * also set the CPU clock. At the end of the wake the record joins a ring
+ * of the last WAKE_PROFILE_HISTORY wakes, small enough for RTC memory,
+ * and per-state currents turn a record into an estimated charge.
+ *
+ * Build with -DWAKE_PROFILE to enable. Otherwise the macros expand to
+ * nothing and their arguments are not evaluated, so the instrumented
+ * code is the same as without them.
+ *
+ * Phases may overlap, e.g. parsing while the body arrives, so their sum
+ * can exceed the awake time. The same phase must not be timed from two
+ * tasks at once.
+ */
+
+#define WAKE_PROFILE_HISTORY 8  // Wakes kept in the ring
+
+enum WakePhase {
+  WAKE_PHASE_BOOT,       // Reset to setup(), bootloader and Arduino start-up
+  WAKE_PHASE_WIFI,       // Association, DHCP or lease reuse
+  WAKE_PHASE_HTTP,       // DNS, TCP connect and request, up to the status line
+  WAKE_PHASE_RECEIVE,    // Response body
+  WAKE_PHASE_PARSE,      // JSON parsing, excluding waits for the body
+  WAKE_PHASE_RASTER,     // Drawing frames into the frame buffer
+  WAKE_PHASE_TRANSFER,   // Writing frames to the panel RAM
+  WAKE_PHASE_BUSY,       // Waiting for the panel's BUSY line
+  WAKE_PHASE_SHUTDOWN,   // From the panel's deep sleep to the chip's
+  WAKE_PHASE_COUNT
+};
+
+struct WakeRecord {
+  uint32_t awakeUs;                   // Reset to deep sleep
+  uint32_t sleepSeconds;              // Deep sleep after the wake, 0 if without timer
+  uint32_t phaseUs[WAKE_PHASE_COUNT]; // Time in each phase
+};
+
+struct WakeProfileLog {
+  uint32_t magic;                     // Valid when set by WakeProfile_Init
+  uint32_t wakes;                     // Wakes recorded since the log was cleared
+  WakeRecord records[WAKE_PROFILE_HISTORY];  // Ring, the latest at (wakes - 1) % WAKE_PROFILE_HISTORY
+};
+
+/**
+ * Supply current in each state, in mA
+ */
+struct WakeCurrents {
+  float awakeMa;                      // CPU running, radio and panel idle
+  float sleepMa;                      // Deep sleep
+  float phaseMa[WAKE_PHASE_COUNT];    // Added to awakeMa during each phase
+};
+
+#ifdef WAKE_PROFILE
+#define WAKE_PROFILE_BEGIN(phase) WakeProfile_Begin(phase)
+#define WAKE_PROFILE_END(phase) WakeProfile_End(phase)
+#define WAKE_PROFILE_ADD(phase, us) WakeProfile_Add(phase, us)
+#else
+#define WAKE_PROFILE_BEGIN(phase) ((void)0)
+#define WAKE_PROFILE_END(phase) ((void)0)
+#define WAKE_PROFILE_ADD(phase, us) ((void)0)
+#endif
+
+const char* WakeProfile_PhaseName(int phase);
+void WakeProfile_Init(WakeProfileLog* log);
+void WakeProfile_Begin(WakePhase phase);
+void WakeProfile_End(WakePhase phase);
+void WakeProfile_Add(WakePhase phase, uint32_t us);
+void WakeProfile_Finish(WakeProfileLog* log, uint32_t awakeUs, uint32_t sleepSeconds);
+int WakeProfile_Count(const WakeProfileLog* log);
+const WakeRecord* WakeProfile_Get(const WakeProfileLog* log, int age);
+float WakeProfile_AwakeMah(const WakeRecord* record, const WakeCurrents* currents);
+float WakeProfile_SleepMah(const WakeRecord* record, const WakeCurrents* currents);
+
+#endif
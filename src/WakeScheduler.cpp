@@ -0,0 +1,124 @@
+#include "WakeScheduler.h"
+#include <string.h>
+
+#define WAKE_SCHEDULE_MAGIC 0x574B5332  // "WKS2"
+
+/**
+ * Prepares the schedule unless it already holds valid data
+ *
+ * @param schedule Schedule kept in RTC memory
+ */
+void WakeScheduler_Init(WakeSchedule* schedule) {
+  if (schedule->magic != WAKE_SCHEDULE_MAGIC) {
+    memset(schedule, 0, sizeof(*schedule));
+    schedule->magic = WAKE_SCHEDULE_MAGIC;
+  }
+}
+
+/**
+ * Records a wall time observation and updates the drift estimate
+ *
+ * Every sync becomes the reference of the wall time estimate. The drift
+ * is measured from an anchor sync at least WAKE_MIN_CALIBRATION_SECONDS
+ * earlier, so the one-second resolution of the wall time stays small
+ * against the interval.
+ *
+ * @param schedule Wake schedule
+ * @param wallTime Wall time (UTC), e.g., the Date header of a response
+ * @param localUs Local clock when the response arrived
+ */
+void WakeScheduler_Sync(WakeSchedule* schedule, int32_t wallTime, int64_t localUs) {
+  if (schedule->syncWallTime == 0 || localUs < schedule->anchorLocalUs) {
+    // First sync, or the local clock was reset; start over from this observation
+    schedule->anchorWallTime = wallTime;
+    schedule->anchorLocalUs = localUs;
+  } else {
+    int64_t wallElapsedUs = (int64_t)(wallTime - schedule->anchorWallTime) * 1000000;
+    int64_t localElapsedUs = localUs - schedule->anchorLocalUs;
+
+    if (wallElapsedUs >= (int64_t)WAKE_MIN_CALIBRATION_SECONDS * 1000000) {
+      int64_t ppm = (localElapsedUs - wallElapsedUs) * 1000000 / wallElapsedUs;
+      if (ppm > -WAKE_MAX_DRIFT_PPM && ppm < WAKE_MAX_DRIFT_PPM) {
+        // Exponential moving average, weight 1/4 for the new measurement
+        schedule->driftPpm = schedule->driftPpm == 0 ? (int32_t)ppm
+                                                     : (int32_t)((schedule->driftPpm * 3LL + ppm) / 4);
+      }
+      schedule->anchorWallTime = wallTime;
+      schedule->anchorLocalUs = localUs;
+    } else if (wallElapsedUs < 0) {
+      // Wall time went back; measure from here on
+      schedule->anchorWallTime = wallTime;
+      schedule->anchorLocalUs = localUs;
+    }
+  }
+
+  schedule->syncWallTime = wallTime;
+  schedule->syncLocalUs = localUs;
+}
+
+/**
+ * Converts the local clock to wall time in microseconds
+ */
+static int64_t WakeScheduler_WallUs(const WakeSchedule* schedule, int64_t localUs) {
+  if (schedule->syncWallTime == 0) {
+    return localUs;
+  }
+  int64_t localElapsedUs = localUs - schedule->syncLocalUs;
+  int64_t wallElapsedUs = localElapsedUs * 1000000 / (1000000 + schedule->driftPpm);
+  return (int64_t)schedule->syncWallTime * 1000000 + wallElapsedUs;
+}
+
+/**
+ * Estimates the wall time from the local clock
+ *
+ * @param schedule Wake schedule
+ * @param localUs Local clock
+ * @return Wall time (UTC); the local clock in seconds if never synced
+ */
+int32_t WakeScheduler_WallTime(const WakeSchedule* schedule, int64_t localUs) {
+  return (int32_t)(WakeScheduler_WallUs(schedule, localUs) / 1000000);
+}
+
+/**
+ * Records how long a wake took from wake-up to display refresh
+ *
+ * @param schedule Wake schedule
+ * @param wakeToRefreshMs Time from wake-up to the refresh
+ */
+void WakeScheduler_RecordLead(WakeSchedule* schedule, uint32_t wakeToRefreshMs) {
+  schedule->leadMs = schedule->leadMs == 0 ? wakeToRefreshMs : (schedule->leadMs * 3 + wakeToRefreshMs) / 4;
+}
+
+/**
+ * Computes the sleep before the next scheduled wake
+ *
+ * The target is the first boundary (a multiple of alignSeconds in local
+ * time) after now + intervalSeconds - alignSeconds / 2, so wakes that
+ * ran early or late snap back to the grid. The wake is moved earlier by
+ * the learned lead time, and the wall duration is converted to local
+ * clock time with the drift estimate.
+ *
+ * @param schedule Wake schedule
+ * @param localUs Local clock now
+ * @param utcOffsetSeconds Offset of the local time zone from UTC
+ * @param intervalSeconds Update interval
+ * @param alignSeconds Boundary spacing, 0 for a plain interval
+ * @return Sleep duration in microseconds of the local clock
+ */
+uint64_t WakeScheduler_SleepUs(const WakeSchedule* schedule, int64_t localUs, int32_t utcOffsetSeconds,
+                               uint32_t intervalSeconds, uint32_t alignSeconds) {
+  if (schedule->syncWallTime == 0 || alignSeconds == 0) {
+    return (uint64_t)intervalSeconds * 1000000;
+  }
+
+  int64_t nowUs = WakeScheduler_WallUs(schedule, localUs);
+  int64_t localNow = nowUs / 1000000 + utcOffsetSeconds;
+  int64_t earliest = localNow + (int64_t)intervalSeconds - alignSeconds / 2;
+  int64_t boundary = (earliest / alignSeconds + 1) * alignSeconds;
+
+  int64_t wallSleepUs = (boundary - utcOffsetSeconds) * 1000000 - nowUs - (int64_t)schedule->leadMs * 1000;
+  if (wallSleepUs < (int64_t)WAKE_MIN_SLEEP_SECONDS * 1000000) {
+    wallSleepUs = (int64_t)WAKE_MIN_SLEEP_SECONDS * 1000000;
+  }
+  return (uint64_t)(wallSleepUs + wallSleepUs / 1000000 * schedule->driftPpm);
+}
@@ -0,0 +1,50 @@
+#ifndef _WAKE_SCHEDULER_H_
+#define _WAKE_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Wake-up scheduling aligned to wall-clock boundaries
+ *
+ * The local clock runs on the RTC slow clock during deep sleep and drifts
+ * from wall time. Each HTTP response carries the wall time in its Date
+ * header, to the second; comparing it with the local clock at syncs at
+ * least WAKE_MIN_CALIBRATION_SECONDS apart gives the drift rate, which
+ * corrects both the wall time estimated between syncs and the length of
+ * the next sleep. The forecast's own current.dt is not used: it is the
+ * time of the provider's last observation, minutes old and unevenly so.
+ *
+ * The slow clock is calibrated against the main crystal before each
+ * sleep, which leaves drift from temperature changes of a few hundred
+ * ppm. Rates beyond WAKE_MAX_DRIFT_PPM are taken as bad syncs and leave
+ * the estimate unchanged.
+ *
+ * The next wake is placed so that the display refresh lands on a
+ * boundary (e.g., minute :00), starting early by the learned time from
+ * wake-up to refresh. Times are passed in, so a simulated clock can drive
+ * the scheduler on the host.
+ */
+
+#define WAKE_MAX_DRIFT_PPM 500          // Drift rates beyond +-500 ppm are treated as bad syncs
+#define WAKE_MIN_CALIBRATION_SECONDS 14400  // Shortest interval between syncs used for calibration, 1 s is 70 ppm
+#define WAKE_MIN_SLEEP_SECONDS 60       // Shortest scheduled sleep
+
+struct WakeSchedule {
+  uint32_t magic;          // Valid when set by WakeScheduler_Init
+  int32_t syncWallTime;    // Wall time of the last sync (UTC), 0 if never synced
+  int32_t anchorWallTime;  // Wall time of the sync the next drift measurement starts from
+  int64_t syncLocalUs;     // Local clock at the last sync
+  int64_t anchorLocalUs;   // Local clock at the anchor sync
+  int32_t driftPpm;        // Local clock rate error, positive when it runs fast
+  uint32_t leadMs;         // Smoothed time from wake-up to display refresh
+};
+
+void WakeScheduler_Init(WakeSchedule* schedule);
+void WakeScheduler_Sync(WakeSchedule* schedule, int32_t wallTime, int64_t localUs);
+int32_t WakeScheduler_WallTime(const WakeSchedule* schedule, int64_t localUs);
+void WakeScheduler_RecordLead(WakeSchedule* schedule, uint32_t wakeToRefreshMs);
+uint64_t WakeScheduler_SleepUs(const WakeSchedule* schedule, int64_t localUs, int32_t utcOffsetSeconds,
+                               uint32_t intervalSeconds, uint32_t alignSeconds);
+
+#endif
@@ -0,0 +1,356 @@
+#include "WiFiConnect.h"
+#include <WiFi.h>
+#include <Preferences.h>
+#include <freertos/event_groups.h>
+#include "config.h"
+
+// Reuse the last IP configuration instead of DHCP on fast reconnects.
+// Only safe when the router keeps the address reserved for this device.
+#ifndef WIFI_REUSE_IP_LEASE
+#define WIFI_REUSE_IP_LEASE 0
+#endif
+
+// Time allowed for each direct join before trying the next network
+#ifndef WIFI_FAST_CONNECT_TIMEOUT_MS
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 3000
+#endif
+
+// Deadline of the whole connection: direct joins, scan and searching joins
+#ifndef WIFI_CONNECT_DEADLINE_MS
+#define WIFI_CONNECT_DEADLINE_MS 20000
+#endif
+
+// Longest wait for the station to report the disconnect after a failed join
+#ifndef WIFI_DISCONNECT_TIMEOUT_MS
+#define WIFI_DISCONNECT_TIMEOUT_MS 500
+#endif
+
+#define WIFI_LEASE_MAGIC 0x57464C32  // "WFL2"
+
+#define WIFI_GOT_IP_BIT BIT0
+#define WIFI_DISCONNECTED_BIT BIT1
+
+// NVS namespace and keys of the credential store
+#define WIFI_NVS_NAMESPACE "wifi"
+#define WIFI_NVS_COUNT "count"
+#define WIFI_NVS_SEED "seed"
+
+/**
+ * IP configuration kept across deep sleep
+ */
+struct WiFiLease {
+  uint32_t magic;      // WIFI_LEASE_MAGIC when valid
+  uint32_t ssidHash;   // Network the lease belongs to
+  uint32_t ip;         // Local IP address
+  uint32_t gateway;    // Gateway address
+  uint32_t subnet;     // Subnet mask
+  uint32_t dns;        // DNS server
+};
+
+RTC_DATA_ATTR static WiFiLease lease;
+RTC_DATA_ATTR static NETWORK_STATE networkState;
+
+static EventGroupHandle_t wifiEvents = NULL;
+
+// Networks from config.h, written to NVS whenever they change
+static const NETWORK_CREDENTIAL CONFIG_NETWORKS[] = {
+  {WIFI_SSID, WIFI_PASSWORD},
+#ifdef WIFI_NETWORKS
+  WIFI_NETWORKS
+#endif
+};
+static const int CONFIG_NETWORK_COUNT = sizeof(CONFIG_NETWORKS) / sizeof(CONFIG_NETWORKS[0]);
+
+/**
+ * Wi-Fi event handler, runs in the event task
+ */
+static void WiFiConnect_OnEvent(arduino_event_id_t event) {
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    xEventGroupSetBits(wifiEvents, WIFI_GOT_IP_BIT);
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    xEventGroupSetBits(wifiEvents, WIFI_DISCONNECTED_BIT);
+  }
+}
+
+/**
+ * Blocks until an IP address is assigned, without polling
+ *
+ * @param timeoutMs Maximum time to wait
+ * @param stopOnDisconnect Give up as soon as the station reports a disconnect
+ * @return true if an IP address was assigned
+ */
+static bool WiFiConnect_WaitForIP(uint32_t timeoutMs, bool stopOnDisconnect) {
+  EventBits_t waitBits = WIFI_GOT_IP_BIT | (stopOnDisconnect ? WIFI_DISCONNECTED_BIT : 0);
+  EventBits_t bits = xEventGroupWaitBits(wifiEvents, waitBits, pdTRUE, pdFALSE, pdMS_TO_TICKS(timeoutMs));
+  return (bits & WIFI_GOT_IP_BIT) != 0;
+}
+
+/**
+ * Hash of the configured networks, used to detect edits to config.h
+ */
+static uint32_t WiFiConnect_ConfigHash(void) {
+  uint32_t hash = 2166136261UL;
+  for (int i = 0; i < CONFIG_NETWORK_COUNT; i++) {
+    hash = (hash ^ Network_HashSsid(CONFIG_NETWORKS[i].ssid)) * 16777619UL;
+    hash = (hash ^ Network_HashSsid(CONFIG_NETWORKS[i].password)) * 16777619UL;
+  }
+  return hash;
+}
+
+/**
+ * Writes a credential list to NVS
+ */
+static void WiFiConnect_StoreCredentials(Preferences& prefs, const NETWORK_CREDENTIAL* credentials, int count) {
+  char key[8];
+  for (int i = 0; i < count; i++) {
+    snprintf(key, sizeof(key), "ssid%d", i);
+    prefs.putString(key, credentials[i].ssid);
+    snprintf(key, sizeof(key), "pass%d", i);
+    prefs.putString(key, credentials[i].password);
+  }
+  prefs.putUChar(WIFI_NVS_COUNT, count);
+}
+
+/**
+ * Loads the known networks from NVS
+ *
+ * The store is reseeded from config.h on first use and whenever the
+ * networks in config.h change. Networks added at run time are kept
+ * until then. Falls back to config.h if NVS is unavailable.
+ *
+ * @param credentials Receives the networks
+ * @param maxCount Capacity of credentials
+ * @return Number of networks
+ */
+int WiFiConnect_LoadCredentials(NETWORK_CREDENTIAL* credentials, int maxCount) {
+  Preferences prefs;
+  int count = min(CONFIG_NETWORK_COUNT, maxCount);
+
+  if (!prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+    memcpy(credentials, CONFIG_NETWORKS, count * sizeof(NETWORK_CREDENTIAL));
+    return count;
+  }
+
+  uint32_t seed = WiFiConnect_ConfigHash();
+  if (prefs.getUInt(WIFI_NVS_SEED, 0) != seed) {
+    Serial.println("Storing WiFi networks from config.h");
+    prefs.clear();
+    WiFiConnect_StoreCredentials(prefs, CONFIG_NETWORKS, count);
+    prefs.putUInt(WIFI_NVS_SEED, seed);
+  }
+
+  count = min((int)prefs.getUChar(WIFI_NVS_COUNT, 0), maxCount);
+  char key[8];
+  for (int i = 0; i < count; i++) {
+    snprintf(key, sizeof(key), "ssid%d", i);
+    prefs.getString(key, credentials[i].ssid, sizeof(credentials[i].ssid));
+    snprintf(key, sizeof(key), "pass%d", i);
+    prefs.getString(key, credentials[i].password, sizeof(credentials[i].password));
+  }
+  prefs.end();
+  return count;
+}
+
+/**
+ * Adds a network to the NVS store, or updates its password
+ *
+ * @param ssid Network name
+ * @param password Network password
+ * @return true if stored
+ */
+bool WiFiConnect_AddCredential(const char* ssid, const char* password) {
+  NETWORK_CREDENTIAL credentials[NETWORK_MAX_CREDENTIALS];
+  int count = WiFiConnect_LoadCredentials(credentials, NETWORK_MAX_CREDENTIALS);
+
+  int index = 0;
+  while (index < count && strcmp(credentials[index].ssid, ssid) != 0) {
+    index++;
+  }
+  if (index == NETWORK_MAX_CREDENTIALS || strlen(ssid) >= NETWORK_SSID_SIZE ||
+      strlen(password) >= NETWORK_PASSWORD_SIZE) {
+    return false;
+  }
+
+  strcpy(credentials[index].ssid, ssid);
+  strcpy(credentials[index].password, password);
+
+  Preferences prefs;
+  if (!prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+    return false;
+  }
+  WiFiConnect_StoreCredentials(prefs, credentials, max(count, index + 1));
+  prefs.end();
+  return true;
+}
+
+/**
+ * Stores the IP configuration of the current connection in RTC memory
+ */
+static void WiFiConnect_SaveLease(const char* ssid) {
+  lease.ssidHash = Network_HashSsid(ssid);
+  lease.ip = (uint32_t)WiFi.localIP();
+  lease.gateway = (uint32_t)WiFi.gatewayIP();
+  lease.subnet = (uint32_t)WiFi.subnetMask();
+  lease.dns = (uint32_t)WiFi.dnsIP();
+  lease.magic = WIFI_LEASE_MAGIC;
+}
+
+/**
+ * Invalidates the cached IP configuration and network ranking
+ */
+void WiFiConnect_ForgetLease(void) {
+  lease.magic = 0;
+  networkState.magic = 0;
+}
+
+/**
+ * Describes the state kept across deep sleep, for a StateStore
+ *
+ * @param records Receives the records
+ * @param maxCount Capacity of records
+ * @return Number of records written
+ */
+int WiFiConnect_StateRecords(StateRecord* records, int maxCount) {
+  const StateRecord table[] = {
+    {"wifiLease", 1, sizeof(lease), &lease, false},
+    {"wifiNetworks", 2, sizeof(networkState), &networkState, false}
+  };
+  int count = 0;
+  for (; count < maxCount && count < (int)(sizeof(table) / sizeof(table[0])); count++) {
+    records[count] = table[count];
+  }
+  return count;
+}
+
+/**
+ * NetworkSelect driver: joins one network
+ */
+static bool WiFiConnect_Join(void* context, const NETWORK_CREDENTIAL* credential, const uint8_t* bssid,
+                             uint8_t channel, uint32_t timeoutMs) {
+  bool reuseLease = WIFI_REUSE_IP_LEASE && bssid != NULL && lease.magic == WIFI_LEASE_MAGIC &&
+                    lease.ssidHash == Network_HashSsid(credential->ssid);
+
+  Serial.print("Joining ");
+  Serial.print(credential->ssid);
+  Serial.println(bssid != NULL ? " (cached access point)" : "");
+
+  xEventGroupClearBits(wifiEvents, WIFI_GOT_IP_BIT | WIFI_DISCONNECTED_BIT);
+  if (reuseLease) {
+    WiFi.config(IPAddress(lease.ip), IPAddress(lease.gateway), IPAddress(lease.subnet), IPAddress(lease.dns));
+  }
+  if (bssid != NULL) {
+    WiFi.begin(credential->ssid, credential->password, channel, bssid, true);
+  } else {
+    WiFi.begin(credential->ssid, credential->password);
+  }
+
+  // A direct join fails fast on disconnect; a searching join keeps retrying until the deadline
+  bool connected = WiFiConnect_WaitForIP(timeoutMs, bssid != NULL);
+  if (!connected) {
+    // The disconnect is reported asynchronously; wait for its event here, so
+    // it cannot arrive after the next join has cleared the bits and end it
+    xEventGroupClearBits(wifiEvents, WIFI_DISCONNECTED_BIT);
+    WiFi.disconnect();
+    xEventGroupWaitBits(wifiEvents, WIFI_DISCONNECTED_BIT, pdTRUE, pdFALSE, pdMS_TO_TICKS(WIFI_DISCONNECT_TIMEOUT_MS));
+    if (reuseLease) {
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);  // Back to DHCP
+    }
+  }
+  return connected;
+}
+
+/**
+ * NetworkSelect driver: blocking scan of all channels
+ */
+static int WiFiConnect_Scan(void* context) {
+  Serial.println("Scanning for WiFi networks...");
+  int found = WiFi.scanNetworks(false, true);
+  return found > 0 ? found : 0;
+}
+
+/**
+ * NetworkSelect driver: one access point of the last scan
+ */
+static bool WiFiConnect_ScanResult(void* context, int index, NETWORK_SCAN_RESULT* result) {
+  String ssid = WiFi.SSID(index);
+  const uint8_t* bssid = WiFi.BSSID(index);
+  if (ssid.length() == 0 || bssid == NULL) {
+    return false;
+  }
+
+  result->ssidHash = Network_HashSsid(ssid.c_str());
+  result->rssi = WiFi.RSSI(index);
+  result->channel = WiFi.channel(index);
+  memcpy(result->bssid, bssid, sizeof(result->bssid));
+  return true;
+}
+
+/**
+ * NetworkSelect driver: details of the current connection
+ */
+static void WiFiConnect_Status(void* context, int8_t* rssi, uint8_t* bssid, uint8_t* channel) {
+  const uint8_t* current = WiFi.BSSID();
+  *rssi = WiFi.RSSI();
+  *channel = WiFi.channel();
+  if (current != NULL) {
+    memcpy(bssid, current, 6);
+  }
+}
+
+/**
+ * NetworkSelect driver: milliseconds since boot
+ */
+static uint32_t WiFiConnect_Millis(void* context) {
+  return millis();
+}
+
+/**
+ * Connects to the best available known network
+ *
+ * Gives up after WIFI_CONNECT_DEADLINE_MS.
+ *
+ * @param timeoutMs Deadline shared by the joins without a cached access point
+ * @return true if connected
+ */
+bool WiFiConnect_Connect(uint32_t timeoutMs) {
+  static const NETWORK_DRIVER driver = {
+    NULL, WiFiConnect_Join, WiFiConnect_Scan, WiFiConnect_ScanResult, WiFiConnect_Status, WiFiConnect_Millis
+  };
+  NETWORK_CREDENTIAL credentials[NETWORK_MAX_CREDENTIALS];
+  uint32_t startMs = millis();
+
+  if (wifiEvents == NULL) {
+    wifiEvents = xEventGroupCreate();
+    WiFi.onEvent(WiFiConnect_OnEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent(WiFiConnect_OnEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  }
+
+  int count = WiFiConnect_LoadCredentials(credentials, NETWORK_MAX_CREDENTIALS);
+
+  // Credentials are managed by the store above, keep them out of the driver's NVS
+  WiFi.persistent(false);
+  WiFi.mode(WIFI_STA);
+
+  int index = Network_Connect(&networkState, credentials, count, &driver, WIFI_FAST_CONNECT_TIMEOUT_MS, timeoutMs,
+                              WIFI_CONNECT_DEADLINE_MS);
+  WiFi.scanDelete();
+
+  if (index >= 0) {
+    WiFiConnect_SaveLease(credentials[index].ssid);
+  }
+
+  Serial.print("WiFi ");
+  Serial.print(index >= 0 ? "connected" : "connection failed");
+  Serial.print(" in ");
+  Serial.print(millis() - startMs);
+  Serial.println(" ms");
+  return index >= 0;
+}
+
+/**
+ * Disconnects from Wi-Fi and turns the radio off
+ */
+void WiFiConnect_Disconnect(void) {
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+}
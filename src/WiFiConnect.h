@@ -0,0 +1,27 @@
+#ifndef _WIFI_CONNECT_H_
+#define _WIFI_CONNECT_H_
+
+#include <Arduino.h>
+#include "NetworkSelect.h"
+#include "StateStore.h"
+
+/**
+ * Wi-Fi connection to one of several known networks
+ *
+ * Known networks are stored in NVS and seeded from config.h (WIFI_SSID
+ * and the optional WIFI_NETWORKS list). The network is chosen by
+ * NetworkSelect from the scan and signal history kept in RTC memory, and
+ * joined directly by BSSID and channel; a scan is made only when the
+ * cached choices fail. The IP configuration of the last connection can
+ * optionally be reused instead of waiting for DHCP. The RTC state is
+ * checked by the owner's StateStore through WiFiConnect_StateRecords.
+ */
+
+int WiFiConnect_LoadCredentials(NETWORK_CREDENTIAL* credentials, int maxCount);
+bool WiFiConnect_AddCredential(const char* ssid, const char* password);
+bool WiFiConnect_Connect(uint32_t timeoutMs);
+void WiFiConnect_Disconnect(void);
+void WiFiConnect_ForgetLease(void);
+int WiFiConnect_StateRecords(StateRecord* records, int maxCount);
+
+#endif
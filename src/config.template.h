@@ -8,6 +8,9 @@
 // 2.4 GHz WiFi Configurations
 #define WIFI_SSID "your WiFi SSID"
 #define WIFI_PASSWORD "your WiFi password"
+#define WIFI_REUSE_IP_LEASE 0  // 1 = reuse the last IP address instead of DHCP (needs a reserved address on the router)
+// Additional networks (optional, up to 7 more); the one with the best signal is used
+// #define WIFI_NETWORKS {"office SSID", "office password"}, {"phone hotspot", "hotspot password"}
 
 // OpenWeatherMap API Configurations
 #define OPENWEATHERMAP_API_KEY "your OpenWeatherMap API key"
@@ -18,5 +21,19 @@
 
 // Interval Configurations (minutes)
 #define INTERVAL_IN_MINUTES 60 // 1 hour
+#define WAKE_ALIGN_MINUTES 60  // Refresh on the hour (30 = on the hour and half hour, 0 = no alignment)
+#define FORECAST_MAX_AGE_MINUTES 360 // Display updates in between use the cached forecast (6 hours)
+#define RETRY_INTERVAL_MINUTES 15    // First retry after a failed update, doubling up to INTERVAL_IN_MINUTES
+
+// Update Cadence Configurations (optional)
+// #define CADENCE_MIN_MINUTES 60       // Wake interval while the forecast changes a lot (default: INTERVAL_IN_MINUTES)
+// #define CADENCE_MAX_MINUTES 180      // Wake interval while the forecast is stable (default: CADENCE_MIN_MINUTES)
+// #define FORECAST_MIN_AGE_MINUTES 120 // Fetch again once a volatile forecast is this old
+// Local windows without wakes, {start minute, end minute} of the day; the display is updated when they end
+// #define QUIET_HOURS {23 * 60, 6 * 60}, {12 * 60, 13 * 60}
+
+// Battery Configurations (optional)
+// #define BATTERY_ADC_PIN 8           // ADC pin of the battery voltage divider; updates less often as the battery runs down
+// #define BATTERY_DIVIDER_RATIO 2.0f  // Battery voltage over the voltage at the pin
 
 #endif
@@ -8,6 +8,9 @@
  * 
  * I converted the icon to a byte sequence
  * using the software "Image2Lcd".
+ *
+ * After changing the icons, run tools/compress_icons.py
+ * to regenerate the compressed copy in icons_rle.h.
  */
 
 const unsigned char Weather_Num[7][2048] = {
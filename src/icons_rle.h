@@ -0,0 +1,421 @@
+#ifndef _ICONS_RLE_H_
+#define _ICONS_RLE_H_
+
+/**
+ * Compressed version of the weather icons in icons.h
+ *
+ * Generated by tools/compress_icons.py. Do not edit by hand.
+ *
+ *   clear day       2048 ->  1043 bytes (1.96:1)
+ *   clear night     2048 ->   700 bytes (2.93:1)
+ *   clouds          2048 ->   777 bytes (2.64:1)
+ *   rain            2048 ->   927 bytes (2.21:1)
+ *   thunderstorm    2048 ->   820 bytes (2.50:1)
+ *   snow            2048 ->   894 bytes (2.29:1)
+ *   mist            2048 ->   360 bytes (5.69:1)
+ *   total          14336 ->  5521 bytes (2.60:1)
+ */
+
+#include "AssetCodec.h"
+
+// clear day
+static const uint16_t icon_clear_day_restarts[] = {
+    0,32,145,331,515,700,882,995,
+};
+static const uint8_t icon_clear_day_data[] = {
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X84,0X00,0X01,0X01,0X80,0X84,0X00,0X84,0X00,0X01,0X03,0XC0,0X84,0X00,
+    0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,
+    0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,
+    0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,
+    0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,
+    0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,
+    0X07,0XE0,0X84,0X00,0X81,0X00,0X07,0X60,0X00,0X00,0X07,0XE0,0X00,0X00,0X06,0X81,
+    0X00,0X81,0X00,0X07,0XF0,0X00,0X00,0X03,0XC0,0X00,0X00,0X0F,0X81,0X00,0X80,0X00,
+    0X09,0X01,0XF8,0X00,0X00,0X01,0X80,0X00,0X00,0X1F,0X80,0X80,0X00,0X80,0X00,0X01,
+    0X01,0XFC,0X83,0X00,0X01,0X3F,0X80,0X80,0X00,0X81,0X00,0X00,0XFE,0X83,0X00,0X00,
+    0X7F,0X81,0X00,0X81,0X00,0X00,0X7F,0X83,0X00,0X00,0XFE,0X81,0X00,0X81,0X00,0X01,
+    0X3F,0X80,0X81,0X00,0X01,0X01,0XFC,0X81,0X00,0X81,0X00,0X01,0X1F,0XC0,0X81,0X00,
+    0X01,0X03,0XF8,0X81,0X00,0X81,0X00,0X07,0X0F,0XE0,0X00,0X07,0XF0,0X00,0X07,0XF0,
+    0X81,0X00,0X81,0X00,0X07,0X07,0XE0,0X00,0XFF,0XFF,0X00,0X07,0XE0,0X81,0X00,0X81,
+    0X00,0X07,0X03,0XE0,0X03,0XFF,0XFF,0XE0,0X07,0XC0,0X81,0X00,0X81,0X00,0X07,0X01,
+    0XC0,0X0F,0XFF,0XFF,0XF0,0X03,0X80,0X81,0X00,0X83,0X00,0X03,0X3F,0XFF,0XFF,0XFC,
+    0X83,0X00,0X83,0X00,0X03,0X7F,0XFF,0XFF,0XFE,0X83,0X00,0X83,0X00,0X04,0XFF,0XE0,
+    0X07,0XFF,0X80,0X82,0X00,0X82,0X00,0X05,0X01,0XFF,0X00,0X00,0XFF,0XC0,0X82,0X00,
+    0X82,0X00,0X05,0X03,0XFC,0X00,0X00,0X3F,0XE0,0X82,0X00,0X82,0X00,0X05,0X07,0XF0,
+    0X00,0X00,0X0F,0XE0,0X82,0X00,0X82,0X00,0X05,0X0F,0XE0,0X00,0X00,0X07,0XF0,0X82,
+    0X00,0X82,0X00,0X05,0X1F,0XC0,0X00,0X00,0X03,0XF8,0X82,0X00,0X82,0X00,0X05,0X1F,
+    0X80,0X00,0X00,0X01,0XFC,0X82,0X00,0X82,0X00,0X00,0X3F,0X81,0X00,0X00,0XFC,0X82,
+    0X00,0X82,0X00,0X00,0X3F,0X81,0X00,0X00,0XFE,0X82,0X00,0X82,0X00,0X00,0X7E,0X81,
+    0X00,0X00,0X7E,0X82,0X00,0X82,0X00,0X00,0X7E,0X81,0X00,0X00,0X3E,0X82,0X00,0X82,
+    0X00,0X00,0XFC,0X81,0X00,0X00,0X3F,0X82,0X00,0X82,0X00,0X00,0XFC,0X81,0X00,0X00,
+    0X3F,0X82,0X00,0X82,0X00,0X00,0XF8,0X81,0X00,0X00,0X1F,0X82,0X00,0X82,0X00,0X00,
+    0XF8,0X81,0X00,0X01,0X1F,0X80,0X81,0X00,0X82,0X00,0X00,0XF8,0X81,0X00,0X01,0X1F,
+    0X80,0X81,0X00,0X05,0X00,0X00,0X0F,0XFE,0X01,0XF8,0X81,0X00,0X05,0X1F,0X80,0X7F,
+    0XF0,0X00,0X00,0X05,0X00,0X00,0X3F,0XFF,0X81,0XF8,0X81,0X00,0X05,0X1F,0X81,0XFF,
+    0XFC,0X00,0X00,0X05,0X00,0X00,0X7F,0XFF,0XC1,0XF8,0X81,0X00,0X05,0X1F,0X83,0XFF,
+    0XFE,0X00,0X00,0X05,0X00,0X00,0X7F,0XFF,0XC1,0XF8,0X81,0X00,0X05,0X1F,0X83,0XFF,
+    0XFE,0X00,0X00,0X05,0X00,0X00,0X3F,0XFF,0X81,0XF8,0X81,0X00,0X05,0X1F,0X81,0XFF,
+    0XFC,0X00,0X00,0X05,0X00,0X00,0X1F,0XFF,0X01,0XF8,0X81,0X00,0X05,0X1F,0X80,0XFF,
+    0XF8,0X00,0X00,0X81,0X00,0X01,0X01,0XF8,0X81,0X00,0X01,0X1F,0X80,0X81,0X00,0X82,
+    0X00,0X00,0XF8,0X81,0X00,0X01,0X1F,0X80,0X81,0X00,0X82,0X00,0X00,0XF8,0X81,0X00,
+    0X00,0X1F,0X82,0X00,0X82,0X00,0X00,0XFC,0X81,0X00,0X00,0X3F,0X82,0X00,0X82,0X00,
+    0X00,0XFC,0X81,0X00,0X00,0X3F,0X82,0X00,0X82,0X00,0X00,0X7E,0X81,0X00,0X00,0X3F,
+    0X82,0X00,0X82,0X00,0X00,0X7E,0X81,0X00,0X00,0X7E,0X82,0X00,0X82,0X00,0X00,0X7F,
+    0X81,0X00,0X00,0X7E,0X82,0X00,0X82,0X00,0X00,0X3F,0X81,0X00,0X00,0XFC,0X82,0X00,
+    0X82,0X00,0X05,0X3F,0X80,0X00,0X00,0X01,0XFC,0X82,0X00,0X82,0X00,0X05,0X1F,0XC0,
+    0X00,0X00,0X03,0XF8,0X82,0X00,0X82,0X00,0X05,0X0F,0XE0,0X00,0X00,0X07,0XF8,0X82,
+    0X00,0X82,0X00,0X05,0X07,0XF0,0X00,0X00,0X0F,0XF0,0X82,0X00,0X82,0X00,0X05,0X07,
+    0XFC,0X00,0X00,0X1F,0XE0,0X82,0X00,0X82,0X00,0X05,0X03,0XFE,0X00,0X00,0X7F,0XC0,
+    0X82,0X00,0X82,0X00,0X05,0X01,0XFF,0XC0,0X01,0XFF,0X80,0X82,0X00,0X83,0X00,0X81,
+    0XFF,0X83,0X00,0X83,0X00,0X03,0X3F,0XFF,0XFF,0XFE,0X83,0X00,0X81,0X00,0X07,0X01,
+    0XC0,0X1F,0XFF,0XFF,0XF8,0X03,0X80,0X81,0X00,0X81,0X00,0X07,0X03,0XE0,0X07,0XFF,
+    0XFF,0XE0,0X07,0XC0,0X81,0X00,0X81,0X00,0X07,0X07,0XE0,0X01,0XFF,0XFF,0X80,0X07,
+    0XE0,0X81,0X00,0X81,0X00,0X07,0X0F,0XE0,0X00,0X1F,0XF8,0X00,0X07,0XF0,0X81,0X00,
+    0X81,0X00,0X01,0X1F,0XC0,0X81,0X00,0X01,0X03,0XF8,0X81,0X00,0X81,0X00,0X01,0X3F,
+    0XC0,0X81,0X00,0X01,0X01,0XFC,0X81,0X00,0X81,0X00,0X01,0X7F,0X80,0X82,0X00,0X00,
+    0XFE,0X81,0X00,0X81,0X00,0X00,0XFF,0X83,0X00,0X00,0XFF,0X81,0X00,0X81,0X00,0X00,
+    0XFE,0X83,0X00,0X01,0X7F,0X80,0X80,0X00,0X80,0X00,0X01,0X01,0XFC,0X83,0X00,0X01,
+    0X3F,0X80,0X80,0X00,0X81,0X00,0X08,0XF8,0X00,0X00,0X03,0XC0,0X00,0X00,0X1F,0X80,
+    0X80,0X00,0X81,0X00,0X07,0XF0,0X00,0X00,0X03,0XC0,0X00,0X00,0X0F,0X81,0X00,0X84,
+    0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,
+    0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,
+    0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,
+    0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,
+    0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,
+    0XE0,0X84,0X00,0X84,0X00,0X01,0X03,0XC0,0X84,0X00,0X84,0X00,0X01,0X03,0XC0,0X84,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,
+};
+
+// clear night
+static const uint16_t icon_clear_night_restarts[] = {
+    0,32,64,154,292,475,620,652,
+};
+static const uint8_t icon_clear_night_data[] = {
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X86,0X00,0X00,0XFC,0X83,0X00,
+    0X85,0X00,0X01,0X01,0XFF,0X83,0X00,0X85,0X00,0X02,0X01,0XFF,0X80,0X82,0X00,0X85,
+    0X00,0X02,0X01,0XFF,0XE0,0X82,0X00,0X85,0X00,0X02,0X01,0XFF,0XF0,0X82,0X00,0X86,
+    0X00,0X01,0XFF,0XF8,0X82,0X00,0X86,0X00,0X01,0XFF,0XFC,0X82,0X00,0X86,0X00,0X01,
+    0XFC,0XFE,0X82,0X00,0X86,0X00,0X01,0XFC,0X7F,0X82,0X00,0X86,0X00,0X01,0XFC,0X3F,
+    0X82,0X00,0X86,0X00,0X02,0XFC,0X1F,0X80,0X81,0X00,0X86,0X00,0X02,0XFC,0X0F,0XC0,
+    0X81,0X00,0X86,0X00,0X02,0XFC,0X07,0XC0,0X81,0X00,0X86,0X00,0X02,0XFC,0X07,0XE0,
+    0X81,0X00,0X86,0X00,0X02,0XF8,0X03,0XE0,0X81,0X00,0X86,0X00,0X02,0XF8,0X03,0XF0,
+    0X81,0X00,0X86,0X00,0X02,0XF8,0X01,0XF0,0X81,0X00,0X85,0X00,0X03,0X01,0XF8,0X01,
+    0XF8,0X81,0X00,0X85,0X00,0X03,0X01,0XF8,0X00,0XF8,0X81,0X00,0X85,0X00,0X03,0X01,
+    0XF0,0X00,0XF8,0X81,0X00,0X85,0X00,0X03,0X03,0XF0,0X00,0XF8,0X81,0X00,0X85,0X00,
+    0X03,0X03,0XF0,0X00,0XFC,0X81,0X00,0X85,0X00,0X03,0X07,0XE0,0X00,0X7C,0X81,0X00,
+    0X85,0X00,0X03,0X07,0XE0,0X00,0X7C,0X81,0X00,0X85,0X00,0X03,0X0F,0XC0,0X00,0X7C,
+    0X81,0X00,0X85,0X00,0X03,0X0F,0X80,0X00,0X7C,0X81,0X00,0X85,0X00,0X03,0X1F,0X80,
+    0X00,0X7C,0X81,0X00,0X85,0X00,0X03,0X3F,0X00,0X00,0X7C,0X81,0X00,0X85,0X00,0X03,
+    0X7E,0X00,0X00,0X7C,0X81,0X00,0X85,0X00,0X03,0XFE,0X00,0X00,0X7C,0X81,0X00,0X84,
+    0X00,0X04,0X03,0XFC,0X00,0X00,0X7C,0X81,0X00,0X84,0X00,0X04,0X07,0XF8,0X00,0X00,
+    0X7C,0X81,0X00,0X84,0X00,0X04,0X1F,0XF0,0X00,0X00,0XFC,0X81,0X00,0X81,0X00,0X07,
+    0X03,0X80,0X00,0X7F,0XC0,0X00,0X00,0XFC,0X81,0X00,0X81,0X00,0X07,0X07,0XF0,0X07,
+    0XFF,0X80,0X00,0X00,0XF8,0X81,0X00,0X81,0X00,0X00,0X07,0X80,0XFF,0X80,0X00,0X00,
+    0XF8,0X81,0X00,0X81,0X00,0X07,0X07,0XFF,0XFF,0XFC,0X00,0X00,0X01,0XF8,0X81,0X00,
+    0X81,0X00,0X07,0X07,0XFF,0XFF,0XF0,0X00,0X00,0X01,0XF8,0X81,0X00,0X81,0X00,0X07,
+    0X07,0XFF,0XFF,0X80,0X00,0X00,0X03,0XF0,0X81,0X00,0X81,0X00,0X02,0X07,0XFF,0XFC,
+    0X80,0X00,0X01,0X03,0XF0,0X81,0X00,0X81,0X00,0X01,0X03,0XE0,0X81,0X00,0X01,0X07,
+    0XE0,0X81,0X00,0X81,0X00,0X01,0X03,0XF0,0X81,0X00,0X01,0X0F,0XE0,0X81,0X00,0X81,
+    0X00,0X01,0X03,0XF8,0X81,0X00,0X01,0X0F,0XC0,0X81,0X00,0X81,0X00,0X01,0X01,0XFC,
+    0X81,0X00,0X01,0X1F,0XC0,0X81,0X00,0X82,0X00,0X00,0XFE,0X81,0X00,0X01,0X3F,0X80,
+    0X81,0X00,0X82,0X00,0X00,0XFF,0X81,0X00,0X00,0X7F,0X82,0X00,0X82,0X00,0X01,0X7F,
+    0X80,0X80,0X00,0X00,0XFF,0X82,0X00,0X82,0X00,0X05,0X3F,0XC0,0X00,0X00,0X03,0XFE,
+    0X82,0X00,0X82,0X00,0X05,0X1F,0XF0,0X00,0X00,0X07,0XFC,0X82,0X00,0X82,0X00,0X05,
+    0X0F,0XFC,0X00,0X00,0X1F,0XF8,0X82,0X00,0X82,0X00,0X05,0X07,0XFF,0X00,0X00,0XFF,
+    0XF0,0X82,0X00,0X82,0X00,0X05,0X03,0XFF,0XF0,0X0F,0XFF,0XC0,0X82,0X00,0X83,0X00,
+    0X81,0XFF,0X00,0X80,0X82,0X00,0X83,0X00,0X03,0X7F,0XFF,0XFF,0XFE,0X83,0X00,0X83,
+    0X00,0X03,0X1F,0XFF,0XFF,0XF8,0X83,0X00,0X83,0X00,0X03,0X03,0XFF,0XFF,0XE0,0X83,
+    0X00,0X84,0X00,0X01,0X7F,0XFF,0X84,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+};
+
+// clouds
+static const uint16_t icon_clouds_restarts[] = {
+    0,32,64,128,321,537,697,729,
+};
+static const uint8_t icon_clouds_data[] = {
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X84,0X00,0X01,0X03,0XFE,0X84,0X00,0X84,0X00,0X02,
+    0X3F,0XFF,0XE0,0X83,0X00,0X83,0X00,0X03,0X01,0XFF,0XFF,0XFC,0X83,0X00,0X83,0X00,
+    0X00,0X07,0X80,0XFF,0X83,0X00,0X83,0X00,0X00,0X1F,0X80,0XFF,0X00,0XC0,0X82,0X00,
+    0X83,0X00,0X04,0X3F,0XFF,0X87,0XFF,0XE0,0X82,0X00,0X83,0X00,0X04,0XFF,0XF0,0X00,
+    0X7F,0XF0,0X82,0X00,0X82,0X00,0X05,0X01,0XFF,0X80,0X00,0X0F,0XFC,0X82,0X00,0X82,
+    0X00,0X05,0X03,0XFE,0X00,0X00,0X03,0XFE,0X82,0X00,0X82,0X00,0X05,0X07,0XF8,0X00,
+    0X00,0X01,0XFE,0X82,0X00,0X82,0X00,0X01,0X0F,0XF0,0X80,0X00,0X00,0XFF,0X82,0X00,
+    0X82,0X00,0X01,0X1F,0XE0,0X80,0X00,0X01,0X7F,0X80,0X81,0X00,0X82,0X00,0X01,0X1F,
+    0XC0,0X80,0X00,0X01,0X3F,0XC0,0X81,0X00,0X82,0X00,0X01,0X3F,0X80,0X80,0X00,0X01,
+    0X1F,0XE0,0X81,0X00,0X82,0X00,0X00,0X7F,0X81,0X00,0X01,0X0F,0XE0,0X81,0X00,0X82,
+    0X00,0X00,0X7E,0X81,0X00,0X01,0X1F,0XFF,0X81,0X00,0X81,0X00,0X01,0X01,0XFE,0X81,
+    0X00,0X02,0XFF,0XFF,0XC0,0X80,0X00,0X81,0X00,0X01,0X1F,0XFC,0X80,0X00,0X03,0X01,
+    0XFF,0XFF,0XF0,0X80,0X00,0X81,0X00,0X01,0X7F,0XFC,0X80,0X00,0X03,0X07,0XFF,0XFF,
+    0XFC,0X80,0X00,0X80,0X00,0X02,0X01,0XFF,0XFC,0X80,0X00,0X03,0X0F,0XFF,0XFF,0XFE,
+    0X80,0X00,0X80,0X00,0X02,0X03,0XFF,0XF8,0X80,0X00,0X03,0X1F,0XF8,0X03,0XFF,0X80,
+    0X00,0X80,0X00,0X02,0X07,0XFF,0XF8,0X80,0X00,0X06,0X3F,0XE0,0X00,0XFF,0X80,0X00,
+    0X00,0X80,0X00,0X02,0X07,0XF1,0XF8,0X80,0X00,0X06,0X3F,0XC0,0X00,0X3F,0X80,0X00,
+    0X00,0X80,0X00,0X02,0X0F,0XE1,0XF0,0X80,0X00,0X06,0X3F,0X80,0X00,0X1F,0XC0,0X00,
+    0X00,0X80,0X00,0X02,0X1F,0XC1,0XF0,0X80,0X00,0X06,0X3F,0X00,0X00,0X0F,0XC0,0X00,
+    0X00,0X80,0X00,0X02,0X1F,0X81,0XF0,0X80,0X00,0X06,0X3E,0X00,0X00,0X07,0XE0,0X00,
+    0X00,0X80,0X00,0X02,0X1F,0X01,0XF0,0X80,0X00,0X06,0X1C,0X00,0X00,0X07,0XE0,0X00,
+    0X00,0X80,0X00,0X02,0X3F,0X01,0XF0,0X83,0X00,0X03,0X03,0XF0,0X00,0X00,0X80,0X00,
+    0X02,0X3F,0X01,0XE0,0X83,0X00,0X03,0X03,0XF0,0X00,0X00,0X80,0X00,0X00,0X7E,0X85,
+    0X00,0X03,0X01,0XF0,0X00,0X00,0X80,0X00,0X00,0XFE,0X85,0X00,0X03,0X01,0XF0,0X00,
+    0X00,0X03,0X00,0X00,0X01,0XFE,0X85,0X00,0X03,0X01,0XF0,0X00,0X00,0X03,0X00,0X00,
+    0X03,0XFE,0X85,0X00,0X03,0X01,0XF0,0X00,0X00,0X03,0X00,0X00,0X07,0XF0,0X85,0X00,
+    0X03,0X01,0XF0,0X00,0X00,0X03,0X00,0X00,0X0F,0XE0,0X85,0X00,0X03,0X01,0XF0,0X00,
+    0X00,0X03,0X00,0X00,0X0F,0XC0,0X85,0X00,0X03,0X01,0XF0,0X00,0X00,0X03,0X00,0X00,
+    0X0F,0XC0,0X85,0X00,0X03,0X03,0XF0,0X00,0X00,0X03,0X00,0X00,0X0F,0X80,0X85,0X00,
+    0X03,0X03,0XF0,0X00,0X00,0X03,0X00,0X00,0X0F,0X80,0X85,0X00,0X03,0X07,0XF0,0X00,
+    0X00,0X03,0X00,0X00,0X0F,0X80,0X85,0X00,0X03,0X07,0XE0,0X00,0X00,0X03,0X00,0X00,
+    0X0F,0X80,0X85,0X00,0X03,0X0F,0XE0,0X00,0X00,0X03,0X00,0X00,0X0F,0X80,0X85,0X00,
+    0X03,0X1F,0XC0,0X00,0X00,0X03,0X00,0X00,0X0F,0XC0,0X85,0X00,0X03,0X3F,0XC0,0X00,
+    0X00,0X03,0X00,0X00,0X0F,0XC0,0X85,0X00,0X03,0X7F,0X80,0X00,0X00,0X03,0X00,0X00,
+    0X07,0XF0,0X84,0X00,0X01,0X01,0XFF,0X80,0X00,0X03,0X00,0X00,0X07,0XFC,0X84,0X00,
+    0X01,0X0F,0XFE,0X80,0X00,0X02,0X00,0X00,0X03,0X86,0XFF,0X00,0XFC,0X80,0X00,0X02,
+    0X00,0X00,0X01,0X86,0XFF,0X00,0XF8,0X80,0X00,0X80,0X00,0X86,0XFF,0X00,0XE0,0X80,
+    0X00,0X80,0X00,0X00,0X3F,0X85,0XFF,0X00,0X80,0X80,0X00,0X80,0X00,0X00,0X07,0X84,
+    0XFF,0X00,0XF8,0X81,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+};
+
+// rain
+static const uint16_t icon_rain_restarts[] = {
+    0,32,221,323,471,639,763,879,
+};
+static const uint8_t icon_rain_data[] = {
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X82,0X00,0X06,0X0E,0X00,0X1C,0X00,0X18,0X00,0X30,0X81,0X00,0X82,0X00,
+    0X06,0X1F,0X00,0X3E,0X00,0X7C,0X00,0X7C,0X81,0X00,0X82,0X00,0X06,0X3F,0X00,0X7F,
+    0X00,0X7E,0X00,0XFC,0X81,0X00,0X82,0X00,0X06,0X7F,0X80,0X7F,0X00,0XFE,0X01,0XFC,
+    0X81,0X00,0X82,0X00,0X06,0X7F,0X00,0XFF,0X01,0XFE,0X03,0XFC,0X81,0X00,0X82,0X00,
+    0X06,0XFF,0X01,0XFE,0X03,0XFE,0X03,0XFC,0X81,0X00,0X81,0X00,0X07,0X01,0XFE,0X01,
+    0XFE,0X03,0XFC,0X07,0XF8,0X81,0X00,0X81,0X00,0X07,0X03,0XFE,0X03,0XFC,0X07,0XF8,
+    0X0F,0XF0,0X81,0X00,0X81,0X00,0X07,0X03,0XFC,0X07,0XF8,0X0F,0XF0,0X0F,0XF0,0X81,
+    0X00,0X81,0X00,0X07,0X07,0XF8,0X0F,0XF0,0X1F,0XF0,0X1F,0XE0,0X81,0X00,0X81,0X00,
+    0X07,0X0F,0XF0,0X0F,0XF0,0X1F,0XE0,0X3F,0XC0,0X81,0X00,0X81,0X00,0X07,0X0F,0XF0,
+    0X0F,0XE0,0X1F,0XC0,0X3F,0X80,0X81,0X00,0X81,0X00,0X07,0X0F,0XE0,0X0F,0XC0,0X1F,
+    0X80,0X3F,0X80,0X81,0X00,0X81,0X00,0X06,0X07,0XC0,0X0F,0X80,0X1F,0X80,0X3F,0X82,
+    0X00,0X81,0X00,0X06,0X07,0X80,0X07,0X80,0X0F,0X00,0X1E,0X82,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X84,0X00,0X01,0X1F,0XF0,0X84,0X00,
+    0X83,0X00,0X03,0X03,0XFF,0XFF,0X80,0X83,0X00,0X83,0X00,0X03,0X1F,0XFF,0XFF,0XF0,
+    0X83,0X00,0X83,0X00,0X03,0X7F,0XFF,0XFF,0XFE,0X83,0X00,0X82,0X00,0X00,0X01,0X81,
+    0XFF,0X83,0X00,0X82,0X00,0X00,0X07,0X81,0XFF,0X00,0XC0,0X82,0X00,0X82,0X00,0X00,
+    0X0F,0X81,0XFF,0X00,0XE0,0X82,0X00,0X82,0X00,0X00,0X3F,0X81,0XFF,0X00,0XF8,0X82,
+    0X00,0X82,0X00,0X00,0X7F,0X81,0XFF,0X00,0XFC,0X82,0X00,0X82,0X00,0X82,0XFF,0X00,
+    0XFE,0X82,0X00,0X81,0X00,0X00,0X01,0X83,0XFF,0X82,0X00,0X81,0X00,0X00,0X03,0X83,
+    0XFF,0X00,0X80,0X81,0X00,0X81,0X00,0X00,0X07,0X83,0XFF,0X00,0XC0,0X81,0X00,0X81,
+    0X00,0X00,0X07,0X83,0XFF,0X00,0XC0,0X81,0X00,0X81,0X00,0X00,0X0F,0X83,0XFF,0X00,
+    0XE0,0X81,0X00,0X81,0X00,0X00,0X1F,0X83,0XFF,0X00,0XF0,0X81,0X00,0X81,0X00,0X00,
+    0X1F,0X83,0XFF,0X00,0XF0,0X81,0X00,0X81,0X00,0X00,0X3F,0X83,0XFF,0X00,0XF8,0X81,
+    0X00,0X81,0X00,0X00,0X3F,0X83,0XFF,0X00,0XF8,0X81,0X00,0X81,0X00,0X00,0X7F,0X83,
+    0XFF,0X00,0XFC,0X81,0X00,0X81,0X00,0X00,0X7F,0X83,0XFF,0X00,0XFC,0X81,0X00,0X81,
+    0X00,0X84,0XFF,0X00,0XFE,0X81,0X00,0X81,0X00,0X84,0XFF,0X00,0XFE,0X81,0X00,0X81,
+    0X00,0X84,0XFF,0X00,0XFE,0X81,0X00,0X80,0X00,0X00,0X01,0X85,0XFF,0X81,0X00,0X80,
+    0X00,0X00,0X01,0X85,0XFF,0X81,0X00,0X80,0X00,0X00,0X01,0X85,0XFF,0X81,0X00,0X80,
+    0X00,0X00,0X01,0X85,0XFF,0X81,0X00,0X80,0X00,0X00,0X01,0X85,0XFF,0X81,0X00,0X80,
+    0X00,0X00,0X01,0X85,0XFF,0X81,0X00,0X80,0X00,0X00,0X03,0X85,0XFF,0X81,0X00,0X80,
+    0X00,0X00,0X03,0X85,0XFF,0X00,0X80,0X80,0X00,0X80,0X00,0X00,0X03,0X85,0XFF,0X00,
+    0X80,0X80,0X00,0X80,0X00,0X09,0X03,0XFC,0X07,0XFF,0XFF,0XEF,0XFF,0XE0,0X3F,0X80,
+    0X80,0X00,0X80,0X00,0X09,0X03,0XF0,0X01,0XFF,0XC7,0XE3,0XFF,0X80,0X1F,0X80,0X80,
+    0X00,0X80,0X00,0X08,0X03,0XC0,0X00,0XFF,0X87,0XE1,0XFF,0X00,0X0F,0X81,0X00,0X80,
+    0X00,0X08,0X01,0X80,0X00,0X7F,0X07,0XE0,0XFC,0X00,0X07,0X81,0X00,0X80,0X00,0X08,
+    0X01,0X00,0X00,0X3E,0X07,0XE0,0X7C,0X00,0X03,0X81,0X00,0X83,0X00,0X05,0X1C,0X07,
+    0XE0,0X78,0X00,0X01,0X81,0X00,0X83,0X00,0X03,0X1C,0X07,0XE0,0X38,0X83,0X00,0X83,
+    0X00,0X03,0X08,0X07,0XE0,0X30,0X83,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,
+    0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,
+    0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,
+    0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,
+    0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,
+    0X01,0X07,0XE0,0X84,0X00,0X82,0X00,0X03,0X07,0X00,0X07,0XE0,0X84,0X00,0X82,0X00,
+    0X03,0X0F,0XC0,0X07,0XE0,0X84,0X00,0X82,0X00,0X03,0X0F,0XC0,0X07,0XE0,0X84,0X00,
+    0X82,0X00,0X03,0X1F,0XC0,0X07,0XE0,0X84,0X00,0X82,0X00,0X03,0X1F,0XC0,0X07,0XE0,
+    0X84,0X00,0X82,0X00,0X03,0X1F,0XC0,0X07,0XE0,0X84,0X00,0X82,0X00,0X03,0X1F,0XC0,
+    0X07,0XE0,0X84,0X00,0X82,0X00,0X03,0X1F,0XC0,0X07,0XE0,0X84,0X00,0X82,0X00,0X03,
+    0X0F,0XC0,0X0F,0XE0,0X84,0X00,0X82,0X00,0X03,0X0F,0XE0,0X0F,0XE0,0X84,0X00,0X82,
+    0X00,0X03,0X0F,0XE0,0X1F,0XE0,0X84,0X00,0X82,0X00,0X03,0X0F,0XF8,0X3F,0XE0,0X84,
+    0X00,0X82,0X00,0X03,0X0F,0XFF,0XFF,0XC0,0X84,0X00,0X82,0X00,0X03,0X07,0XFF,0XFF,
+    0XC0,0X84,0X00,0X82,0X00,0X03,0X03,0XFF,0XFF,0X80,0X84,0X00,0X82,0X00,0X02,0X01,
+    0XFF,0XFF,0X85,0X00,0X83,0X00,0X01,0XFF,0XFE,0X85,0X00,0X83,0X00,0X01,0X7F,0XFC,
+    0X85,0X00,0X83,0X00,0X01,0X1F,0XF0,0X85,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,
+    0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+};
+
+// thunderstorm
+static const uint16_t icon_thunderstorm_restarts[] = {
+    0,32,88,238,385,533,658,764,
+};
+static const uint8_t icon_thunderstorm_data[] = {
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X83,0X00,0X00,0X3F,0X80,0XFF,
+    0X00,0XFE,0X82,0X00,0X83,0X00,0X00,0X3F,0X80,0XFF,0X00,0XFC,0X82,0X00,0X83,0X00,
+    0X00,0X7F,0X80,0XFF,0X00,0XFC,0X82,0X00,0X83,0X00,0X00,0X7F,0X80,0XFF,0X00,0XF8,
+    0X82,0X00,0X83,0X00,0X00,0X7F,0X80,0XFF,0X00,0XF0,0X82,0X00,0X83,0X00,0X81,0XFF,
+    0X00,0XF0,0X82,0X00,0X83,0X00,0X81,0XFF,0X00,0XE0,0X82,0X00,0X83,0X00,0X81,0XFF,
+    0X00,0XC0,0X82,0X00,0X82,0X00,0X00,0X01,0X81,0XFF,0X00,0XC0,0X82,0X00,0X82,0X00,
+    0X00,0X01,0X81,0XFF,0X00,0X80,0X82,0X00,0X82,0X00,0X00,0X03,0X81,0XFF,0X83,0X00,
+    0X82,0X00,0X00,0X03,0X81,0XFF,0X83,0X00,0X82,0X00,0X00,0X03,0X80,0XFF,0X00,0XFE,
+    0X83,0X00,0X82,0X00,0X00,0X07,0X80,0XFF,0X00,0XFE,0X83,0X00,0X82,0X00,0X00,0X07,
+    0X80,0XFF,0X00,0XFC,0X83,0X00,0X82,0X00,0X00,0X07,0X80,0XFF,0X00,0XF8,0X83,0X00,
+    0X82,0X00,0X00,0X0F,0X80,0XFF,0X00,0XF8,0X83,0X00,0X82,0X00,0X00,0X0F,0X80,0XFF,
+    0X00,0XF0,0X83,0X00,0X82,0X00,0X00,0X0F,0X80,0XFF,0X00,0XE0,0X83,0X00,0X82,0X00,
+    0X00,0X1F,0X80,0XFF,0X00,0XE0,0X83,0X00,0X82,0X00,0X00,0X1F,0X80,0XFF,0X00,0XC0,
+    0X83,0X00,0X82,0X00,0X00,0X3F,0X80,0XFF,0X00,0X80,0X83,0X00,0X82,0X00,0X00,0X3F,
+    0X80,0XFF,0X00,0X80,0X83,0X00,0X82,0X00,0X00,0X3F,0X80,0XFF,0X84,0X00,0X82,0X00,
+    0X03,0X7F,0XFF,0XFF,0XFE,0X84,0X00,0X82,0X00,0X03,0X7F,0XFF,0XFF,0XFE,0X84,0X00,
+    0X82,0X00,0X03,0X7F,0XFF,0XFF,0XFC,0X84,0X00,0X82,0X00,0X80,0XFF,0X00,0XF8,0X84,
+    0X00,0X82,0X00,0X83,0XFF,0X00,0XF8,0X81,0X00,0X82,0X00,0X83,0XFF,0X00,0XF8,0X81,
+    0X00,0X81,0X00,0X00,0X01,0X83,0XFF,0X00,0XF0,0X81,0X00,0X81,0X00,0X00,0X01,0X83,
+    0XFF,0X00,0XE0,0X81,0X00,0X81,0X00,0X00,0X03,0X83,0XFF,0X00,0XC0,0X81,0X00,0X81,
+    0X00,0X00,0X03,0X83,0XFF,0X00,0X80,0X81,0X00,0X81,0X00,0X00,0X03,0X83,0XFF,0X82,
+    0X00,0X81,0X00,0X00,0X07,0X82,0XFF,0X00,0XFE,0X82,0X00,0X81,0X00,0X00,0X07,0X82,
+    0XFF,0X00,0XFC,0X82,0X00,0X81,0X00,0X00,0X07,0X82,0XFF,0X00,0XF8,0X82,0X00,0X81,
+    0X00,0X00,0X0F,0X82,0XFF,0X00,0XF0,0X82,0X00,0X81,0X00,0X00,0X0F,0X82,0XFF,0X00,
+    0XE0,0X82,0X00,0X81,0X00,0X00,0X0F,0X82,0XFF,0X00,0XC0,0X82,0X00,0X81,0X00,0X00,
+    0X1F,0X82,0XFF,0X00,0X80,0X82,0X00,0X81,0X00,0X00,0X1F,0X82,0XFF,0X83,0X00,0X84,
+    0X00,0X02,0XFF,0XFF,0XFE,0X83,0X00,0X83,0X00,0X03,0X01,0XFF,0XFF,0XFC,0X83,0X00,
+    0X83,0X00,0X03,0X01,0XFF,0XFF,0XF8,0X83,0X00,0X83,0X00,0X03,0X03,0XFF,0XFF,0XF0,
+    0X83,0X00,0X83,0X00,0X03,0X03,0XFF,0XFF,0XE0,0X83,0X00,0X83,0X00,0X03,0X07,0XFF,
+    0XFF,0XC0,0X83,0X00,0X83,0X00,0X03,0X07,0XFF,0XFF,0X80,0X83,0X00,0X83,0X00,0X02,
+    0X07,0XFF,0XFF,0X84,0X00,0X83,0X00,0X02,0X0F,0XFF,0XFF,0X84,0X00,0X83,0X00,0X02,
+    0X0F,0XFF,0XFC,0X84,0X00,0X83,0X00,0X02,0X1F,0XFF,0XF8,0X84,0X00,0X83,0X00,0X02,
+    0X1F,0XFF,0XF8,0X84,0X00,0X83,0X00,0X02,0X3F,0XFF,0XF0,0X84,0X00,0X83,0X00,0X02,
+    0X3F,0XFF,0XE0,0X84,0X00,0X83,0X00,0X02,0X7F,0XFF,0XC0,0X84,0X00,0X83,0X00,0X02,
+    0X7F,0XFF,0X80,0X84,0X00,0X83,0X00,0X01,0X7F,0XFF,0X85,0X00,0X83,0X00,0X01,0XFF,
+    0XFE,0X85,0X00,0X83,0X00,0X01,0XFF,0XFC,0X85,0X00,0X82,0X00,0X02,0X01,0XFF,0XF8,
+    0X85,0X00,0X82,0X00,0X02,0X01,0XFF,0XF0,0X85,0X00,0X82,0X00,0X02,0X03,0XFF,0XE0,
+    0X85,0X00,0X82,0X00,0X02,0X03,0XFF,0XC0,0X85,0X00,0X82,0X00,0X02,0X03,0XFF,0X80,
+    0X85,0X00,0X82,0X00,0X01,0X07,0XFF,0X86,0X00,0X82,0X00,0X01,0X07,0XFE,0X86,0X00,
+    0X82,0X00,0X01,0X0F,0XFC,0X86,0X00,0X82,0X00,0X01,0X0F,0XF8,0X86,0X00,0X82,0X00,
+    0X01,0X1F,0XF0,0X86,0X00,0X82,0X00,0X01,0X1F,0XE0,0X86,0X00,0X82,0X00,0X01,0X1F,
+    0XC0,0X86,0X00,0X82,0X00,0X01,0X3F,0X80,0X86,0X00,0X82,0X00,0X00,0X3F,0X87,0X00,
+    0X82,0X00,0X00,0X7E,0X87,0X00,0X82,0X00,0X00,0X7C,0X87,0X00,0X82,0X00,0X00,0XF8,
+    0X87,0X00,0X82,0X00,0X00,0XF0,0X87,0X00,0X82,0X00,0X00,0XE0,0X87,0X00,0X81,0X00,
+    0X01,0X01,0XC0,0X87,0X00,0X81,0X00,0X01,0X01,0X80,0X87,0X00,0X81,0X00,0X00,0X03,
+    0X88,0X00,0X81,0X00,0X00,0X02,0X88,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,
+};
+
+// snow
+static const uint16_t icon_snow_restarts[] = {
+    0,32,84,244,438,632,794,846,
+};
+static const uint8_t icon_snow_data[] = {
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X84,0X00,0X01,0X01,0X80,0X84,0X00,0X84,
+    0X00,0X01,0X03,0XC0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,
+    0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,
+    0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X83,0X00,0X03,0X06,0X07,0XE0,0X60,
+    0X83,0X00,0X83,0X00,0X03,0X0F,0X87,0XE1,0XF0,0X83,0X00,0X83,0X00,0X03,0X1F,0XE7,
+    0XE7,0XF8,0X83,0X00,0X83,0X00,0X03,0X1F,0XFF,0XFF,0XF8,0X83,0X00,0X83,0X00,0X03,
+    0X0F,0XFF,0XFF,0XF0,0X83,0X00,0X82,0X00,0X05,0X0F,0X07,0XFF,0XFF,0XE0,0XF0,0X82,
+    0X00,0X82,0X00,0X05,0X0F,0X81,0XFF,0XFF,0X81,0XF0,0X82,0X00,0X82,0X00,0X05,0X0F,
+    0X80,0X7F,0XFE,0X01,0XF0,0X82,0X00,0X82,0X00,0X05,0X0F,0X80,0X3F,0XFC,0X01,0XF0,
+    0X82,0X00,0X82,0X00,0X05,0X0F,0X80,0X0F,0XF0,0X01,0XF0,0X82,0X00,0X81,0X00,0X07,
+    0X78,0X0F,0X80,0X07,0XE0,0X01,0XF0,0X1E,0X81,0X00,0X81,0X00,0X07,0X7E,0X0F,0X80,
+    0X07,0XE0,0X01,0XF0,0X7E,0X81,0X00,0X81,0X00,0X07,0X7F,0X8F,0X80,0X07,0XE0,0X01,
+    0XF1,0XFE,0X81,0X00,0X81,0X00,0X07,0X7F,0XCF,0X80,0X07,0XE0,0X01,0XF3,0XFE,0X81,
+    0X00,0X81,0X00,0X07,0X7F,0XFF,0X80,0X07,0XE0,0X01,0XFF,0XFE,0X81,0X00,0X81,0X00,
+    0X07,0X1F,0XFF,0X80,0X07,0XE0,0X01,0XFF,0XF8,0X81,0X00,0X81,0X00,0X07,0X07,0XFF,
+    0X80,0X07,0XE0,0X01,0XFF,0XF0,0X81,0X00,0X81,0X00,0X07,0X03,0XFF,0XC0,0X07,0XE0,
+    0X03,0XFF,0XC0,0X81,0X00,0X82,0X00,0X05,0XFF,0XE0,0X07,0XE0,0X07,0XFF,0X82,0X00,
+    0X82,0X00,0X06,0XFF,0XF8,0X07,0XE0,0X1F,0XFF,0X80,0X81,0X00,0X81,0X00,0X07,0X03,
+    0XFF,0XFE,0X07,0XE0,0X7F,0XFF,0XC0,0X81,0X00,0X81,0X00,0X07,0X0F,0XFF,0XFF,0X87,
+    0XE1,0XFF,0XFF,0XF0,0X81,0X00,0X81,0X00,0X07,0X3F,0XF9,0XFF,0XC7,0XE3,0XFF,0X9F,
+    0XFC,0X81,0X00,0X81,0X00,0X07,0X3F,0XE0,0X7F,0XF7,0XEF,0XFE,0X0F,0XFC,0X81,0X00,
+    0X81,0X00,0X07,0X3F,0XC0,0X3F,0XFF,0XFF,0XFC,0X03,0XFC,0X81,0X00,0X81,0X00,0X07,
+    0X3F,0X00,0X0F,0XFF,0XFF,0XF0,0X00,0XFC,0X81,0X00,0X81,0X00,0X07,0X3C,0X00,0X03,
+    0XFF,0XFF,0XC0,0X00,0X7C,0X81,0X00,0X83,0X00,0X02,0X01,0XFF,0XFF,0X84,0X00,0X84,
+    0X00,0X01,0X7F,0XFE,0X84,0X00,0X84,0X00,0X01,0X3F,0XFC,0X84,0X00,0X84,0X00,0X01,
+    0XFF,0XFF,0X84,0X00,0X81,0X00,0X07,0X3C,0X00,0X03,0XFF,0XFF,0XC0,0X00,0X3C,0X81,
+    0X00,0X81,0X00,0X07,0X3F,0X00,0X0F,0XFF,0XFF,0XE0,0X00,0XFC,0X81,0X00,0X81,0X00,
+    0X07,0X3F,0XC0,0X1F,0XFF,0XFF,0XF8,0X03,0XFC,0X81,0X00,0X81,0X00,0X07,0X3F,0XE0,
+    0X7F,0XF7,0XEF,0XFE,0X07,0XFC,0X81,0X00,0X81,0X00,0X07,0X3F,0XF9,0XFF,0XE7,0XE7,
+    0XFF,0X9F,0XFC,0X81,0X00,0X81,0X00,0X07,0X1F,0XFF,0XFF,0X87,0XE1,0XFF,0XFF,0XF8,
+    0X81,0X00,0X81,0X00,0X07,0X07,0XFF,0XFE,0X07,0XE0,0X7F,0XFF,0XE0,0X81,0X00,0X81,
+    0X00,0X07,0X01,0XFF,0XF8,0X07,0XE0,0X1F,0XFF,0X80,0X81,0X00,0X82,0X00,0X05,0XFF,
+    0XF0,0X07,0XE0,0X0F,0XFF,0X82,0X00,0X81,0X00,0X07,0X01,0XFF,0XC0,0X07,0XE0,0X03,
+    0XFF,0X80,0X81,0X00,0X81,0X00,0X07,0X07,0XFF,0X80,0X07,0XE0,0X01,0XFF,0XE0,0X81,
+    0X00,0X81,0X00,0X07,0X1F,0XFF,0X80,0X07,0XE0,0X01,0XFF,0XF8,0X81,0X00,0X81,0X00,
+    0X07,0X7F,0XFF,0X80,0X07,0XE0,0X01,0XFF,0XFC,0X81,0X00,0X81,0X00,0X07,0X7F,0XEF,
+    0X80,0X07,0XE0,0X01,0XF7,0XFE,0X81,0X00,0X81,0X00,0X07,0X7F,0X8F,0X80,0X07,0XE0,
+    0X01,0XF1,0XFE,0X81,0X00,0X81,0X00,0X07,0X7F,0X0F,0X80,0X07,0XE0,0X01,0XF0,0XFE,
+    0X81,0X00,0X81,0X00,0X07,0X7C,0X0F,0X80,0X07,0XE0,0X01,0XF0,0X3E,0X81,0X00,0X82,
+    0X00,0X05,0X0F,0X80,0X07,0XE0,0X01,0XF0,0X82,0X00,0X82,0X00,0X05,0X0F,0X80,0X1F,
+    0XF8,0X01,0XF0,0X82,0X00,0X82,0X00,0X05,0X0F,0X80,0X7F,0XFE,0X01,0XF0,0X82,0X00,
+    0X82,0X00,0X05,0X0F,0X81,0XFF,0XFF,0X81,0XF0,0X82,0X00,0X82,0X00,0X05,0X0F,0X03,
+    0XFF,0XFF,0XC1,0XF0,0X82,0X00,0X82,0X00,0X05,0X02,0X0F,0XFF,0XFF,0XF0,0X40,0X82,
+    0X00,0X83,0X00,0X03,0X1F,0XFF,0XFF,0XF0,0X83,0X00,0X83,0X00,0X03,0X1F,0XF7,0XE7,
+    0XF8,0X83,0X00,0X83,0X00,0X03,0X0F,0XC7,0XE3,0XF0,0X83,0X00,0X83,0X00,0X03,0X0F,
+    0X07,0XE0,0XF0,0X83,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,
+    0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X07,0XE0,0X84,
+    0X00,0X84,0X00,0X01,0X07,0XE0,0X84,0X00,0X84,0X00,0X01,0X03,0XC0,0X84,0X00,0X84,
+    0X00,0X01,0X03,0X80,0X84,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+};
+
+// mist
+static const uint16_t icon_mist_restarts[] = {
+    0,32,64,96,128,200,280,312,
+};
+static const uint8_t icon_mist_data[] = {
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X80,0X00,0X00,0X03,0X85,0XFF,0X00,0XFE,0X80,0X00,0X80,0X00,0X00,0X07,0X85,0XFF,
+    0X00,0XFE,0X80,0X00,0X80,0X00,0X00,0X07,0X85,0XFF,0X00,0XFE,0X80,0X00,0X80,0X00,
+    0X00,0X07,0X85,0XFF,0X00,0XFE,0X80,0X00,0X80,0X00,0X00,0X03,0X85,0XFF,0X00,0XFE,
+    0X80,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X80,0X00,0X00,0X3F,0X85,0XFF,
+    0X00,0X80,0X80,0X00,0X80,0X00,0X00,0X7F,0X85,0XFF,0X00,0XC0,0X80,0X00,0X80,0X00,
+    0X00,0X7F,0X85,0XFF,0X00,0XE0,0X80,0X00,0X80,0X00,0X00,0X7F,0X85,0XFF,0X00,0XE0,
+    0X80,0X00,0X80,0X00,0X00,0X7F,0X85,0XFF,0X00,0XC0,0X80,0X00,0X80,0X00,0X00,0X3F,
+    0X85,0XFF,0X00,0XC0,0X80,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+    0X8D,0X00,0X8D,0X00,0X8D,0X00,0X8D,0X00,
+};
+
+const COMPRESSED_ASSET Weather_Icons[7] = {
+    {128, 128, 1027, icon_clear_day_restarts, icon_clear_day_data},
+    {128, 128, 684, icon_clear_night_restarts, icon_clear_night_data},
+    {128, 128, 761, icon_clouds_restarts, icon_clouds_data},
+    {128, 128, 911, icon_rain_restarts, icon_rain_data},
+    {128, 128, 804, icon_thunderstorm_restarts, icon_thunderstorm_data},
+    {128, 128, 878, icon_snow_restarts, icon_snow_data},
+    {128, 128, 344, icon_mist_restarts, icon_mist_data},
+};
+
+#endif
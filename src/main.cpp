@@ -10,11 +10,37 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <time.h>
+#include <sys/time.h>
 #include "EPD.h"
-#include "icons.h"
+#include "icons_rle.h"
+#include "AssetPack.h"
+#include "ImageLoader.h"
+#include <LittleFS.h>
 #include "config.h"
 #include "../test/testdata.h" // data for offline test
-#include <map>
+#include "Forecast.h"
+#include "ForecastCache.h"
+#include "ArenaAllocator.h"
+#include "WiFiConnect.h"
+#include "RetryPolicy.h"
+#include "WakeScheduler.h"
+#include "Pipeline.h"
+#include "ForecastView.h"
+#include "FrameOps.h"
+#include "FrameCodec.h"
+#include "WakeProfile.h"
+#include "ClockGovernor.h"
+#include "Battery.h"
+#include "Cadence.h"
+#include "StateStore.h"
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+#if __has_include(<esp_app_desc.h>)
+#include <esp_app_desc.h>
+#else
+#include <esp_ota_ops.h>
+#endif
+#include <driver/gpio.h>
 
 //=============================================================================
 // Constants
@@ -25,37 +51,187 @@ const bool TEST_MODE = false;      // Test mode (uses test data instead of the A
 
 // Display Settings
 const size_t FORECAST_COUNT = 5;   // Number of forecast periods to display
+const uint8_t FORECAST_HOUR_OFFSETS[FORECAST_COUNT] = {0, 3, 6, 9, 12};  // Hours from now of each period
+const uint8_t ALL_SLOTS = (1 << FORECAST_COUNT) - 1;  // Mask of every forecast column
+const uint8_t RENDER_WORKERS = 2;  // Workers drawing tiles of a frame, one per core
+const uint8_t RENDER_TILES = 2;    // Tiles per frame
+const uint16_t MAX_PARTIAL_UPDATES = 24;             // Full refresh after this many partial updates, clears ghosting
+const uint32_t PANEL_STATE_MAGIC = 0x504E4C32;       // "PNL2"
+
+// Forecast Cache Settings
+#ifndef FORECAST_MAX_AGE_MINUTES
+#define FORECAST_MAX_AGE_MINUTES 360  // Fetch again once the cached forecast is this old
+#endif
+#ifndef RETRY_INTERVAL_MINUTES
+#define RETRY_INTERVAL_MINUTES 15     // Wake-up interval after the first failed update, doubled after each failure
+#endif
+#ifndef WAKE_ALIGN_MINUTES
+#define WAKE_ALIGN_MINUTES 60         // Refresh on multiples of this many minutes past the hour, 0 to disable
+#endif
+#ifndef CADENCE_MIN_MINUTES
+#define CADENCE_MIN_MINUTES INTERVAL_IN_MINUTES  // Wake interval while the forecast changes a lot
+#endif
+#ifndef CADENCE_MAX_MINUTES
+#define CADENCE_MAX_MINUTES CADENCE_MIN_MINUTES  // Wake interval while the forecast is stable, fixed unless set
+#endif
+#ifndef FORECAST_MIN_AGE_MINUTES
+#define FORECAST_MIN_AGE_MINUTES 120  // Fetch again once a volatile forecast is this old
+#endif
+
+// State Store Settings
+const char* const STATE_NVS_NAMESPACE = "state";  // Flash copies of the mirrored records, e.g. the forecast cache
 
 // E-Paper Settings
 const int EPD_BUFFER_SIZE = 27200; // Size of E-Paper display buffer
+const int EPD_POWER_PIN = 7;       // GPIO pin for E-Paper power control
+const int EPD_SIGNAL_PINS[] = {SCK, MOSI, RES, DC, CS};  // Lines driven by the ESP32, low while the panel is off
+const uint32_t OLD_SHUTDOWN_DELAY_MS = 4000;  // Fixed wait the shutdown used to take, for the savings report
+const uint16_t EPD_ROW_BYTES = EPD_W / 8;  // Bytes per row of the display buffer
+
+// Frame Snapshot Settings
+const size_t FRAME_SNAPSHOT_CAPACITY = 4096;           // RTC bytes for the encoded frame on the panel
+const uint32_t FRAME_SNAPSHOT_MAGIC = 0x46524D31;      // "FRM1"
+const char* const FRAME_SNAPSHOT_PATH = "/frame.bin";  // Flash slot for frames too large for RTC memory
+
+// Wake Profile Settings, Used When Built With -DWAKE_PROFILE
+#ifdef WAKE_PROFILE
+const WakeCurrents WAKE_CURRENTS = {
+  40.0f,   // Awake, CPU at full clock
+  0.03f,   // Deep sleep, whole board
+  // Extra current in each phase: boot, wifi, http, receive, parse, raster, transfer, busy, shutdown
+  {0.0f, 90.0f, 70.0f, 70.0f, 0.0f, 0.0f, 2.0f, 6.0f, 0.0f}
+};
+const int WAKE_PROFILE_BUTTON_PIN = 0;  // Hold BOOT at the end of a wake to print the whole wake log
+#endif
+
+// Update Cadence Settings
+#ifdef QUIET_HOURS
+const QuietWindow QUIET_WINDOWS[] = {QUIET_HOURS};
+const uint8_t QUIET_WINDOW_COUNT = sizeof(QUIET_WINDOWS) / sizeof(QUIET_WINDOWS[0]);
+#else
+const QuietWindow* const QUIET_WINDOWS = NULL;
+const uint8_t QUIET_WINDOW_COUNT = 0;
+#endif
+const CadenceConfig CADENCE_CONFIG = {
+  CADENCE_MIN_MINUTES * 60UL, CADENCE_MAX_MINUTES * 60UL,
+  FORECAST_MIN_AGE_MINUTES * 60UL, FORECAST_MAX_AGE_MINUTES * 60UL,
+  12,     // Hours of the series shown, up to the last forecast column
+  8,      // Volatility score of a stable forecast, about a daily temperature swing
+  24,     // Volatility score of a fully volatile forecast
+  QUIET_WINDOWS, QUIET_WINDOW_COUNT,
+  TIMEZONE_OFFSET * 3600
+};
+
+// Battery Settings
+#ifndef BATTERY_ADC_PIN
+#define BATTERY_ADC_PIN -1            // ADC pin of the battery voltage divider, -1 without a battery monitor
+#endif
+#ifndef BATTERY_DIVIDER_RATIO
+#define BATTERY_DIVIDER_RATIO 2.0f    // Battery voltage over the voltage at the pin
+#endif
+const int BATTERY_SAMPLES = 16;       // ADC samples averaged per wake
+const BatteryCurvePoint BATTERY_CURVE[] = {  // Single-cell LiPo at light load
+  {4200, 100}, {4100, 90}, {4000, 79}, {3900, 64}, {3800, 48}, {3750, 38},
+  {3700, 27}, {3650, 16}, {3600, 9}, {3500, 4}, {3300, 0}
+};
+const BatteryStep BATTERY_STEPS[] = {
+  // Below %, interval multiplier, partial updates between full refreshes
+  {30, 2, 48},
+  {15, 4, 96},
+  {5, 12, UINT16_MAX}   // Full refreshes only when the panel content is unknown
+};
+const BatteryPolicy BATTERY_POLICY = {
+  BATTERY_CURVE, sizeof(BATTERY_CURVE) / sizeof(BATTERY_CURVE[0]),
+  BATTERY_STEPS, sizeof(BATTERY_STEPS) / sizeof(BATTERY_STEPS[0]),
+  5,      // Capacity rise in % needed to leave a step
+  4350    // Voltage in mV at or above which the board runs on USB
+};
+
+// CPU Clock Settings
+const ClockPolicy CLOCK_POLICY = {
+  240,     // High clock in MHz, for compute and bus bursts
+  80,      // Low clock in MHz, the lowest Wi-Fi allows
+  true,    // Light sleep while idle at the low clock
+  // Level of each phase: boot, wifi, http, receive, parse, raster, transfer, busy, shutdown
+  {CLOCK_LOW, CLOCK_LOW, CLOCK_LOW, CLOCK_LOW, CLOCK_HIGH, CLOCK_HIGH, CLOCK_HIGH, CLOCK_LOW, CLOCK_LOW}
+};
+
+// Memory Settings
+const size_t WAKE_ARENA_SIZE = 256 * 1024;         // Per-wake arena in PSRAM
+const size_t WAKE_ARENA_FALLBACK_SIZE = 48 * 1024; // Per-wake arena in internal RAM if PSRAM is unavailable
+const size_t URL_BUFFER_SIZE = 256;                // Buffer for the request URL
+
+static_assert(EPD_BUFFER_SIZE == EPD_ROW_BYTES * EPD_H, "the display buffer must hold one frame");
+static_assert(FORECAST_COUNT == FORECAST_VIEW_COLUMNS, "the layout must have a column per forecast period");
+
+// Pipeline Settings
+const int NETWORK_CORE = 0;                  // Core of the WiFi driver, runs the network stage
+const int RENDER_CORE = 1;                   // Core of setup(), runs the parse and render stages
+const uint32_t STAGE_STACK_SIZE = 8192;      // Stack of each stage task in bytes
+const size_t CHUNK_QUEUE_DEPTH = 4;          // Body chunks in flight from the network stage to the parse stage,
+                                             // in internal RAM outside the arena
+const size_t SLOT_QUEUE_DEPTH = FORECAST_COUNT + 1;  // Every forecast column plus the end marker
+const uint32_t STAGE_TIMEOUT_MS = 30000;     // A stage gives up when its input stalls this long
+
+// Custom Image Settings (PBM P4, grayscale PGM P5 or 1-bpp BMP files on LittleFS)
+const char* const CUSTOM_ICON_DIR = "/icons";          // Icons named after WEATHER_ICON_NAMES, e.g. /icons/rain.pbm
+const char* const CUSTOM_BACKGROUND = "/background";   // Full-screen background, e.g. /background.bmp
+const char* const CUSTOM_IMAGE_EXTENSIONS[] = {".pbm", ".pgm", ".bmp"};
 
 //=============================================================================
 // Type Definitions
 //=============================================================================
 
 /**
- * Weather icon enumeration
- * Maps to indices in the Weather_Num array in icons.h
+ * Forecast column passed from the parse stage to the render stage
  */
-enum WeatherIconNumber {
-  ICON_CLEAR_DAY = 0,
-  ICON_CLEAR_NIGHT = 1,
-  ICON_CLOUDS = 2,
-  ICON_RAIN = 3,
-  ICON_THUNDERSTORM = 4,
-  ICON_SNOW = 5,
-  ICON_MIST = 6
+struct SlotMessage {
+  int8_t index;       // Column index, -1 at the end of the forecast
+  ForecastInfo info;  // Forecast of the column
 };
 
 /**
- * Forecast information structure
- * Stores weather forecast data for a specific time period
+ * State shared by the stages of one update
+ * Each field is written by one stage and read after it has passed an
+ * item or end marker downstream, or after Pipe_Run has returned.
  */
-struct ForecastInfo {
-  String time;       // Time (HH:MM)
-  int iconNumber;    // Weather icon number
-  float temperature; // Temperature (C or F depending on TEMPERATURE_UNIT)
-  float pop;         // Probability of precipitation (%)
+struct UpdatePipeline {
+  const char* url;       // Request URL, NULL to use the test data
+  PipeQueue* chunks;     // Response body, network stage to parse stage
+  PipeQueue* slots;      // Forecast columns, parse stage to render stage
+  int httpCode;          // HTTP status code or RETRY_CODE_*, set by the network stage
+  int32_t retryAfter;    // Retry-After of the response, -1 if absent
+  int32_t serverTime;    // Date of the response (UTC), 0 if absent
+  int64_t serverLocalUs; // Local clock when the response headers arrived
+  bool parsed;           // Set by the parse stage when the whole hourly series was read
+  ForecastCache cache;   // Filled by the parse stage, replaces forecastCache only on success
+};
+
+/**
+ * Forecast columns shown on the panel
+ * Kept across deep sleep to skip unchanged updates and to rebuild the
+ * previous frame for partial updates.
+ */
+struct PanelState {
+  uint32_t magic;                               // PANEL_STATE_MAGIC when the panel shows these columns
+  uint16_t partialUpdates;                      // Partial updates since the last full refresh
+  int8_t batteryBars;                           // Bars of the battery glyph shown, -1 for none
+  uint32_t fingerprints[FORECAST_COUNT];        // Forecast_Fingerprint of each column
+  ForecastSlotText slots[FORECAST_COUNT];       // Text of each column
+};
+
+/**
+ * Encoded copy of the frame on the panel
+ * Kept across deep sleep, so a partial update can restore the old image
+ * instead of rendering it again. Frames that do not fit are kept in the
+ * flash slot.
+ */
+struct FrameSnapshot {
+  uint32_t magic;                               // FRAME_SNAPSHOT_MAGIC when the panel shows this frame
+  uint32_t checksum;                            // FNV-1a hash of the encoded frame
+  uint16_t length;                              // Encoded size in bytes
+  bool inFlash;                                 // Encoded frame is in FRAME_SNAPSHOT_PATH rather than data
+  uint8_t data[FRAME_SNAPSHOT_CAPACITY];
 };
 
 //=============================================================================
@@ -63,139 +239,843 @@ struct ForecastInfo {
 //=============================================================================
 
 /**
- * Weather mapping table
- * Maps OpenWeatherMap icon codes to our icon enumeration
- */
-std::map<String, WeatherIconNumber> WEATHER_MAPPINGS = {
-  {"01d", ICON_CLEAR_DAY},
-  {"01n", ICON_CLEAR_NIGHT},
-  {"02d", ICON_CLOUDS},
-  {"02n", ICON_CLOUDS},
-  {"03d", ICON_CLOUDS},
-  {"03n", ICON_CLOUDS},
-  {"04d", ICON_CLOUDS},
-  {"04n", ICON_CLOUDS},
-  {"09d", ICON_RAIN},
-  {"09n", ICON_RAIN},
-  {"10d", ICON_RAIN},
-  {"10n", ICON_RAIN},
-  {"11d", ICON_THUNDERSTORM},
-  {"11n", ICON_THUNDERSTORM},
-  {"13d", ICON_SNOW},
-  {"13n", ICON_SNOW},
-  {"50d", ICON_MIST},
-  {"50n", ICON_MIST}
+ * Asset pack names of the weather icons
+ * Indexed by WeatherIconNumber
+ */
+const char* const WEATHER_ICON_NAMES[ICON_COUNT] = {
+  "clear_day",
+  "clear_night",
+  "clouds",
+  "rain",
+  "thunderstorm",
+  "snow",
+  "mist"
+};
+
+/**
+ * Asset pack names and sizes of the fonts used by EPD_ShowString
+ */
+const struct {
+  const char* name;
+  uint16_t size;
+} FONT_ASSETS[] = {
+  {"font24", 24},
+  {"font36", 36},
+  {"font44", 44}
 };
 
 //=============================================================================
 // Global Variables
 //=============================================================================
 
-// E-Paper Display Buffer
-uint8_t ImageBW[EPD_BUFFER_SIZE];
+// E-Paper Display Buffer, Aligned for the FrameOps Vector Kernels
+alignas(FRAMEOPS_ALIGN) uint8_t ImageBW[EPD_BUFFER_SIZE];
+
+// Per-Wake Arena for the JSON Documents and the Request URL
+ARENA wakeArena;
 
 // API Related Variables
-String jsonBuffer;
-int httpResponseCode = 0;
+int32_t retryAfterSeconds = -1;   // Retry-After of the last response, -1 if absent
+
+// Result of This Wake's Update: HTTP status code or RETRY_CODE_*
+int updateResult = RETRY_CODE_NO_NETWORK;
+
+// Consecutive Update Failures, Kept Across Deep Sleep
+RTC_DATA_ATTR RetryState retryState;
+
+// Clock Calibration and Wake-Up Timing, Kept Across Deep Sleep
+RTC_DATA_ATTR WakeSchedule wakeSchedule;
 
 // Array to Store Forecast Data
 ForecastInfo hourlyForecasts[FORECAST_COUNT];
 
+// Hourly Series of the Last Response, Kept Across Deep Sleep
+RTC_DATA_ATTR ForecastCache forecastCache;
+
+// Forecast Columns Shown on the Panel
+RTC_DATA_ATTR PanelState panelState;
+
+// Frame Shown on the Panel
+RTC_DATA_ATTR FrameSnapshot frameSnapshot;
+
+// Battery Voltage and Capacity, Kept Across Deep Sleep
+RTC_DATA_ATTR BatteryState batteryState;
+
+// Bars of the Battery Glyph to Draw, -1 Without a Battery Monitor
+int8_t batteryBars = -1;
+
+// E-Paper Power, Switched on Only When the Panel is Used
+bool panelPowered = false;
+uint32_t panelPowerOnMs = 0;
+uint32_t panelPoweredMs = 0;  // On time, set when switched off
+
+#ifdef WAKE_PROFILE
+// Timings of the Last Wakes, Kept Across Deep Sleep
+RTC_DATA_ATTR WakeProfileLog wakeProfileLog;
+#endif
+
+// Checks of the State Kept Across Deep Sleep
+RTC_DATA_ATTR StateStore stateStore;
+StateRecord stateRecords[STATE_STORE_MAX_RECORDS];
+int stateRecordCount = 0;
+StateBackend stateBackend;
+
+// Asset Pack Mapped from Flash, and the Icons to Draw
+ASSET_PACK assetPack;
+COMPRESSED_ASSET packIcons[ICON_COUNT];
+const COMPRESSED_ASSET* weatherIcons[ICON_COUNT];
+bool fileSystemMounted = false;
+
+
+//=============================================================================
+// Memory Functions
+//=============================================================================
+
+/**
+ * Creates the per-wake arena, in PSRAM when available
+ */
+void initWakeArena() {
+  void* buffer = heap_caps_malloc(WAKE_ARENA_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  size_t size = WAKE_ARENA_SIZE;
+
+  if (buffer == NULL) {
+    Serial.println("Warning: PSRAM unavailable, using internal RAM for the arena");
+    buffer = heap_caps_malloc(WAKE_ARENA_FALLBACK_SIZE, MALLOC_CAP_8BIT);
+    size = WAKE_ARENA_FALLBACK_SIZE;
+  }
+
+  Arena_Init(&wakeArena, buffer, size);
+}
+
+/**
+ * Reports the arena high-water mark and releases everything in it
+ */
+void resetWakeArena() {
+  Serial.print("Arena high-water mark: ");
+  Serial.print(wakeArena.highWater);
+  Serial.print(" of ");
+  Serial.print(wakeArena.capacity);
+  Serial.println(" bytes");
+
+  Arena_Reset(&wakeArena);
+}
+
+//=============================================================================
+// Asset Functions
+//=============================================================================
+
+/**
+ * Selects the fonts and icons to draw with
+ *
+ * Uses the assets in the asset pack partition when a valid pack is present,
+ * and the ones built into the firmware otherwise.
+ * Pack assets are drawn straight from the memory-mapped flash.
+ */
+void loadAssets() {
+  for (int i = 0; i < ICON_COUNT; i++) {
+    weatherIcons[i] = &Weather_Icons[i];
+  }
+
+  // Custom images are optional, so do not format the file system on failure
+  fileSystemMounted = LittleFS.begin(false);
+
+  if (!AssetPack_Open(&assetPack, ASSET_PACK_PARTITION)) {
+    Serial.println("No asset pack found, using built-in fonts and icons");
+    return;
+  }
+
+  int loaded = 0;
+  for (int i = 0; i < ICON_COUNT; i++) {
+    const ASSET_PACK_ENTRY* entry = AssetPack_Find(&assetPack, WEATHER_ICON_NAMES[i]);
+    if (entry != NULL && AssetPack_GetCompressed(&assetPack, entry, &packIcons[i])) {
+      weatherIcons[i] = &packIcons[i];
+      loaded++;
+    }
+  }
+
+  for (const auto& font : FONT_ASSETS) {
+    const ASSET_PACK_ENTRY* entry = AssetPack_Find(&assetPack, font.name);
+    if (entry == NULL || entry->type != ASSET_TYPE_FONT || entry->width != font.size) {
+      continue;
+    }
+    // EPD_ShowChar Reads Up to stride Bytes of Each of the height Glyphs
+    if (entry->stride == 0 || (uint32_t)entry->stride * entry->height > entry->size) {
+      Serial.print("Font asset ");
+      Serial.print(font.name);
+      Serial.println(" is shorter than its glyphs, using the built-in font");
+      continue;
+    }
+    EPD_SetFont(font.size, AssetPack_Data(&assetPack, entry), entry->stride, entry->height);
+    loaded++;
+  }
+
+  Serial.print("Asset pack loaded: ");
+  Serial.print(loaded);
+  Serial.println(" assets");
+}
+
+/**
+ * Draws a custom image from LittleFS, trying each supported extension
+ *
+ * @param basePath Path without extension
+ * @param x Image x coordinate
+ * @param y Image y coordinate
+ * @return true if an image was drawn
+ */
+bool drawCustomImage(const char* basePath, uint16_t x, uint16_t y) {
+  if (!fileSystemMounted) {
+    return false;
+  }
+
+  char path[48];
+  for (const char* extension : CUSTOM_IMAGE_EXTENSIONS) {
+    snprintf(path, sizeof(path), "%s%s", basePath, extension);
+    if (LittleFS.exists(path) && Image_LoadFile(path, x, y, WHITE, NULL)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Draws a custom icon or background from LittleFS, for ForecastView
+ * 
+ * @param context Unused
+ * @param image Weather icon number, or FORECAST_VIEW_BACKGROUND
+ * @param x Image x coordinate
+ * @param y Image y coordinate
+ * @return true if an image was drawn
+ */
+bool drawCustomViewImage(void* context, int image, uint16_t x, uint16_t y) {
+  if (image == FORECAST_VIEW_BACKGROUND) {
+    return drawCustomImage(CUSTOM_BACKGROUND, x, y);
+  }
+
+  char basePath[40];
+  snprintf(basePath, sizeof(basePath), "%s/%s", CUSTOM_ICON_DIR, WEATHER_ICON_NAMES[image]);
+  return drawCustomImage(basePath, x, y);
+}
+
+//=============================================================================
+// Clock Functions
+//=============================================================================
+
+/**
+ * Reads the local clock, which keeps running in deep sleep on the RTC slow clock
+ * 
+ * @return Local clock in microseconds
+ */
+int64_t localClockUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/**
+ * Estimates the current wall time, corrected for the drift of the local clock
+ * 
+ * @return Unix timestamp (UTC)
+ */
+int32_t wallTimeNow() {
+  return WakeScheduler_WallTime(&wakeSchedule, localClockUs());
+}
+
+#ifdef WAKE_PROFILE
+//=============================================================================
+// Wake Profile Functions
+//=============================================================================
+
+/**
+ * Prints the phase timings and estimated charge of one wake
+ * 
+ * @param record Wake to print
+ */
+void printWakeRecord(const WakeRecord* record) {
+  Serial.print("  awake ");
+  Serial.print(record->awakeUs / 1000);
+  Serial.print(" ms (");
+  const char* separator = "";
+  for (int i = 0; i < WAKE_PHASE_COUNT; i++) {
+    if (record->phaseUs[i] != 0) {
+      Serial.print(separator);
+      Serial.print(WakeProfile_PhaseName(i));
+      Serial.print(" ");
+      Serial.print(record->phaseUs[i] / 1000);
+      Serial.print(" ms");
+      separator = ", ";
+    }
+  }
+  Serial.print("), ");
+  Serial.print(WakeProfile_AwakeMah(record, &WAKE_CURRENTS), 4);
+  Serial.print(" mAh awake + ");
+  Serial.print(WakeProfile_SleepMah(record, &WAKE_CURRENTS), 4);
+  Serial.print(" mAh in ");
+  Serial.print(record->sleepSeconds);
+  Serial.println(" s of sleep");
+}
+
+/**
+ * Prints every wake in the wake log, with the average charge per day
+ */
+void printWakeProfile() {
+  int count = WakeProfile_Count(&wakeProfileLog);
+  float totalMah = 0;
+  float totalSeconds = 0;
+
+  Serial.print("Wake log, last ");
+  Serial.print(count);
+  Serial.print(" of ");
+  Serial.print(wakeProfileLog.wakes);
+  Serial.println(" wakes:");
+  for (int age = 0; age < count; age++) {
+    const WakeRecord* record = WakeProfile_Get(&wakeProfileLog, age);
+    printWakeRecord(record);
+    totalMah += WakeProfile_AwakeMah(record, &WAKE_CURRENTS) + WakeProfile_SleepMah(record, &WAKE_CURRENTS);
+    totalSeconds += record->awakeUs / 1e6f + record->sleepSeconds;
+  }
+  if (totalSeconds > 0) {
+    Serial.print("Average ");
+    Serial.print(totalMah / count, 4);
+    Serial.print(" mAh per wake, ");
+    Serial.print(totalMah * 86400 / totalSeconds, 2);
+    Serial.println(" mAh per day");
+  }
+}
+
+/**
+ * Adds this wake to the wake log and prints it
+ * The whole log is printed while the BOOT button is held.
+ * 
+ * @param sleepSeconds Deep sleep that follows, 0 if without timer
+ */
+void finishWakeProfile(uint32_t sleepSeconds) {
+  WakeProfile_Finish(&wakeProfileLog, micros(), sleepSeconds);
+  Serial.println("Wake profile:");
+  printWakeRecord(WakeProfile_Get(&wakeProfileLog, 0));
+
+  pinMode(WAKE_PROFILE_BUTTON_PIN, INPUT_PULLUP);
+  if (digitalRead(WAKE_PROFILE_BUTTON_PIN) == LOW) {
+    printWakeProfile();
+  }
+  Serial.flush();
+}
+#endif
+
+//=============================================================================
+// E-Paper Power Functions
+//=============================================================================
+
+/**
+ * Switches the panel on and sets up its lines, unless it is on already
+ * 
+ * Releases the lines latched low for the previous deep sleep.
+ */
+void panelPowerOn() {
+  if (panelPowered) {
+    return;
+  }
+  for (int pin : EPD_SIGNAL_PINS) {
+    gpio_hold_dis((gpio_num_t)pin);
+  }
+  gpio_hold_dis((gpio_num_t)BUSY);
+  gpio_hold_dis((gpio_num_t)EPD_POWER_PIN);
+
+  pinMode(EPD_POWER_PIN, OUTPUT);
+  digitalWrite(EPD_POWER_PIN, HIGH);
+  EPD_GPIOInit();
+  panelPowered = true;
+  panelPowerOnMs = millis();
+}
+
+/**
+ * Switches the panel off after EPD_DeepSleep
+ * 
+ * Drives every line low, so none of them feeds the unpowered panel
+ * through its protection diodes, and latches the lines through deep sleep.
+ */
+void panelPowerOff() {
+  for (int pin : EPD_SIGNAL_PINS) {
+    digitalWrite(pin, LOW);
+    gpio_hold_en((gpio_num_t)pin);
+  }
+  pinMode(BUSY, INPUT_PULLDOWN);
+  gpio_hold_en((gpio_num_t)BUSY);
+  digitalWrite(EPD_POWER_PIN, LOW);
+  gpio_hold_en((gpio_num_t)EPD_POWER_PIN);
+  gpio_deep_sleep_hold_en();
+  panelPowered = false;
+  panelPoweredMs = millis() - panelPowerOnMs;
+}
+
+//=============================================================================
+// State Store Functions
+//=============================================================================
+
+/**
+ * Adds a record to the table of the state kept across deep sleep
+ * 
+ * @param name Unique name, also the key of the flash copy
+ * @param data Record in RTC memory
+ * @param size Size of the record
+ * @param mirrored Also kept in flash, to survive a power loss
+ */
+void addStateRecord(const char* name, void* data, size_t size, bool mirrored) {
+  if (stateRecordCount < STATE_STORE_MAX_RECORDS) {
+    stateRecords[stateRecordCount++] = {name, 1, (uint16_t)size, data, mirrored};
+  }
+}
+
+/**
+ * Identifies the running firmware build
+ * 
+ * @return Hash of the application's ELF SHA-256
+ */
+uint32_t firmwareBuildId() {
+#if __has_include(<esp_app_desc.h>)
+  const esp_app_desc_t* app = esp_app_get_description();
+#else
+  const esp_app_desc_t* app = esp_ota_get_app_description();
+#endif
+  return StateStore_Crc32(0, app->app_elf_sha256, sizeof(app->app_elf_sha256));
+}
+
+/**
+ * Checks the state kept across deep sleep before anything reads it
+ * 
+ * Only a wake from deep sleep keeps RTC memory; after any other reset,
+ * a brownout included, every record starts over, and the forecast cache
+ * is restored from flash.
+ */
+void loadState() {
+  addStateRecord("forecast", &forecastCache, sizeof(forecastCache), true);
+  addStateRecord("panel", &panelState, sizeof(panelState), false);
+  addStateRecord("frame", &frameSnapshot, sizeof(frameSnapshot), false);
+  addStateRecord("retry", &retryState, sizeof(retryState), false);
+  addStateRecord("schedule", &wakeSchedule, sizeof(wakeSchedule), false);
+  addStateRecord("battery", &batteryState, sizeof(batteryState), false);
+#ifdef WAKE_PROFILE
+  addStateRecord("profile", &wakeProfileLog, sizeof(wakeProfileLog), false);
+#endif
+  stateRecordCount += WiFiConnect_StateRecords(stateRecords + stateRecordCount,
+                                               STATE_STORE_MAX_RECORDS - stateRecordCount);
+  StateStore_NvsBackend(&stateBackend, STATE_NVS_NAMESPACE);
+
+  bool coldStart = esp_reset_reason() != ESP_RST_DEEPSLEEP;
+  StateLoadResult result = StateStore_Load(&stateStore, stateRecords, stateRecordCount, firmwareBuildId(),
+                                           coldStart, &stateBackend);
+
+  Serial.print(result.warm ? "Warm start: " : "Cold start: ");
+  Serial.print(result.kept);
+  Serial.print(" records kept, ");
+  Serial.print(result.cleared);
+  Serial.print(" cleared, ");
+  Serial.print(result.restored);
+  Serial.println(" restored from flash");
+}
+
+/**
+ * Records the state kept across deep sleep, copying changed mirrored records to flash
+ */
+void commitState() {
+  StateStore_Commit(&stateStore, stateRecords, stateRecordCount, &stateBackend);
+}
 
 //=============================================================================
 // Deep-sleep Functions
 //=============================================================================
 
 /**
- * Function to Enter Deep-Sleep Mode
+ * Prints the time spent at each CPU clock during this wake
+ */
+void printClockLevels() {
+  if (ClockGovernor_LevelMhz(CLOCK_HIGH) == 0) {
+    return;
+  }
+  Serial.print("CPU clock: ");
+  for (int level = CLOCK_LEVEL_COUNT - 1; level >= 0; level--) {
+    Serial.print(ClockGovernor_LevelUs((ClockLevel)level) / 1000);
+    Serial.print(" ms at ");
+    Serial.print(ClockGovernor_LevelMhz((ClockLevel)level));
+    Serial.print(" MHz");
+    Serial.print(level > 0 ? ", " : "");
+  }
+  Serial.println();
+}
+
+/**
+ * Plans the time until the next scheduled wake
+ * 
+ * The interval follows the volatility of the cached forecast, is
+ * stretched on a low battery, and skips the quiet windows once the wall
+ * time is known.
+ * 
+ * @return Interval in seconds
+ */
+uint32_t planWakeInterval() {
+  int32_t now = wallTimeNow();
+  CadencePlan plan;
+  Cadence_Plan(&CADENCE_CONFIG, &forecastCache, now, &plan);
+
+  uint32_t interval = Battery_IntervalSeconds(&batteryState, &BATTERY_POLICY, plan.intervalSeconds);
+  if (wakeSchedule.syncWallTime != 0) {
+    interval = Cadence_SkipQuiet(&CADENCE_CONFIG, now, interval);
+  }
+
+  Serial.print("Forecast volatility ");
+  Serial.print(plan.score);
+  Serial.print(", next wake in ");
+  Serial.print(interval / 60);
+  Serial.println(" minutes");
+  return interval;
+}
+
+/**
+ * Function to Enter Deep-Sleep Mode
+ * 
+ * @param wakeup true if it needs to wake up later
+ * @param seconds Seconds until the wake-up, 0 for the next scheduled update
+ */
+void enterDeepSleep(bool wakeup, uint32_t seconds = 0) {
+  // Release Everything Allocated During This Wake
+  resetWakeArena();
+
+  // Put EPD in Sleep Mode, Then Cut Its Power, Before Entering Deep-Sleep Mode
+  uint32_t shutdownStart = millis();
+  WAKE_PHASE_BEGIN(WAKE_PHASE_SHUTDOWN);
+  if (panelPowered) {
+    EPD_DeepSleep();
+    panelPowerOff();
+  }
+  WAKE_PHASE_END(WAKE_PHASE_SHUTDOWN);
+  uint32_t shutdownMs = millis() - shutdownStart;
+
+  Serial.print("Panel shut down in ");
+  Serial.print(shutdownMs);
+  Serial.print(" ms, ");
+  Serial.print((int32_t)(OLD_SHUTDOWN_DELAY_MS - shutdownMs));
+  Serial.print(" ms less awake than the fixed wait; panel powered ");
+  Serial.print(panelPoweredMs);
+  Serial.print(" of ");
+  Serial.print(millis());
+  Serial.println(" ms");
+  printClockLevels();
+
+  Serial.println("Entering Deep-sleep mode. Will wake up later.");
+  Serial.flush();
+  
+  // Enter Deep-Sleep Mode
+  uint64_t sleepUs = 0;
+  if (wakeup) {
+    // Wake Up on the Next Boundary After the Planned Interval, Measured Now So This Wake's Length Counts
+    sleepUs = seconds * 1000ULL * 1000ULL; // microseconds
+    if (seconds == 0) {
+      sleepUs = WakeScheduler_SleepUs(&wakeSchedule, localClockUs(), TIMEZONE_OFFSET * 3600,
+                                      planWakeInterval(), WAKE_ALIGN_MINUTES * 60UL);
+    }
+    esp_sleep_enable_timer_wakeup(sleepUs);
+  }
+#ifdef WAKE_PROFILE
+  finishWakeProfile((uint32_t)(sleepUs / 1000000));
+#endif
+  commitState();
+  esp_deep_sleep_start();
+}
+
+//=============================================================================
+// Battery Functions
+//=============================================================================
+
+/**
+ * Measures the battery and updates the capacity and the update policy
+ * 
+ * Sampled before the radio starts, so the voltage does not sag under its
+ * load. Nothing is done without a battery monitor (BATTERY_ADC_PIN -1).
+ */
+void readBattery() {
+  if (BATTERY_ADC_PIN < 0) {
+    return;
+  }
+
+  uint16_t samples[BATTERY_SAMPLES];
+  for (int i = 0; i < BATTERY_SAMPLES; i++) {
+    samples[i] = (uint16_t)(analogReadMilliVolts(BATTERY_ADC_PIN) * BATTERY_DIVIDER_RATIO);
+  }
+  uint16_t millivolts = Battery_Average(samples, BATTERY_SAMPLES);
+
+  Battery_Init(&batteryState);
+  Battery_Update(&batteryState, &BATTERY_POLICY, millivolts);
+  int shownBars = panelState.magic == PANEL_STATE_MAGIC ? panelState.batteryBars : -1;
+  batteryBars = Battery_Bars(&batteryState, FORECAST_VIEW_BATTERY_BARS, shownBars);  // Full on external power
+
+  Serial.print("Battery: ");
+  Serial.print(millivolts);
+  Serial.print(" mV, smoothed ");
+  Serial.print(batteryState.millivolts);
+  Serial.print(" mV, ");
+  if (batteryState.external) {
+    Serial.println("external power");
+  } else {
+    Serial.print(batteryState.percent);
+    Serial.print("%, saving step ");
+    Serial.println(batteryState.level);
+  }
+}
+
+//=============================================================================
+// Frame Snapshot Functions
+//=============================================================================
+
+/**
+ * FNV-1a hash of an encoded frame
+ */
+uint32_t snapshotChecksum(const uint8_t* data, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * Allocates a buffer for a worst-case encoded frame, in PSRAM when available
+ */
+uint8_t* allocSnapshotBuffer() {
+  const size_t size = FRAME_CODEC_MAX_SIZE(EPD_ROW_BYTES, EPD_H);
+  void* buffer = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (buffer == NULL) {
+    buffer = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+  }
+  return (uint8_t*)buffer;
+}
+
+/**
+ * Records the frame buffer as the frame on the panel
+ *
+ * Called after every refresh. The frame is encoded into RTC memory, or
+ * into the flash slot when it does not fit there.
+ */
+void saveFrameSnapshot() {
+  uint32_t start = micros();
+  frameSnapshot.magic = 0;
+
+  uint8_t* buffer = NULL;
+  size_t length = FrameCodec_Encode(ImageBW, EPD_ROW_BYTES, EPD_H, frameSnapshot.data, FRAME_SNAPSHOT_CAPACITY);
+  frameSnapshot.inFlash = length == 0;
+  if (frameSnapshot.inFlash) {
+    // Too Large for RTC Memory, Encode Again Into the Flash Slot
+    buffer = allocSnapshotBuffer();
+    if (buffer == NULL || !fileSystemMounted) {
+      free(buffer);
+      Serial.println("Frame snapshot not saved: no room in RTC memory");
+      return;
+    }
+    length = FrameCodec_Encode(ImageBW, EPD_ROW_BYTES, EPD_H, buffer, FRAME_CODEC_MAX_SIZE(EPD_ROW_BYTES, EPD_H));
+    File file = LittleFS.open(FRAME_SNAPSHOT_PATH, "w");
+    bool written = file && file.write(buffer, length) == length;
+    file.close();
+    if (!written) {
+      free(buffer);
+      Serial.println("Frame snapshot not saved: flash write failed");
+      return;
+    }
+  }
+
+  frameSnapshot.length = length;
+  frameSnapshot.checksum = snapshotChecksum(frameSnapshot.inFlash ? buffer : frameSnapshot.data, length);
+  frameSnapshot.magic = FRAME_SNAPSHOT_MAGIC;
+  free(buffer);
+
+  Serial.print("Frame snapshot: ");
+  Serial.print(length);
+  Serial.print(" bytes (");
+  Serial.print((float)EPD_BUFFER_SIZE / length, 1);
+  Serial.print(":1) in ");
+  Serial.print(frameSnapshot.inFlash ? "flash" : "RTC memory");
+  Serial.print(", ");
+  Serial.print(micros() - start);
+  Serial.println(" us");
+}
+
+/**
+ * Restores the frame on the panel into a buffer
+ *
+ * @param frame Buffer of EPD_BUFFER_SIZE bytes
+ * @return true if the snapshot was valid and decoded
+ */
+bool restoreFrameSnapshot(uint8_t* frame) {
+  if (frameSnapshot.magic != FRAME_SNAPSHOT_MAGIC) {
+    return false;
+  }
+
+  const uint8_t* data = frameSnapshot.data;
+  uint8_t* buffer = NULL;
+  if (frameSnapshot.inFlash) {
+    buffer = fileSystemMounted ? allocSnapshotBuffer() : NULL;
+    File file = buffer != NULL ? LittleFS.open(FRAME_SNAPSHOT_PATH, "r") : File();
+    bool read = file && file.read(buffer, frameSnapshot.length) == frameSnapshot.length;
+    file.close();
+    if (!read) {
+      free(buffer);
+      return false;
+    }
+    data = buffer;
+  }
+
+  bool restored = snapshotChecksum(data, frameSnapshot.length) == frameSnapshot.checksum &&
+                  FrameCodec_Decode(data, frameSnapshot.length, frame, EPD_ROW_BYTES, EPD_H);
+  free(buffer);
+  if (!restored) {
+    Serial.println("Frame snapshot invalid");
+    frameSnapshot.magic = 0;
+  }
+  return restored;
+}
+
+//=============================================================================
+// Display Functions
+//=============================================================================
+
+/**
+ * Checks for a custom background image on LittleFS
+ */
+bool hasCustomBackground() {
+  if (!fileSystemMounted) {
+    return false;
+  }
+
+  char path[48];
+  for (const char* extension : CUSTOM_IMAGE_EXTENSIONS) {
+    snprintf(path, sizeof(path), "%s%s", CUSTOM_BACKGROUND, extension);
+    if (LittleFS.exists(path)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Draws forecast columns into the frame buffer
+ * 
+ * Columns outside slotMask are left as they are, so only changed columns
+ * are redrawn. With a custom background, every column is redrawn. The
+ * frame is split into tiles drawn on both cores; a custom background is
+ * drawn in one pass, as every tile would have to decode all of it.
+ * 
+ * @param slots Text of each column
+ * @param slotMask Columns to draw, ALL_SLOTS for a whole frame, 0 for the battery glyph only
+ * @param bars Bars of the battery glyph, -1 for none
+ */
+void renderForecastFrame(const ForecastSlotText* slots, uint8_t slotMask, int8_t bars = batteryBars) {
+  bool background = hasCustomBackground();
+  ForecastView view = {slots, slotMask, slotMask == ALL_SLOTS || background, weatherIcons,
+                       fileSystemMounted ? drawCustomViewImage : NULL, NULL, bars >= 0, (uint8_t)(bars >= 0 ? bars : 0)};
+
+  WAKE_PHASE_BEGIN(WAKE_PHASE_RASTER);
+  TileRender_Frame(ForecastView_Draw, &view, RENDER_TILES, background ? 1 : RENDER_WORKERS);
+  WAKE_PHASE_END(WAKE_PHASE_RASTER);
+}
+
+/**
+ * Prepares the panel for a forecast update
+ * 
+ * For a partial update, rebuilds the frame on the panel as the old image,
+ * so only changed pixels are driven; the frame buffer is left holding that
+ * frame. The frame comes from the frame snapshot, or is rendered again
+ * from its columns when there is none. Otherwise clears the panel with a
+ * full refresh, every MAX_PARTIAL_UPDATES updates (more on a low battery)
+ * or when the panel content is unknown. The panel is switched on here.
+ * 
+ * @return true for a partial update, false after a full refresh
+ */
+bool beginPanelUpdate() {
+  uint16_t maxPartialUpdates = Battery_MaxPartialUpdates(&batteryState, &BATTERY_POLICY, MAX_PARTIAL_UPDATES);
+  bool partial = panelState.magic == PANEL_STATE_MAGIC && panelState.partialUpdates < maxPartialUpdates;
+
+  // Initialize Display
+  Paint_NewImage(ImageBW, EPD_W, EPD_H, Rotation, WHITE);
+  panelPowerOn();
+  EPD_FastMode1Init();
+
+  if (partial) {
+    // The Old Image From the Snapshot, or Rendered Again From Its Columns
+    if (!restoreFrameSnapshot(ImageBW)) {
+      renderForecastFrame(panelState.slots, ALL_SLOTS, panelState.batteryBars);
+    }
+    EPD_DisplayOld(ImageBW);
+  } else {
+    EPD_Display_Clear();
+    EPD_Update();
+    EPD_Clear_R26A6H();
+    panelState.magic = 0;  // The panel is blank now
+    frameSnapshot.magic = 0;
+  }
+  return partial;
+}
+
+/**
+ * Refreshes the panel with the frame buffer and records what it shows
  * 
- * @param wakeup true if it needs to wake up later
+ * @param slots Text of each column
+ * @param fingerprints Forecast_Fingerprint of each column
+ * @param partial Value returned by beginPanelUpdate
+ * @param changed Mask of the columns that differ from the previous frame
  */
-void enterDeepSleep(bool wakeup) {
-  Serial.println("Entering Deep-sleep mode. Will wake up later.");
-  Serial.flush();
-  
-  // Put EPD in Sleep Mode Before Entering Deep-Sleep Mode
-  EPD_DeepSleep();
+void finishPanelUpdate(const ForecastSlotText* slots, const uint32_t* fingerprints, bool partial, uint8_t changed) {
+  // Update Display
+  EPD_Display(ImageBW);
+  EPD_PartUpdate();
+  saveFrameSnapshot();
 
-  delay(4000);
-  
-  // Enter Deep-Sleep Mode
-  if (wakeup) {
-    // Wake Up After n minutes (default: 60 minites)
-    esp_sleep_enable_timer_wakeup(INTERVAL_IN_MINUTES * 60UL * 1000UL * 1000); // microseconds
-  }
-  esp_deep_sleep_start();
-}
+  panelState.partialUpdates = partial ? panelState.partialUpdates + 1 : 0;
+  memcpy(panelState.fingerprints, fingerprints, sizeof(panelState.fingerprints));
+  memcpy(panelState.slots, slots, sizeof(panelState.slots));
+  panelState.batteryBars = batteryBars;
+  panelState.magic = PANEL_STATE_MAGIC;
 
-//=============================================================================
-// Display Functions
-//=============================================================================
+  Serial.print("Weather forecast displayed successfully (");
+  Serial.print(partial ? "partial update, columns 0x" : "full refresh, columns 0x");
+  Serial.print(changed, HEX);
+  Serial.println(")");
+}
 
 /**
  * Displays weather forecast on the E-Paper display
  * 
  * Renders time, weather icon, temperature and probability of precipitation
- * for each forecast period in a column layout
+ * for each forecast period in a column layout. Nothing is done when every
+ * column would look the same as on the panel; otherwise only the changed
+ * columns are redrawn and refreshed with a partial update, with a full
+ * refresh every MAX_PARTIAL_UPDATES updates. A change of the battery glyph
+ * alone is a partial update of the glyph.
+ * 
+ * @param lastUpdated Time of the forecast when it is out of date (UTC), 0 if current
  */
-void displayWeatherForecast()
+void displayWeatherForecast(int32_t lastUpdated = 0)
 {
-  const int textBufferSize = 40;    // Size of text buffer for formatting
-  const int columnWidth = 158;      // Width of each forecast column in pixels
-  char buffer[textBufferSize];
-
-  // Initialize Display
-  Paint_NewImage(ImageBW, EPD_W, EPD_H, Rotation, WHITE);
-  Paint_Clear(WHITE);
-  EPD_FastMode1Init();
-  EPD_Display_Clear();
-  EPD_Update();
-  EPD_Clear_R26A6H();
+  ForecastSlotText slots[FORECAST_COUNT];
+  uint32_t fingerprints[FORECAST_COUNT];
+  bool panelKnown = panelState.magic == PANEL_STATE_MAGIC;
+  uint8_t changed = 0;
 
-  // Display Each Forecast Data
+  // Compare What Would Be Drawn With What the Panel Shows
   for (int i = 0; i < FORECAST_COUNT; i++) {
-    if (hourlyForecasts[i].time.length() > 0) {
-      // Calculate x position for this column
-      int baseX = columnWidth * i;
-      
-      // Display Time
-      memset(buffer, 0, sizeof(buffer));
-      snprintf(buffer, sizeof(buffer), "%s ", hourlyForecasts[i].time);
-      EPD_ShowString(26 + baseX, 18, buffer, 44, BLACK);
-
-      // Display Weather Icon
-      EPD_ShowPicture(16 + baseX, 60, 128, 128, Weather_Num[hourlyForecasts[i].iconNumber], WHITE);
-
-      // Display Temperature with appropriate unit
-      memset(buffer, 0, sizeof(buffer));
-      if (TEMPERATURE_UNIT == 0) {
-        snprintf(buffer, sizeof(buffer), "%3d C", (int)round(hourlyForecasts[i].temperature));
-      } else {
-        snprintf(buffer, sizeof(buffer), "%3d F", (int)round(hourlyForecasts[i].temperature));
-      }
-      EPD_ShowString(30 + baseX, 190, buffer, 36, BLACK);
-      EPD_DrawCircle(100 + baseX, 201, 2, BLACK, false);
-      EPD_DrawCircle(100 + baseX, 201, 3, BLACK, false);
-
-      if (i != 0) {
-        // Display Probability of precipitation
-        memset(buffer, 0, sizeof(buffer));
-        snprintf(buffer, sizeof(buffer), "%3d %%", (int)round(100 * hourlyForecasts[i].pop));
-        EPD_ShowString(30 + baseX, 225, buffer, 36, BLACK);
-      }
+    Forecast_FormatSlot(&slots[i], &hourlyForecasts[i], TIMEZONE_OFFSET * 3600, TEMPERATURE_UNIT == 0 ? 'C' : 'F',
+                        i != 0, i == 0 ? lastUpdated : 0);
+    fingerprints[i] = Forecast_Fingerprint(&slots[i]);
+    if (!panelKnown || fingerprints[i] != panelState.fingerprints[i]) {
+      changed |= 1 << i;
     }
   }
 
-  // Draw Separator Lines
-  for (int i = 1; i < FORECAST_COUNT; i++) {
-    EPD_DrawLine(2 + columnWidth * i, 0, 2 + columnWidth * i, 271, BLACK);
+  bool glyphChanged = panelKnown && panelState.batteryBars != batteryBars;
+  if (changed == 0 && !glyphChanged) {
+    Serial.println("Forecast unchanged, display update skipped");
+    return;
   }
 
-  // Update Display
-  EPD_Display(ImageBW);
-  EPD_PartUpdate();
-  
-  Serial.println("Weather forecast displayed successfully");
+  bool partial = beginPanelUpdate();
+  renderForecastFrame(slots, partial ? changed : ALL_SLOTS);
+  finishPanelUpdate(slots, fingerprints, partial, changed);
 }
 
 /**
@@ -206,10 +1086,13 @@ void displayWeatherForecast()
 void displayErrorMessage(const char* message) {
   Serial.print("ERROR: ");
   Serial.println(message);
+  panelState.magic = 0;     // Not a forecast frame; the next update is a full refresh
+  frameSnapshot.magic = 0;
 
   // Initialize Display
   Paint_NewImage(ImageBW, EPD_W, EPD_H, Rotation, WHITE);
   Paint_Clear(WHITE);
+  panelPowerOn();
   EPD_FastMode1Init();
   EPD_Display_Clear();
   EPD_Update();
@@ -246,7 +1129,7 @@ void displayErrorMessage(const char* message) {
     currentLine++;
   }
 
-  // Update Display
+  // Update Display, Without a Snapshot: the Next Forecast Needs a Full Refresh Anyway
   EPD_Display(ImageBW);
   EPD_PartUpdate();
 }
@@ -256,36 +1139,27 @@ void displayErrorMessage(const char* message) {
 //=============================================================================
 
 /**
- * Connects to WiFi network using credentials from config.h
+ * Connects to the best available WiFi network from config.h
  * 
  * @return true if connection successful, false if failed
  */
 bool connectToWiFi() {
-  Serial.print("Connecting to WiFi network: ");
-  Serial.println(WIFI_SSID);
-  
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  Serial.println("Connecting to WiFi...");
   
-  // Connection Timeout (10 seconds)
+  // Time shared by the networks searched for without a cached access point (10 seconds)
   const int wifiTimeoutMs = 10000;
-  const int delayMs = 500;
-  int attempts = wifiTimeoutMs / delayMs;
-  
-  // Wait until Connection is Complete
-  while (WiFi.status() != WL_CONNECTED && attempts > 0) {
-    delay(delayMs);
-    Serial.print(".");
-    attempts--;
-  }
   
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("");
-    Serial.print("Connected to WiFi with IP Address: ");
+  WAKE_PHASE_BEGIN(WAKE_PHASE_WIFI);
+  bool connected = WiFiConnect_Connect(wifiTimeoutMs);
+  WAKE_PHASE_END(WAKE_PHASE_WIFI);
+
+  if (connected) {
+    Serial.print("Connected to ");
+    Serial.print(WiFi.SSID());
+    Serial.print(" with IP Address: ");
     Serial.println(WiFi.localIP());
     return true;
   } else {
-    Serial.println("");
     Serial.println("Failed to connect to WiFi");
     return false;
   }
@@ -295,57 +1169,24 @@ bool connectToWiFi() {
  * Disconnects from WiFi to save power
  */
 void disconnectWiFi() {
-  WiFi.disconnect(true);
-  WiFi.mode(WIFI_OFF);
+  WiFiConnect_Disconnect();
   Serial.println("WiFi disconnected for power saving");
 }
 
 /**
- * Sends an HTTP GET request to the specified URL
- * 
- * @param url URL to send the request to
- * @return Response content as String
+ * Builds the filter that keeps only the fields used by readWeatherInfo
+ *
+ * Applies to one "current" or "hourly" entry, since the response is
+ * parsed an entry at a time.
+ *
+ * @param filter Filter document to fill
  */
-String httpGETRequest(const char* url) {
-  WiFiClient client;
-  HTTPClient http;
-
-  // Initialize HTTP Client and Specify Server URL
-  http.begin(client, url);
-
-  // Set HTTP Request Timeout
-  const int httpTimeoutMs = 10000; // HTTP request timeout in milliseconds
-  http.setTimeout(httpTimeoutMs);
-
-  Serial.print("Sending HTTP GET request to: ");
-  Serial.println(url);
-
-  // Send HTTP GET Request
-  httpResponseCode = http.GET();
-
-  // Initialize Response Content
-  String payload = "{}";
-
-  // Check Response Code and Process Response Content
-  if (httpResponseCode > 0) {
-    Serial.print("HTTP Response code: ");
-    Serial.println(httpResponseCode);
-    
-    if (httpResponseCode == HTTP_CODE_OK) {
-      // Copy Response to Buffer
-      payload = http.getString();
-    } else {
-      Serial.println("Request failed with non-200 status code");
-    }
-  } else {
-    Serial.print("HTTP Request failed, error code: ");
-    Serial.println(httpResponseCode);
-  }
-  
-  // Release HTTP Client Resources
-  http.end();
-  
-  return payload;
+void buildEntryFilter(JsonDocument& filter) {
+  filter["dt"] = true;
+  filter["temp"] = true;
+  filter["pop"] = true;
+  filter["weather"][0]["id"] = true;
+  filter["weather"][0]["icon"] = true;
 }
 
 //=============================================================================
@@ -353,64 +1194,73 @@ String httpGETRequest(const char* url) {
 //=============================================================================
 
 /**
- * Maps OpenWeatherMap icon code to our internal icon number
+ * Maps an OpenWeatherMap condition to our internal icon number
  * 
- * @param OpenWeatherMapIcon OpenWeatherMap icon code (e.g., "01d")
+ * @param conditionId OpenWeatherMap condition id (e.g., 500), 0 if unknown
+ * @param OpenWeatherMapIcon OpenWeatherMap icon code (e.g., "01d"), may be NULL
  * @return Corresponding internal icon number
  */
-int getWeatherIconNum(String OpenWeatherMapIcon) {
-  // Search for a Match from the Mapping Table
-  if (WEATHER_MAPPINGS.find(OpenWeatherMapIcon) != WEATHER_MAPPINGS.end()) {
-    return WEATHER_MAPPINGS[OpenWeatherMapIcon];
+int getWeatherIconNum(uint16_t conditionId, const char* OpenWeatherMapIcon) {
+  // The icon code tells day from night; the condition id is more precise
+  bool night = OpenWeatherMapIcon != NULL && OpenWeatherMapIcon[0] != '\0' &&
+               OpenWeatherMapIcon[1] != '\0' && OpenWeatherMapIcon[2] == 'n';
+
+  uint8_t icon = Forecast_IconFromConditionId(conditionId, night);
+  if (icon == ICON_UNKNOWN) {
+    icon = Forecast_IconFromCode(OpenWeatherMapIcon);
+  }
+  if (icon != ICON_UNKNOWN) {
+    return icon;
   }
   
-  // Default is Cloudy if no match found
-  Serial.println("Warning: No icon match found for " + OpenWeatherMapIcon + ", using default");
+  // Default is Thunderstorm if no match found
+  Serial.print("Warning: No icon match found for ");
+  Serial.print(OpenWeatherMapIcon != NULL ? OpenWeatherMapIcon : "(none)");
+  Serial.println(", using default");
   return ICON_THUNDERSTORM;
 }
 
 /**
- * Stores weather information in the forecast array
+ * Reads weather information from one entry of the response
  * 
- * @param index Index in the forecast array
- * @param unixTime Unix timestamp (UTC)
- * @param iconCode OpenWeatherMap icon code
- * @param temperature Temperature
- * @param pop Probability of precipitation
+ * @param entry "current" or "hourly" entry of the One Call response
+ * @param info Receives the weather information
  */
-void storeWeatherInfo(int index, long unixTime, String iconCode, float temperature, float pop) {
-  if (index < 0 || index >= FORECAST_COUNT) {
-    displayErrorMessage("Invalid forecast index");
-    enterDeepSleep(true);
-    return;
-  }
-
-  // Convert UTC Unix Timestamp to Local Time
-  time_t localTime = unixTime + TIMEZONE_OFFSET * 3600;
-  struct tm *timeinfo = localtime(&localTime);
+void readWeatherInfo(JsonVariantConst entry, ForecastInfo& info) {
+  info.time = entry["dt"].as<int32_t>();
+  info.iconNumber = getWeatherIconNum(entry["weather"][0]["id"].as<uint16_t>(),
+                                      entry["weather"][0]["icon"].as<const char*>());
+  info.temperature = (int16_t)lround(entry["temp"].as<float>() * 100);
+  info.pop = (uint8_t)lround(entry["pop"].as<float>() * 100);
+}
 
-  // Store Information in Structure
-  char tempTimeStr[6];
-  strftime(tempTimeStr, sizeof(tempTimeStr), "%k:%M", timeinfo);
-  hourlyForecasts[index].time = String(tempTimeStr);
-  hourlyForecasts[index].iconNumber = getWeatherIconNum(iconCode);
-  hourlyForecasts[index].temperature = temperature;
-  hourlyForecasts[index].pop = pop;
+/**
+ * Fills the forecast array from the forecast cache
+ * 
+ * @param now Current time (UTC)
+ * @return Number of forecast periods covered by the cache
+ */
+int fillForecastsFromCache(int32_t now) {
+  memset(hourlyForecasts, 0, sizeof(hourlyForecasts));
+  return ForecastCache_Window(&forecastCache, now, FORECAST_HOUR_OFFSETS, FORECAST_COUNT, hourlyForecasts);
 }
 
 /**
  * Prints weather forecast data to Serial for debugging
  */
 void printWeatherData() {
+  char timeBuffer[8];
+
   Serial.println("\n--- Weather Forecast Data ---");
   for (int i = 0; i < FORECAST_COUNT; i++) {
-    if (hourlyForecasts[i].time.length() > 0) {
+    if (hourlyForecasts[i].time != 0) {
+      Forecast_FormatTime(timeBuffer, sizeof(timeBuffer), hourlyForecasts[i].time, TIMEZONE_OFFSET * 3600);
       Serial.print("Time: ");
-      Serial.print(hourlyForecasts[i].time);
+      Serial.print(timeBuffer);
       Serial.print(" | IconNumber: ");
       Serial.print(hourlyForecasts[i].iconNumber);
       Serial.print(" | Temperature: ");
-      Serial.print(hourlyForecasts[i].temperature);
+      Serial.print(hourlyForecasts[i].temperature / 100.0f);
       Serial.print("C | POP: ");
       Serial.print(hourlyForecasts[i].pop);
       Serial.println("%");
@@ -419,211 +1269,594 @@ void printWeatherData() {
 }
 
 /**
- * Fetches weather forecast data from OpenWeatherMap API or test data
+ * Loads the forecast from the cache if it is fresh enough, without using WiFi
+ * A stable forecast is kept up to FORECAST_MAX_AGE_MINUTES, a volatile one
+ * down to FORECAST_MIN_AGE_MINUTES.
  * 
- * @param useTestData If true, uses test data instead of API
- * @return JSON string containing weather data, or empty string on failure
+ * @return true if the forecast array is ready to display
  */
-String fetchWeatherData(bool useTestData = TEST_MODE) {
-  // Returns Test Data When in test mode
-  if (useTestData) {
-    Serial.println("Using test data instead of API");
-    return String(TEST_WEATHER_DATA);
+bool loadCachedForecast() {
+  int32_t now = wallTimeNow();
+  int32_t age = ForecastCache_Age(&forecastCache, now);
+  CadencePlan plan;
+  Cadence_Plan(&CADENCE_CONFIG, &forecastCache, now, &plan);
+
+  // A Volatile Forecast is Fetched Again Sooner
+  if (age < 0 || (uint32_t)age >= plan.maxAgeSeconds) {
+    return false;
   }
-  
-  // Check WiFi Connection Status
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi Disconnected. Attempting to reconnect...");
-    if (!connectToWiFi()) {
-      Serial.println("WiFi reconnection failed");
-      return "";
-    }
+  if (fillForecastsFromCache(now) < FORECAST_COUNT) {
+    return false;
   }
 
-  // Build OpenWeatherMap API Request URL
-  String url = "http://api.openweathermap.org";
-  url += "/data/3.0/onecall";
-  url += "?lat=" + String((float) LATITUDE, 5);
-  url += "&lon=" + String((float) LONGITUDE, 5);
-  url += "&units=" + String(TEMPERATURE_UNIT == 0 ? "metric" : "imperial") + "&lang=en&exclude=minutely,daily,alerts";
-  url += "&appid=" + (String) OPENWEATHERMAP_API_KEY;
+  Serial.print("Using cached forecast, fetched ");
+  Serial.print(age / 60);
+  Serial.println(" minutes ago");
+  printWeatherData();
+  return true;
+}
 
-  Serial.println("Fetching weather forecast data from OpenWeatherMap...");
-  
-  // Send HTTP Request and Get Response
-  int retryCount = 0;
-  bool exitLoop = false;
-  String responseData = "";
-  
-  const int maxRetryCount = 3;     // Maximum number of retry attempts
-  while (retryCount < maxRetryCount && !exitLoop) {
-    responseData = httpGETRequest(url.c_str());
+/**
+ * Displays the last good forecast after a failed update
+ * 
+ * The forecast is marked with the time it was fetched, and its first
+ * period starts at the top of the hour so retries within the same hour
+ * find the frame already on the panel.
+ */
+void displayLastGoodForecast() {
+  int32_t now = wallTimeNow();
 
-    switch (httpResponseCode) {
-      case HTTP_CODE_OK:
-        exitLoop = true;
-        break;
-      case HTTP_CODE_BAD_REQUEST:
-        exitLoop = true;
-        displayErrorMessage("Either some mandatory parameters in the request are missing or some of request parameters have incorrect format or values out of allowed range.");
-        enterDeepSleep(false);
-        break;
-      case HTTP_CODE_UNAUTHORIZED:
-        exitLoop = true;
-        displayErrorMessage("API token did not providen in the request or in case API token provided in the request does not grant access to this API.");
-        enterDeepSleep(false);
-        break;
-      case HTTP_CODE_NOT_FOUND:
-        exitLoop = true;
-        displayErrorMessage("Data with requested parameters (lat, lon, date etc) does not exist in service database.");
-        enterDeepSleep(false);
-        break;
-      case HTTP_CODE_TOO_MANY_REQUESTS:
-        exitLoop = true;
-        displayErrorMessage("Key quota of requests for provided API to this API was exceeded.");
-        enterDeepSleep(false);
-        break;
-      case HTTP_CODE_INTERNAL_SERVER_ERROR:
-      case HTTP_CODE_BAD_GATEWAY:
-      case HTTP_CODE_SERVICE_UNAVAILABLE:
-      case HTTP_CODE_GATEWAY_TIMEOUT:
-        Serial.println("Unexpected Error.");
-        retryCount++;
-        Serial.print("Retry attempt ");
-        Serial.print(retryCount);
-        Serial.print(" of ");
-        Serial.println(maxRetryCount);
-        delay(60000);
-        break;
-      default:
-        exitLoop = true;
-        displayErrorMessage("Unknown Error.");
-        enterDeepSleep(false);
+  if (!ForecastCache_IsValid(&forecastCache)) {
+    displayErrorMessage("No weather forecast data available yet. Retrying later.");
+    return;
+  }
+
+  // The clock is unknown after a power loss; show the forecast as it was fetched
+  if (now < forecastCache.fetchedAt) {
+    now = forecastCache.fetchedAt;
+  }
+  now -= (now - forecastCache.firstHour) % 3600;
+
+  if (fillForecastsFromCache(now) == 0) {
+    displayErrorMessage("Weather forecast data is out of date. Retrying later.");
+    return;
+  }
+
+  Serial.println("Showing the last good forecast");
+  printWeatherData();
+  displayWeatherForecast(forecastCache.fetchedAt);
+}
+
+/**
+ * Schedules the next attempt after a failed update
+ * 
+ * @return Seconds until the next attempt
+ */
+uint32_t retryUpdateLater() {
+  const RetryConfig retryConfig = {RETRY_INTERVAL_MINUTES * 60UL, INTERVAL_IN_MINUTES * 60UL};
+  RetryDecision decision = Retry_OnFailure(&retryState, &retryConfig, updateResult, retryAfterSeconds);
+
+  Serial.print("Update failed (code ");
+  Serial.print(updateResult);
+  Serial.print(", attempt ");
+  Serial.print(retryState.attempts);
+  Serial.print("), retrying in ");
+  Serial.print(decision.delaySeconds);
+  Serial.println(" s");
+  return decision.delaySeconds;
+}
+
+//=============================================================================
+// Update Pipeline Functions
+//=============================================================================
+
+/**
+ * Network stage: sends the request and passes the response body on in chunks
+ * 
+ * Runs on the core of the WiFi driver. Always ends the body with an
+ * empty chunk, so the parse stage never waits for data that will not come.
+ * 
+ * @param stage Stage whose context is the UpdatePipeline
+ */
+void networkStage(PipeStage* stage) {
+  UpdatePipeline* pipeline = (UpdatePipeline*)stage->context;
+  PipeChunk chunk;
+
+  if (pipeline->url == NULL) {
+    // Feed the Test Data Through the Pipeline as if It Came From the Network
+    Serial.println("Using test data instead of API");
+    const char* data = TEST_WEATHER_DATA;
+    size_t remaining = strlen(data);
+    pipeline->httpCode = HTTP_CODE_OK;
+    while (remaining > 0) {
+      chunk.length = remaining < PIPE_CHUNK_SIZE ? remaining : PIPE_CHUNK_SIZE;
+      memcpy(chunk.data, data, chunk.length);
+      data += chunk.length;
+      remaining -= chunk.length;
+      if (!Pipe_Send(pipeline->chunks, &chunk, STAGE_TIMEOUT_MS, stage)) {
         break;
+      }
     }
+  } else {
+    WiFiClient client;
+    HTTPClient http;
+
+    // Initialize HTTP Client and Specify Server URL
+    WAKE_PHASE_BEGIN(WAKE_PHASE_HTTP);
+    http.begin(client, pipeline->url);
+
+    // Ask for HTTP/1.0 so the body is never sent with chunked encoding
+    http.useHTTP10(true);
+
+    // Set HTTP Request Timeout
+    const int httpTimeoutMs = 10000; // HTTP request timeout in milliseconds
+    http.setTimeout(httpTimeoutMs);
+
+    // Keep Retry-After, Sent With 429 Responses, and Date for the Clock
+    const char* headerKeys[] = {"Retry-After", "Date"};
+    http.collectHeaders(headerKeys, 2);
+
+    Serial.print("Sending HTTP GET request to: ");
+    Serial.println(pipeline->url);
+
+    // Send HTTP GET Request
+    pipeline->httpCode = http.GET();
+    pipeline->serverLocalUs = localClockUs();
+    WAKE_PHASE_END(WAKE_PHASE_HTTP);
+    if (http.hasHeader("Date")) {
+      int32_t date = Retry_ParseHttpDate(http.header("Date").c_str());
+      pipeline->serverTime = date > 0 ? date : 0;
+    }
+    if (http.hasHeader("Retry-After")) {
+      // A date is measured from the Date of the same response, or the synced clock; dropped otherwise
+      int32_t now = pipeline->serverTime;
+      if (now == 0 && wakeSchedule.syncWallTime != 0) {
+        now = wallTimeNow();
+      }
+      pipeline->retryAfter = Retry_ParseRetryAfter(http.header("Retry-After").c_str(), now);
+    }
+
+    Serial.print("HTTP Response code: ");
+    Serial.println(pipeline->httpCode);
+
+    if (pipeline->httpCode == HTTP_CODE_OK) {
+      // Pass on Whatever Has Arrived, Waiting for at Least One Byte
+      WAKE_PHASE_BEGIN(WAKE_PHASE_RECEIVE);
+      Stream& stream = http.getStream();
+      int remaining = http.getSize();  // -1 when the server sent no length
+      while (remaining != 0) {
+        chunk.length = stream.readBytes(chunk.data, 1);
+        if (chunk.length == 0) {
+          break;  // Connection closed or timed out
+        }
+        size_t more = stream.available();
+        if (more > PIPE_CHUNK_SIZE - 1) {
+          more = PIPE_CHUNK_SIZE - 1;
+        }
+        if (remaining > 0 && more > (size_t)remaining - 1) {
+          more = remaining - 1;
+        }
+        chunk.length += stream.readBytes(chunk.data + 1, more);
+        if (remaining > 0) {
+          remaining -= chunk.length;
+        }
+        if (!Pipe_Send(pipeline->chunks, &chunk, STAGE_TIMEOUT_MS, stage)) {
+          break;
+        }
+      }
+      WAKE_PHASE_END(WAKE_PHASE_RECEIVE);
+    }
+
+    // Release HTTP Client Resources, and the Radio as Soon as the Body is In
+    http.end();
+    disconnectWiFi();
   }
-  
-  if (!exitLoop) {
-    displayErrorMessage("Failed to fetch weather forecast data after multiple attempts");
-    enterDeepSleep(false);
-    return "";
-  }
-  
-  return responseData;
+
+  // End of Body
+  chunk.length = 0;
+  Pipe_Send(pipeline->chunks, &chunk, STAGE_TIMEOUT_MS, stage);
 }
 
 /**
- * Analyzes weather data JSON and stores it in the forecast array
+ * Parses one "current" or "hourly" entry from the response body
+ * 
+ * The entry's document is released right after reading it, so the arena
+ * holds only one entry at a time.
  * 
- * @param jsonData JSON string containing weather data
- * @return true if analysis was successful, false otherwise
+ * @param reader Reader positioned before the entry
+ * @param filter Filter built by buildEntryFilter
+ * @param info Receives the weather information
+ * @return true if the entry was parsed
  */
-bool analyzeWeatherData(const String& jsonData) {
-  // Parse JSON Data
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, jsonData);
+bool readForecastEntry(PipeReader& reader, const JsonDocument& filter, ForecastInfo& info) {
+  ARENA_MARK mark = Arena_Mark(&wakeArena);
+  DeserializationError error;
+  {
+    ArenaAllocator allocator(&wakeArena);
+    JsonDocument entry(&allocator);
+    error = deserializeJson(entry, reader, DeserializationOption::Filter(filter));
+    if (error == DeserializationError::Ok) {
+      readWeatherInfo(entry.as<JsonVariantConst>(), info);
+    }
+  }
+  Arena_Rewind(&wakeArena, mark);
 
-  // Check if JSON Parsing was Successful
   if (error != DeserializationError::Ok) {
     Serial.print("JSON parsing failed! Error: ");
     Serial.println(error.c_str());
-    String errorMsg = "JSON parsing failed! Error: " + String(error.c_str());
-    displayErrorMessage(errorMsg.c_str());
     return false;
   }
+  return true;
+}
+
+/**
+ * Skips whitespace in the response body
+ * 
+ * @param reader Reader over the response body
+ * @return Next non-whitespace character, -1 at the end of the body
+ */
+int skipWhitespace(PipeReader& reader) {
+  int c = reader.peek();
+  while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+    reader.read();
+    c = reader.peek();
+  }
+  return c;
+}
 
-  // Store Current Weather Information
-  storeWeatherInfo(0, doc["current"]["dt"], 
-                  doc["current"]["weather"][0]["icon"],
-                  doc["current"]["temp"].as<float>(),
-                  doc["current"]["pop"].as<float>());
+/**
+ * Sends one forecast column to the render stage
+ */
+void sendForecastSlot(UpdatePipeline* pipeline, PipeStage* stage, int index, const ForecastInfo& info) {
+  SlotMessage message = {(int8_t)index, info};
+  Pipe_Send(pipeline->slots, &message, STAGE_TIMEOUT_MS, stage);
+}
 
-  // Store Future Weather Information (3, 6, 9, 12 hours later)
-  const int hourlyIndices[] = {3, 6, 9, 12};
-  
-  for (int i = 0; i < 4; i++) {
-    int hourlyIndex = hourlyIndices[i];
-    
-    if (hourlyIndex < doc["hourly"].size()) {
-      storeWeatherInfo(i + 1, doc["hourly"][hourlyIndex]["dt"], 
-                      doc["hourly"][hourlyIndex]["weather"][0]["icon"],
-                      doc["hourly"][hourlyIndex]["temp"].as<float>(), 
-                      doc["hourly"][hourlyIndex]["pop"].as<float>());
-    } else {
-      Serial.print("Warning: Hourly index ");
-      Serial.print(hourlyIndex);
-      Serial.println(" is out of range");
+/**
+ * Keeps the parse stage at the high clock only while it parses
+ * 
+ * @param stage Parse stage
+ * @param waiting true when it starts waiting for the body or the render stage
+ */
+void parseStageWaiting(PipeStage* stage, bool waiting) {
+  if (waiting) {
+    ClockGovernor_Leave(WAKE_PHASE_PARSE);
+  } else {
+    ClockGovernor_Enter(WAKE_PHASE_PARSE);
+  }
+}
+
+/**
+ * Parse stage: reads forecast entries as their bytes arrive
+ * 
+ * Fills the pipeline's forecast cache, and sends each column to the
+ * render stage as soon as the entry it shows has been read. The columns
+ * are the parsed entries themselves, not their cached copies, so they
+ * show the pop to the percent. The response starts with
+ * "current", followed by the "hourly" array.
+ * 
+ * @param stage Stage whose context is the UpdatePipeline
+ */
+void parseStage(PipeStage* stage) {
+  UpdatePipeline* pipeline = (UpdatePipeline*)stage->context;
+  PipeReader reader(pipeline->chunks, stage, STAGE_TIMEOUT_MS);
+  ForecastCache* cache = &pipeline->cache;
+  ForecastInfo info;
+  int nextSlot = 0;
+  ClockGovernor_Enter(WAKE_PHASE_PARSE);
+
+  ArenaAllocator allocator(&wakeArena);
+  JsonDocument filter(&allocator);
+  buildEntryFilter(filter);
+
+  // Current Weather Fills the First Column
+  if (reader.find("\"current\"") && reader.find(":") && readForecastEntry(reader, filter, info)) {
+    ForecastCache_Begin(cache, &info);
+    sendForecastSlot(pipeline, stage, nextSlot++, info);
+
+    // Future Weather (3, 6, 9, 12 hours later) as the Hourly Series Arrives
+    if (reader.find("\"hourly\"") && reader.find("[")) {
+      int c = skipWhitespace(reader);
+      while (c != ']' && c >= 0 && readForecastEntry(reader, filter, info)) {
+        if (!ForecastCache_Append(cache, &info)) {
+          break;
+        }
+
+        int present = (cache->fetchedAt - cache->firstHour) / 3600;
+        if (nextSlot < FORECAST_COUNT && cache->fetchedAt >= cache->firstHour &&
+            cache->count - 1 == present + FORECAST_HOUR_OFFSETS[nextSlot]) {
+          sendForecastSlot(pipeline, stage, nextSlot++, info);
+        }
+
+        c = skipWhitespace(reader);
+        if (c == ',') {
+          reader.read();
+          c = skipWhitespace(reader);
+        }
+      }
+      pipeline->parsed = c == ']' || cache->count == FORECAST_CACHE_HOURS;
     }
   }
 
-  // Display Retrieved Data on Serial Monitor
-  printWeatherData();
-  
-  Serial.println("Weather forecast data analyzed successfully");
-  return true;
+  // End of Forecast, and Let the Network Stage Finish
+  sendForecastSlot(pipeline, stage, -1, info);
+  ClockGovernor_Leave(WAKE_PHASE_PARSE);
+  reader.drain();
 }
 
 /**
- * Fetches and analyzes weather forecast data
+ * Render stage: draws each forecast column as soon as it arrives
+ * 
+ * The panel is left alone until a column differs from what it shows;
+ * the first such column powers and prepares it while the rest of the
+ * response is still on its way, and the columns are then rasterised one
+ * by one. The panel is refreshed once the whole forecast has been
+ * parsed. An incomplete forecast is not shown: a partial update leaves
+ * the panel as it was, and a panel cleared for a full refresh is redrawn
+ * by displayLastGoodForecast.
  * 
- * Retrieves current weather and hourly forecast data,
- * then stores it in the forecast array
+ * @param stage Stage whose context is the UpdatePipeline
  */
-void fetchAndAnalyzeWeatherData() {
-  // Fetch weather data
-  String jsonData = fetchWeatherData();
-  
-  // Check if data was fetched successfully
-  if (jsonData.isEmpty()) {
+void renderStage(PipeStage* stage) {
+  UpdatePipeline* pipeline = (UpdatePipeline*)stage->context;
+  ForecastSlotText slots[FORECAST_COUNT];
+  uint32_t fingerprints[FORECAST_COUNT];
+  uint8_t received = 0;
+  uint8_t changed = 0;
+  bool panelKnown = panelState.magic == PANEL_STATE_MAGIC;
+  bool started = false;
+  bool partial = false;
+
+  if (panelKnown) {
+    memcpy(slots, panelState.slots, sizeof(slots));
+  }
+
+  SlotMessage message;
+  while (Pipe_Receive(pipeline->slots, &message, STAGE_TIMEOUT_MS, stage) && message.index >= 0) {
+    int i = message.index;
+    Forecast_FormatSlot(&slots[i], &message.info, TIMEZONE_OFFSET * 3600, TEMPERATURE_UNIT == 0 ? 'C' : 'F',
+                        i != 0, 0);
+    fingerprints[i] = Forecast_Fingerprint(&slots[i]);
+    received |= 1 << i;
+    bool unchanged = panelKnown && fingerprints[i] == panelState.fingerprints[i];
+    if (!unchanged) {
+      changed |= 1 << i;
+    }
+
+    if (!started) {
+      if (unchanged) {
+        continue;
+      }
+      // First Change: Prepare the Panel
+      started = true;
+      partial = beginPanelUpdate();
+      if (!partial) {
+        // Whole Frame: the Columns Received So Far, Blank Columns Still to Come
+        for (int j = 0; j < FORECAST_COUNT; j++) {
+          if ((received & (1 << j)) == 0) {
+            memset(&slots[j], 0, sizeof(slots[j]));
+            slots[j].iconNumber = ICON_UNKNOWN;
+          }
+        }
+        renderForecastFrame(slots, ALL_SLOTS);
+        continue;
+      }
+    } else if (unchanged && partial) {
+      continue;
+    }
+    renderForecastFrame(slots, 1 << i);
+  }
+
+  if (!pipeline->parsed || received != ALL_SLOTS) {
+    Serial.println("Forecast incomplete, display not updated");
     return;
   }
-  
-  // Store JSON data in global buffer for potential debugging
-  jsonBuffer = jsonData;
-  
-  // Analyze the weather data
-  if (!analyzeWeatherData(jsonData)) {
-    enterDeepSleep(true);
+  if (changed == 0 && panelState.batteryBars == batteryBars) {
+    Serial.println("Forecast unchanged, display update skipped");
+    return;
+  }
+  if (!started) {
+    // Battery Glyph Only, or the Whole Frame Once Partial Updates Are Used Up
+    partial = beginPanelUpdate();
+    renderForecastFrame(slots, partial ? 0 : ALL_SLOTS);
+  }
+  finishPanelUpdate(slots, fingerprints, partial, changed);
+}
+
+/**
+ * Prints the timings of the pipeline stages to Serial
+ * 
+ * @param stages Stages run by Pipe_Run
+ * @param count Number of stages
+ */
+void printStageTimings(const PipeStage* stages, int count) {
+  for (int i = 0; i < count; i++) {
+    Serial.print("Stage ");
+    Serial.print(stages[i].name);
+    Serial.print(" (core ");
+    Serial.print(stages[i].core);
+    Serial.print("): ");
+    Serial.print(stages[i].startUs / 1000);
+    Serial.print(" - ");
+    Serial.print(stages[i].endUs / 1000);
+    Serial.print(" ms, waiting ");
+    Serial.print(stages[i].waitUs / 1000);
+    Serial.println(" ms");
+  }
+}
+
+/**
+ * Fetches, parses and displays the weather forecast as concurrent stages
+ * 
+ * The network stage runs on the core of the WiFi driver; the parse and
+ * render stages run on the other core, so the forecast is parsed while
+ * the body is still arriving and each column is drawn as soon as its
+ * entry is complete.
+ * 
+ * @return true if the forecast array holds a new forecast
+ */
+bool fetchAndDisplayWeatherData() {
+  char* url = NULL;
+
+  if (!TEST_MODE) {
+    // Build OpenWeatherMap API Request URL
+    url = (char*)Arena_Alloc(&wakeArena, URL_BUFFER_SIZE);
+    if (url == NULL) {
+      Serial.println("Out of arena memory for the request URL");
+      return false;
+    }
+    snprintf(url, URL_BUFFER_SIZE,
+             "http://api.openweathermap.org/data/3.0/onecall?lat=%.5f&lon=%.5f&units=%s&lang=en&exclude=minutely,daily,alerts&appid=%s",
+             (float) LATITUDE, (float) LONGITUDE, TEMPERATURE_UNIT == 0 ? "metric" : "imperial", OPENWEATHERMAP_API_KEY);
+  }
+
+  UpdatePipeline pipeline = {};
+  pipeline.url = url;
+  pipeline.httpCode = RETRY_CODE_NO_NETWORK;
+  pipeline.retryAfter = -1;
+  pipeline.chunks = Pipe_CreateQueue(sizeof(PipeChunk), CHUNK_QUEUE_DEPTH);
+  pipeline.slots = Pipe_CreateQueue(sizeof(SlotMessage), SLOT_QUEUE_DEPTH);
+
+  PipeStage stages[] = {
+    {"network", networkStage, &pipeline, NETWORK_CORE, STAGE_STACK_SIZE, 0, 0, 0, NULL},
+    {"parse", parseStage, &pipeline, RENDER_CORE, STAGE_STACK_SIZE, 0, 0, 0, parseStageWaiting},
+    {"render", renderStage, &pipeline, RENDER_CORE, STAGE_STACK_SIZE, 0, 0, 0, NULL}
+  };
+  const int stageCount = sizeof(stages) / sizeof(stages[0]);
+
+  Serial.println("Fetching weather forecast data from OpenWeatherMap...");
+
+  // Failures are retried by a later wake (see retryUpdateLater), not here with the radio on
+  bool completed = pipeline.chunks != NULL && pipeline.slots != NULL && Pipe_Run(stages, stageCount);
+  Pipe_DeleteQueue(pipeline.chunks);
+  Pipe_DeleteQueue(pipeline.slots);
+  if (!completed) {
+    Serial.println("Failed to start the update pipeline");
+    return false;
+  }
+  printStageTimings(stages, stageCount);
+  WAKE_PROFILE_ADD(WAKE_PHASE_PARSE, stages[1].endUs - stages[1].startUs - stages[1].waitUs);  // Parse stage, less its waits
+
+  updateResult = pipeline.httpCode;
+  retryAfterSeconds = pipeline.retryAfter;
+
+  // Calibrate the Local Clock Against the Date of Any Response
+  // The local clock itself is never set, so drift stays measurable between syncs
+  if (pipeline.serverTime != 0) {
+    WakeScheduler_Sync(&wakeSchedule, pipeline.serverTime, pipeline.serverLocalUs);
+  }
+
+  switch (pipeline.httpCode) {
+    case HTTP_CODE_OK:
+      break;
+    case HTTP_CODE_BAD_REQUEST:
+      displayErrorMessage("Either some mandatory parameters in the request are missing or some of request parameters have incorrect format or values out of allowed range.");
+      enterDeepSleep(false);
+      break;
+    case HTTP_CODE_UNAUTHORIZED:
+      displayErrorMessage("API token did not providen in the request or in case API token provided in the request does not grant access to this API.");
+      enterDeepSleep(false);
+      break;
+    case HTTP_CODE_NOT_FOUND:
+      displayErrorMessage("Data with requested parameters (lat, lon, date etc) does not exist in service database.");
+      enterDeepSleep(false);
+      break;
+    case HTTP_CODE_TOO_MANY_REQUESTS:
+      Serial.println("Key quota of requests for provided API to this API was exceeded.");
+      return false;
+    default:
+      // Server errors, network errors (negative codes) and unexpected responses
+      Serial.println("Unexpected Error.");
+      return false;
+  }
+
+  if (!pipeline.parsed) {
+    updateResult = RETRY_CODE_BAD_RESPONSE;
+    return false;
   }
+
+  // Store the Whole Hourly Series
+  forecastCache = pipeline.cache;
+  Serial.print("Cached ");
+  Serial.print(forecastCache.count);
+  Serial.println(" hourly forecasts");
+
+  // Current Weather and Future Weather (3, 6, 9, 12 hours later)
+  if (fillForecastsFromCache(forecastCache.fetchedAt) < FORECAST_COUNT) {
+    Serial.println("Warning: Hourly forecast is shorter than the display");
+  }
+
+  // Display Retrieved Data on Serial Monitor
+  printWeatherData();
+
+  Serial.println("Weather forecast data analyzed successfully");
+  return true;
 }
 
 /**
  * Function to Perform Initialization
  */
 void setup() {
+  // Time From Reset to Here
+  WAKE_PROFILE_ADD(WAKE_PHASE_BOOT, micros());
+
   // Initialize Serial Communication
   Serial.begin(115200);
   Serial.println("Weather Forecast Display System Starting...");
 
-  // Set E-Paper Display Power Pin
-  const int epdPowerPin = 7;     // GPIO pin for E-Paper power control
-  pinMode(epdPowerPin, OUTPUT);
-  digitalWrite(epdPowerPin, HIGH);
+  // Check the State Kept Across Deep Sleep, Recovering the Forecast After a Power Loss
+  loadState();
 
-  // Initialize E-Paper Display GPIO
-  EPD_GPIOInit();
-  
-  // Only connect to WiFi if not in test mode
-  if (!TEST_MODE) {
-    // WiFi Connection
-    if (!connectToWiFi()) {
-      displayErrorMessage("WiFi Connection Error");
-      enterDeepSleep(false);
-      return;
-    }
+  // Run at the Low Clock Except in Compute and Bus Phases
+  if (!ClockGovernor_Init(&CLOCK_POLICY)) {
+    Serial.println("CPU clock policy not applied");
+  }
+
+  // Create the Per-Wake Arena
+  initWakeArena();
+
+  // Select Fonts and Icons
+  loadAssets();
+
+  Retry_Init(&retryState, esp_random());
+  WakeScheduler_Init(&wakeSchedule);
+  readBattery();
+#ifdef WAKE_PROFILE
+  WakeProfile_Init(&wakeProfileLog);
+#endif
+
+  // Skip the Network While the Cached Forecast is Fresh
+  if (!TEST_MODE && loadCachedForecast()) {
+    displayWeatherForecast();
+    WakeScheduler_RecordLead(&wakeSchedule, millis());
+    enterDeepSleep(true);
+    return;
   }
   
-  // Fetch and Analyze Weather forecast Data
-  fetchAndAnalyzeWeatherData();
-  
-  // Only disconnect WiFi if not in test mode
-  if (!TEST_MODE) {
-    // Disconnect WiFi (Power Saving)
+  // Only connect to WiFi if not in test mode
+  bool updated = false;
+  if (TEST_MODE) {
+    updated = fetchAndDisplayWeatherData();
+  } else {
+    // WiFi Connection, then Fetch, Analyze and Display Weather forecast Data
+    updated = connectToWiFi() && fetchAndDisplayWeatherData();
+
+    // Disconnect WiFi (Power Saving), Already Done by the Network Stage After a Request
     disconnectWiFi();
   }
 
-  // Display Weather Forecast
+  // Keep the Last Good Forecast on Screen and Retry With Backoff on Failure
+  if (!updated) {
+    uint32_t retrySeconds = retryUpdateLater();
+    displayLastGoodForecast();
+    enterDeepSleep(true, retrySeconds);
+    return;
+  }
+  Retry_OnSuccess(&retryState);
+
+  // Display Weather Forecast, Unless the Render Stage Already Did
   displayWeatherForecast();
+  WakeScheduler_RecordLead(&wakeSchedule, millis());
   
   // Enter Deep-Sleep Mode
   enterDeepSleep(true);
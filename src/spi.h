@@ -1,7 +1,11 @@
 #ifndef _SPI_H_
 #define _SPI_H_
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h> // Host builds only use the drawing functions
+#endif
 
 //Project Board
 #define SCK 12
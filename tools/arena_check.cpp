@@ -0,0 +1,245 @@
+/**
+ * Checks the wake-cycle arena and its ArduinoJson allocator on the host
+ *
+ * Exercises Arena over a plain array: the ARENA_ALIGN alignment of blocks
+ * of every size, NULL once the buffer is exhausted and for sizes that
+ * would overflow, growing, shrinking and freeing the most recent block in
+ * place, copying an older block on Realloc, Mark and Rewind, and Reset,
+ * which keeps the high-water mark. Random allocation sequences are checked
+ * for overlapping blocks.
+ *
+ * If ArduinoJson is on the include path, also checks ArenaAllocator: a
+ * JsonDocument built in the arena deserializes and serializes back to the
+ * same text, parses again from the same space after Arena_Reset, and
+ * reports NoMemory when the arena is too small. Without it that part is
+ * skipped. ArduinoJson comes from the PlatformIO library folder, filled by
+ * the first "pio run". Exits with 1 on a failure.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc -I.pio/libdeps/esp32-s3-devkitc-1/ArduinoJson/src tools/arena_check.cpp \
+ *       src/Arena.cpp -o arena_check
+ *   ./arena_check
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Arena.h"
+#if __has_include(<ArduinoJson.h>)
+#include "ArenaAllocator.h"
+#define ARENA_CHECK_JSON 1
+#endif
+#include "check.h"
+
+static const size_t CAPACITY = 4096;
+
+static bool inside(const ARENA* arena, const void* ptr, size_t size) {
+  const uint8_t* p = (const uint8_t*)ptr;
+  return p >= arena->base && p + size <= arena->base + arena->capacity;
+}
+
+static void checkAlignment(uint8_t* buffer) {
+  ARENA arena;
+  Arena_Init(&arena, buffer, CAPACITY);
+  bool aligned = true;
+  for (size_t size = 1; size <= 40; size++) {
+    void* block = Arena_Alloc(&arena, size);
+    aligned = aligned && block != NULL && (uintptr_t)block % ARENA_ALIGN == 0 && inside(&arena, block, size);
+  }
+  check(aligned, "every block is aligned to ARENA_ALIGN and inside the buffer");
+  check(arena.used % ARENA_ALIGN == 0 && arena.highWater == arena.used, "used and the high-water mark");
+}
+
+static void checkExhaustion(uint8_t* buffer) {
+  ARENA arena;
+  Arena_Init(&arena, buffer, CAPACITY);
+  check(Arena_Alloc(&arena, 0) == NULL, "a zero-size block is refused");
+  check(Arena_Alloc(&arena, CAPACITY) == NULL, "a block plus its header larger than the buffer is refused");
+  check(Arena_Alloc(&arena, SIZE_MAX) == NULL && Arena_Alloc(&arena, SIZE_MAX - 20) == NULL,
+        "sizes that would overflow are refused");
+  check(arena.used == 0, "a refused block takes nothing");
+
+  int blocks = 0;
+  while (Arena_Alloc(&arena, 100) != NULL) {
+    blocks++;
+  }
+  check(blocks > 0 && arena.used <= CAPACITY && CAPACITY - arena.used < 100 + 2 * ARENA_ALIGN + sizeof(size_t) * 2,
+        "the buffer fills up to the last block that fits");
+  size_t used = arena.used;
+  check(Arena_Alloc(&arena, 200) == NULL && arena.used <= CAPACITY && arena.used >= used,
+        "a full arena refuses a block");
+
+  ARENA empty;
+  Arena_Init(&empty, NULL, CAPACITY);
+  check(empty.capacity == 0 && Arena_Alloc(&empty, 1) == NULL, "an arena without a buffer allocates nothing");
+}
+
+static void checkLastBlock(uint8_t* buffer) {
+  ARENA arena;
+  Arena_Init(&arena, buffer, CAPACITY);
+  uint8_t* first = (uint8_t*)Arena_Alloc(&arena, 16);
+  memset(first, 0xA5, 16);
+  uint8_t* last = (uint8_t*)Arena_Alloc(&arena, 24);
+  memset(last, 0x5A, 24);
+  size_t usedBefore = arena.used;
+
+  uint8_t* grown = (uint8_t*)Arena_Realloc(&arena, last, 1000);
+  check(grown == last && arena.used == usedBefore + 1000 - 24, "the most recent block grows in place");
+  check(grown[0] == 0x5A && grown[23] == 0x5A, "growing keeps the contents");
+  check(Arena_Realloc(&arena, last, CAPACITY) == NULL && arena.used == usedBefore + 1000 - 24,
+        "growing past the buffer fails and keeps the block");
+  check(Arena_Realloc(&arena, last, 8) == last && arena.used == usedBefore - 16, "the most recent block shrinks");
+  size_t highWater = arena.highWater;
+
+  Arena_Free(&arena, last);
+  check(arena.used == usedBefore - 16 - 8 - 16, "freeing the most recent block gives its space back");
+  Arena_Free(&arena, first);
+  check(arena.used == 0, "the block before it becomes the most recent one");
+  Arena_Free(&arena, NULL);
+  check(arena.highWater == highWater, "freeing keeps the high-water mark");
+
+  // An older block is copied on Realloc and only given back by Reset
+  first = (uint8_t*)Arena_Alloc(&arena, 16);
+  memset(first, 0xA5, 16);
+  last = (uint8_t*)Arena_Alloc(&arena, 16);
+  usedBefore = arena.used;
+  Arena_Free(&arena, first);
+  check(arena.used == usedBefore, "freeing an older block gives nothing back");
+  uint8_t* copy = (uint8_t*)Arena_Realloc(&arena, first, 64);
+  check(copy != NULL && copy > last && copy[0] == 0xA5 && copy[15] == 0xA5, "an older block is copied on Realloc");
+  check(Arena_Realloc(&arena, NULL, 32) != NULL, "Realloc of NULL allocates");
+
+  Arena_Reset(&arena);
+  check(arena.used == 0 && arena.last == SIZE_MAX && arena.highWater >= usedBefore, "Reset keeps the high-water mark");
+  check(Arena_Alloc(&arena, 16) == first, "Reset starts over at the beginning of the buffer");
+}
+
+static void checkMark(uint8_t* buffer) {
+  ARENA arena;
+  Arena_Init(&arena, buffer, CAPACITY);
+  void* kept = Arena_Alloc(&arena, 40);
+  ARENA_MARK mark = Arena_Mark(&arena);
+  for (int round = 0; round < 100; round++) {
+    void* entry = Arena_Alloc(&arena, 300);
+    void* grown = Arena_Realloc(&arena, entry, 900);
+    check(entry != NULL && grown == entry, "each round fits again after Rewind");
+    Arena_Rewind(&arena, mark);
+  }
+  check(arena.used == mark.used && arena.highWater < 40 + 900 + 4 * ARENA_ALIGN + 4 * sizeof(size_t),
+        "Rewind reuses the same space every round");
+  check(Arena_Realloc(&arena, kept, 80) == kept, "the block before the mark is the most recent one again");
+
+  ARENA_MARK later = Arena_Mark(&arena);
+  Arena_Reset(&arena);
+  Arena_Rewind(&arena, later);
+  check(arena.used == 0, "a mark above the top is ignored");
+}
+
+/**
+ * Random allocations, frees and reallocs, each block filled with its own byte
+ */
+static void checkRandom(uint8_t* buffer) {
+  ARENA arena;
+  Arena_Init(&arena, buffer, CAPACITY);
+  uint32_t random = 0x9E3779B9;
+  bool intact = true;
+  for (int round = 0; round < 1000; round++) {
+    uint8_t* blocks[16];
+    size_t sizes[16];
+    int count = 0;
+    for (int step = 0; step < 40 && count < 16; step++) {
+      size_t size = 1 + nextRandom(&random) % 300;
+      uint32_t action = nextRandom(&random) % 4;
+      if (action == 0 && count > 0) {
+        Arena_Free(&arena, blocks[--count]);
+      } else if (action == 1 && count > 0) {
+        uint8_t* block = (uint8_t*)Arena_Realloc(&arena, blocks[count - 1], size);
+        if (block != NULL) {
+          blocks[count - 1] = block;
+          sizes[count - 1] = size;
+          memset(block, count, size);
+        }
+      } else {
+        uint8_t* block = (uint8_t*)Arena_Alloc(&arena, size);
+        if (block != NULL) {
+          blocks[count] = block;
+          sizes[count] = size;
+          count++;
+          memset(block, count, size);
+        }
+      }
+    }
+    for (int i = 0; i < count; i++) {
+      intact = intact && inside(&arena, blocks[i], sizes[i]) && (uintptr_t)blocks[i] % ARENA_ALIGN == 0;
+      for (size_t j = 0; j < sizes[i]; j++) {
+        intact = intact && blocks[i][j] == i + 1;
+      }
+    }
+    Arena_Reset(&arena);
+  }
+  check(intact, "no two live blocks overlap");
+  check(arena.highWater <= CAPACITY, "the high-water mark stays within the buffer");
+}
+
+#ifdef ARENA_CHECK_JSON
+static void checkAllocator(uint8_t* buffer) {
+  static const char JSON[] =
+      "{\"current\":{\"dt\":1767225600,\"temp\":21.5,\"weather\":[{\"id\":800,\"icon\":\"01d\"}]},"
+      "\"hourly\":[{\"dt\":1767229200,\"temp\":20,\"pop\":0.25},{\"dt\":1767232800,\"temp\":-3.5,\"pop\":1}]}";
+  ARENA arena;
+  Arena_Init(&arena, buffer, CAPACITY);
+  ArenaAllocator allocator(&arena);
+
+  // The adapter itself
+  void* block = allocator.allocate(10);
+  check(block != NULL && (uintptr_t)block % ARENA_ALIGN == 0, "allocate returns an aligned block");
+  check(allocator.reallocate(block, 100) == block, "reallocate grows the most recent block in place");
+  allocator.deallocate(block);
+  check(arena.used == 0, "deallocate gives the most recent block back");
+
+  // A document in the arena
+  char out[sizeof(JSON)];
+  size_t peak = 0;
+  for (int round = 0; round < 2; round++) {
+    {
+      JsonDocument doc(&allocator);
+      check(deserializeJson(doc, JSON) == DeserializationError::Ok, "the document parses in the arena");
+      check(doc["current"]["weather"][0]["id"] == 800 && doc["hourly"][1]["temp"] == -3.5 &&
+            strcmp(doc["current"]["weather"][0]["icon"] | "", "01d") == 0, "the values read back");
+      check(serializeJson(doc, out, sizeof(out)) == sizeof(JSON) - 1 && strcmp(out, JSON) == 0,
+            "the document serializes to the same text");
+      check(arena.used > 0 && arena.used <= CAPACITY, "the document lives in the arena");
+    }
+    check(round == 0 || arena.highWater == peak, "a reset arena parses the same document in no more space");
+    peak = arena.highWater;
+    Arena_Reset(&arena);
+  }
+  printf("JsonDocument of %u bytes of text: %u bytes of arena\n", (unsigned)(sizeof(JSON) - 1), (unsigned)peak);
+
+  // Too small an arena
+  Arena_Init(&arena, buffer, 64);
+  JsonDocument doc(&allocator);
+  check(deserializeJson(doc, JSON) == DeserializationError::NoMemory, "a full arena reports NoMemory");
+  check(arena.highWater <= 64, "a full arena stays within its buffer");
+}
+#endif
+
+int main() {
+  alignas(ARENA_ALIGN) static uint8_t buffer[CAPACITY];
+  checkAlignment(buffer);
+  checkExhaustion(buffer);
+  checkLastBlock(buffer);
+  checkMark(buffer);
+  checkRandom(buffer);
+#ifdef ARENA_CHECK_JSON
+  checkAllocator(buffer);
+#else
+  printf("ArduinoJson not found, ArenaAllocator skipped\n");
+#endif
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * Replays a battery voltage trace through the battery policy
+ *
+ * Wakes the way the device does: each wake samples the trace with ADC
+ * noise, averages the samples (Battery_Average), updates the state
+ * (Battery_Update) and sleeps for the interval the state asks for. Prints
+ * every change of policy step and glyph, and the wakes saved against the
+ * fixed interval over the length of the trace. Also checks the curve and
+ * the step hysteresis, and exits with 1 on a failure.
+ *
+ * A trace is a text file of "hours,millivolts" lines in time order, as
+ * logged by the device; lines starting with # are ignored. Without a
+ * file, a synthetic trace is used: a LiPo cell discharging over 40 days,
+ * with load noise and a USB charge on day 30.
+ *
+ * The policy below mirrors BATTERY_CURVE, BATTERY_STEPS and
+ * BATTERY_POLICY in main.cpp.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/battery_trace.cpp src/Battery.cpp -o battery_trace
+ *   ./battery_trace [trace.csv]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "Battery.h"
+#include "check.h"
+
+static const BatteryCurvePoint CURVE[] = {
+  {4200, 100}, {4100, 90}, {4000, 79}, {3900, 64}, {3800, 48}, {3750, 38},
+  {3700, 27}, {3650, 16}, {3600, 9}, {3500, 4}, {3300, 0}
+};
+static const BatteryStep STEPS[] = {
+  {30, 2, 48},
+  {15, 4, 96},
+  {5, 12, UINT16_MAX}
+};
+static const BatteryPolicy POLICY = {
+  CURVE, sizeof(CURVE) / sizeof(CURVE[0]),
+  STEPS, sizeof(STEPS) / sizeof(STEPS[0]),
+  5,
+  4350
+};
+static const uint32_t INTERVAL_SECONDS = 3600;
+static const int SAMPLES = 16;
+static const int FULL_BARS = 4;
+
+struct TracePoint {
+  double hours;
+  double millivolts;
+};
+
+/**
+ * Uniform noise in [-amplitude, amplitude]
+ */
+static double noise(uint32_t* random, double amplitude) {
+  return ((nextRandom(random) % 20001) / 10000.0 - 1.0) * amplitude;
+}
+
+static bool loadTrace(const char* path, std::vector<TracePoint>& trace) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    TracePoint point;
+    if (line[0] != '#' && sscanf(line, "%lf,%lf", &point.hours, &point.millivolts) == 2) {
+      trace.push_back(point);
+    }
+  }
+  fclose(file);
+  return trace.size() >= 2;
+}
+
+/**
+ * Synthetic trace: the curve walked down linearly in capacity over 40
+ * days, then a charge back to full on day 30
+ */
+static void syntheticTrace(std::vector<TracePoint>& trace) {
+  uint32_t random = 0x2545F491;
+  for (double hours = 0; hours <= 40 * 24; hours += 0.5) {
+    double day = hours / 24;
+    double percent = day < 30 ? 100 - day * 3.2 : 100 - (day - 30) * 3.2;
+    if (percent < 0) {
+      percent = 0;
+    }
+    // Invert the curve: find the voltage of this capacity
+    double millivolts = CURVE[0].millivolts;
+    for (size_t i = 1; i < sizeof(CURVE) / sizeof(CURVE[0]); i++) {
+      if (percent >= CURVE[i].percent) {
+        double t = (percent - CURVE[i].percent) / (CURVE[i - 1].percent - CURVE[i].percent);
+        millivolts = CURVE[i].millivolts + t * (CURVE[i - 1].millivolts - CURVE[i].millivolts);
+        break;
+      }
+      millivolts = CURVE[i].millivolts;
+    }
+    TracePoint point = {hours, millivolts + noise(&random, 15)};
+    trace.push_back(point);
+  }
+}
+
+/**
+ * Voltage of the trace at a time, interpolated
+ */
+static double traceAt(const std::vector<TracePoint>& trace, double hours) {
+  for (size_t i = 1; i < trace.size(); i++) {
+    if (hours <= trace[i].hours) {
+      double t = (hours - trace[i - 1].hours) / (trace[i].hours - trace[i - 1].hours);
+      return trace[i - 1].millivolts + t * (trace[i].millivolts - trace[i - 1].millivolts);
+    }
+  }
+  return trace.back().millivolts;
+}
+
+/**
+ * Checks of the curve, the averaging and the hysteresis on fixed inputs
+ */
+static void checkPolicy() {
+  for (size_t i = 0; i < sizeof(CURVE) / sizeof(CURVE[0]); i++) {
+    check(Battery_Percent(&POLICY, CURVE[i].millivolts) == CURVE[i].percent, "curve points map to their capacity");
+  }
+  check(Battery_Percent(&POLICY, 4500) == 100 && Battery_Percent(&POLICY, 3000) == 0, "curve ends are clamped");
+  uint8_t previous = 100;
+  for (uint16_t mv = 4200; mv >= 3300; mv -= 5) {
+    uint8_t percent = Battery_Percent(&POLICY, mv);
+    check(percent <= previous, "capacity falls with the voltage");
+    previous = percent;
+  }
+
+  uint16_t samples[SAMPLES];
+  for (int i = 0; i < SAMPLES; i++) {
+    samples[i] = 3800;
+  }
+  samples[3] = 100;
+  samples[9] = 4095;
+  check(Battery_Average(samples, SAMPLES) == 3800, "outlier samples are dropped");
+
+  // A voltage wavering across the 30% threshold enters the step once
+  BatteryState state;
+  memset(&state, 0, sizeof(state));
+  Battery_Init(&state);
+  int changes = 0;
+  uint8_t level = 0;
+  for (int i = 0; i < 200; i++) {
+    Battery_Update(&state, &POLICY, i % 2 == 0 ? 3690 : 3730);
+    if (state.level != level) {
+      changes++;
+      level = state.level;
+    }
+  }
+  check(changes == 1, "a wavering voltage does not switch steps back and forth");
+
+  Battery_Update(&state, &POLICY, 4400);
+  check(state.external && state.level == 0, "external power leaves every step at once");
+}
+
+int main(int argc, char** argv) {
+  std::vector<TracePoint> trace;
+  if (argc > 1) {
+    if (!loadTrace(argv[1], trace)) {
+      printf("Cannot read a trace from %s\n", argv[1]);
+      return 1;
+    }
+  } else {
+    syntheticTrace(trace);
+  }
+
+  checkPolicy();
+
+  BatteryState state;
+  memset(&state, 0, sizeof(state));
+  Battery_Init(&state);
+  uint32_t random = 0x9E3779B9;
+  double end = trace.back().hours;
+  int wakes = 0;
+  int lastLevel = -1, lastBars = -1;
+  int levelChanges = 0, glyphUpdates = 0;
+
+  printf("   hour      mV    %%  step  bars  interval\n");
+  for (double hours = trace.front().hours; hours <= end; ) {
+    uint16_t samples[SAMPLES];
+    double millivolts = traceAt(trace, hours);
+    for (int i = 0; i < SAMPLES; i++) {
+      samples[i] = (uint16_t)lround(millivolts + noise(&random, 20));
+    }
+    Battery_Update(&state, &POLICY, Battery_Average(samples, SAMPLES));
+    uint32_t interval = Battery_IntervalSeconds(&state, &POLICY, INTERVAL_SECONDS);
+    int bars = Battery_Bars(&state, FULL_BARS, lastBars);
+    wakes++;
+
+    if (state.level != lastLevel || bars != lastBars) {
+      printf("%7.1f  %6u  %3u  %4u  %4d  %6u s%s\n", hours, state.millivolts, state.percent, state.level, bars,
+             interval, state.external ? "  external" : "");
+      levelChanges += state.level != lastLevel && lastLevel >= 0;
+      glyphUpdates += bars != lastBars && lastBars >= 0;
+      lastLevel = state.level;
+      lastBars = bars;
+    }
+    check(interval >= INTERVAL_SECONDS, "the interval is never shortened");
+    hours += interval / 3600.0;
+  }
+
+  int fixedWakes = (int)((end - trace.front().hours) * 3600 / INTERVAL_SECONDS) + 1;
+  printf("%d wakes over %.0f hours, %d at the fixed interval (%d saved)\n", wakes, end - trace.front().hours,
+         fixedWakes, fixedWakes - wakes);
+  printf("%d step changes, %d glyph changes\n", levelChanges, glyphUpdates);
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Builds an asset pack (see src/AssetPack.h) from the fonts and icons in src/.
+
+The pack holds the three EPD_ShowChar fonts and the compressed weather icons.
+Write it to the "assets" partition to replace them without reflashing the
+firmware:
+
+    python3 tools/build_assetpack.py assets.bin
+    pio pkg exec -- esptool.py --chip esp32s3 write_flash 0x670000 assets.bin
+
+Usage:
+    python3 tools/build_assetpack.py [output]
+"""
+
+import os
+import re
+import struct
+import sys
+
+from compress_icons import ICON_HEIGHT, ICON_WIDTH, ROOT, encode_asset, parse_icons
+
+MAGIC = 0x4B415045
+VERSION = 1
+ALIGN = 16
+NAME_LENGTH = 20
+
+TYPE_BITMAP = 1
+TYPE_RLE_BITMAP = 2
+TYPE_FONT = 3
+
+HEADER_FORMAT = "<IHHII"
+ENTRY_FORMAT = "<%dsBBHHHII" % NAME_LENGTH
+
+# (asset name, header file, array name, font size)
+FONTS = [
+    ("font24", "EPDfont.h", "ascii_2412", 24),
+    ("font36", "ChivoMonoFont.h", "chivo_mono_3618", 36),
+    ("font44", "ChivoMonoFont.h", "chivo_mono_4422", 44),
+]
+
+
+def parse_font(path, array):
+    """Returns (bytes per glyph, glyph data) of a [][N] font array."""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    match = re.search(r"%s\[\]\[(\d+)\]\s*=\s*\{(.*?)\n\};" % array, text, re.S)
+    if not match:
+        sys.exit("Font array '%s' not found in %s" % (array, path))
+    stride = int(match.group(1))
+    glyphs = re.findall(r"\{([^{}]*)\}", match.group(2))
+    data = bytearray()
+    for glyph in glyphs:
+        values = re.findall(r"0[xX][0-9a-fA-F]+", glyph)
+        if len(values) > stride:
+            sys.exit("Unexpected glyph size in '%s'" % array)
+        # Missing trailing values are zero, as in the C initializer
+        data += bytes(int(v, 16) for v in values) + bytes(stride - len(values))
+    return stride, len(glyphs), bytes(data)
+
+
+def align(n):
+    return (n + ALIGN - 1) // ALIGN * ALIGN
+
+
+def main():
+    output = sys.argv[1] if len(sys.argv) > 1 else os.path.join(ROOT, "assets.bin")
+    src = os.path.join(ROOT, "src")
+
+    # (name, type, width, height, stride, blob)
+    assets = []
+    for name, header, array, size in FONTS:
+        stride, count, data = parse_font(os.path.join(src, header), array)
+        assets.append((name, TYPE_FONT, size, count, stride, data))
+
+    with open(os.path.join(src, "icons.h"), encoding="utf-8") as f:
+        icons = parse_icons(f.read())
+    for name, data in icons:
+        stream, restarts = encode_asset(data, ICON_WIDTH, ICON_HEIGHT)
+        blob = struct.pack("<%dH" % len(restarts), *restarts) + bytes(stream)
+        ident = re.sub(r"[^0-9a-zA-Z]+", "_", name).lower()
+        assets.append((ident, TYPE_RLE_BITMAP, ICON_WIDTH, ICON_HEIGHT, (ICON_WIDTH + 7) // 8, blob))
+
+    directory_offset = align(struct.calcsize(HEADER_FORMAT))
+    offset = align(directory_offset + len(assets) * struct.calcsize(ENTRY_FORMAT))
+
+    entries = bytearray()
+    blobs = bytearray()
+    for name, kind, width, height, stride, blob in assets:
+        if len(name) > NAME_LENGTH:
+            sys.exit("Asset name too long: %s" % name)
+        blob_offset = offset + len(blobs)
+        entries += struct.pack(ENTRY_FORMAT, name.encode("ascii"), kind, 0,
+                               width, height, stride, blob_offset, len(blob))
+        blobs += blob
+        blobs += bytes(align(len(blobs)) - len(blobs))
+        print("%-14s type %d %6d bytes" % (name, kind, len(blob)))
+
+    total = offset + len(blobs)
+    pack = bytearray(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(assets), directory_offset, total))
+    pack += bytes(directory_offset - len(pack))
+    pack += entries
+    pack += bytes(offset - len(pack))
+    pack += blobs
+
+    with open(output, "wb") as f:
+        f.write(pack)
+    print("Wrote %s (%d bytes)" % (output, total))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,227 @@
+/**
+ * Simulates a year of wakes with the forecast-driven cadence
+ *
+ * Replays a year of hourly weather twice: once with the fixed cadence
+ * (a wake every hour, a fetch once the forecast is 6 hours old) and once
+ * with the Cadence planner (1 to 3 hours between wakes, forecasts kept
+ * 2 to 6 hours by volatility, quiet from 23:00 to 06:00). Each fetch
+ * fills a ForecastCache with the 48 hours ahead, as the parse stage does.
+ * Reports wakes and fetches saved, and what the panel showed outside
+ * quiet hours against the weather at the time: hours with the wrong
+ * icon in the first column, and the mean temperature error.
+ *
+ * The weather is a text file of "unix time,temperature in 1/100 degrees,
+ * pop %,icon number" lines, one per hour, as logged by the device; lines
+ * starting with # are ignored, and forecasts are then the recorded
+ * weather itself. Without a file, a synthetic year is used: seasonal and
+ * daily temperature cycles under stable and unsettled spells of a few
+ * days, with forecast errors growing with lead time.
+ *
+ * The settings below mirror CADENCE_CONFIG in main.cpp with the
+ * config.template.h values, CADENCE_MAX_MINUTES 180 and QUIET_HOURS
+ * {23 * 60, 6 * 60}. Without the last two, the planner wakes every
+ * INTERVAL_IN_MINUTES and only the forecast age follows the volatility.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/cadence_sim.cpp src/Cadence.cpp src/ForecastCache.cpp -o cadence_sim
+ *   ./cadence_sim [weather.csv]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "Cadence.h"
+#include "ForecastCache.h"
+#include "check.h"
+
+static const int32_t UTC_OFFSET = 9 * 3600;
+static const int32_t YEAR_START = 1735657200;  // 2025-01-01 00:00 local
+static const int YEAR_HOURS = 365 * 24;
+static const QuietWindow QUIET[] = {{23 * 60, 6 * 60}};
+static const CadenceConfig CONFIG = {
+  60 * 60, 180 * 60,
+  120 * 60, 360 * 60,
+  12,
+  8, 24,
+  QUIET, 1,
+  UTC_OFFSET
+};
+static const uint32_t FIXED_INTERVAL = 60 * 60;
+static const uint32_t FIXED_MAX_AGE = 360 * 60;
+
+struct Hour {
+  int16_t temperature;  // 1/100 degrees
+  uint8_t pop;
+  uint8_t icon;
+};
+
+struct Result {
+  int wakes;
+  int fetches;
+  int wrongIconHours;
+  double temperatureError;
+  int awakeHours;       // Hours judged, outside quiet windows
+};
+
+static double uniform(uint32_t* random) {
+  return (nextRandom(random) % 1000001) / 1000000.0;
+}
+
+/**
+ * Synthetic weather: spells of 1 to 6 days, stable or unsettled
+ */
+static void syntheticYear(std::vector<Hour>& weather, int hours) {
+  uint32_t random = 0x1234ABCD;
+  bool unsettled = false;
+  int spellLeft = 0;
+  double front = 0;
+  double wet = 0;
+  for (int h = 0; h < hours; h++) {
+    if (spellLeft-- <= 0) {
+      unsettled = uniform(&random) < 0.4;
+      spellLeft = 24 + (int)(uniform(&random) * 5 * 24);
+      front = (uniform(&random) - 0.5) * 6;
+    }
+    double day = h / 24.0;
+    int localHour = h % 24;
+    double season = 16 - 10 * cos(2 * M_PI * (day - 20) / 365);
+    double daily = (unsettled ? 2 : 5) * sin(2 * M_PI * (localHour - 9) / 24);
+    double temperature = season + daily + (unsettled ? front : 0) + (uniform(&random) - 0.5) * 0.6;
+    bool night = localHour < 6 || localHour >= 18;
+
+    Hour hour;
+    hour.temperature = (int16_t)lround(temperature * 100);
+    if (unsettled) {
+      // Rain bands pass every half day or so
+      wet += (uniform(&random) - 0.5) * 0.25;
+      wet = wet < 0 ? 0 : wet > 1 ? 1 : wet;
+      hour.pop = (uint8_t)(wet * 90);
+      hour.icon = hour.pop >= 60 ? (temperature < 1 ? ICON_SNOW : ICON_RAIN) : hour.pop >= 20 ? ICON_CLOUDS
+                                                                                                  : ICON_MIST;
+    } else {
+      wet = 0.3;
+      hour.pop = (uint8_t)(uniform(&random) * 10);
+      hour.icon = night ? ICON_CLEAR_NIGHT : ICON_CLEAR_DAY;
+    }
+    weather.push_back(hour);
+  }
+}
+
+static bool loadYear(const char* path, std::vector<Hour>& weather) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    long time;
+    int temperature, pop, icon;
+    if (line[0] != '#' && sscanf(line, "%ld,%d,%d,%d", &time, &temperature, &pop, &icon) == 4) {
+      Hour hour = {(int16_t)temperature, (uint8_t)pop, (uint8_t)icon};
+      weather.push_back(hour);
+    }
+  }
+  fclose(file);
+  return weather.size() > 48;
+}
+
+/**
+ * Fills the cache with the forecast issued at an hour: the weather ahead
+ * with errors growing with the lead time (none for recorded weather)
+ */
+static void fetch(ForecastCache* cache, const std::vector<Hour>& weather, int issued, bool errors) {
+  uint32_t random = 0x9E3779B9u ^ (uint32_t)issued * 2654435761u;
+  ForecastInfo info;
+  info.time = YEAR_START + issued * 3600;
+  info.temperature = weather[issued].temperature;
+  info.pop = weather[issued].pop;
+  info.iconNumber = weather[issued].icon;
+  ForecastCache_Begin(cache, &info);
+  for (int lead = 0; lead < FORECAST_CACHE_HOURS && issued + lead < (int)weather.size(); lead++) {
+    const Hour& hour = weather[issued + lead];
+    double error = errors ? (uniform(&random) - 0.5) * 0.1 * lead : 0;
+    info.time = YEAR_START + (issued + lead) * 3600;
+    info.temperature = (int16_t)lround(hour.temperature + error * 100);
+    info.pop = hour.pop;
+    info.iconNumber = hour.icon;
+    ForecastCache_Append(cache, &info);
+  }
+}
+
+static uint8_t weatherIcon(uint8_t icon) {
+  return icon == ICON_CLEAR_NIGHT ? (uint8_t)ICON_CLEAR_DAY : icon;
+}
+
+static Result simulate(const std::vector<Hour>& weather, bool planned, bool errors) {
+  static const uint8_t OFFSETS[] = {0};
+  Result result = {};
+  ForecastCache cache;
+  ForecastCache_Invalidate(&cache);
+  ForecastInfo shown = {};
+  int nextWake = 0;
+  int hours = (int)weather.size() - FORECAST_CACHE_HOURS;
+
+  for (int h = 0; h < hours; h++) {
+    int32_t now = YEAR_START + h * 3600;
+    if (h >= nextWake) {
+      result.wakes++;
+      CadencePlan plan;
+      Cadence_Plan(&CONFIG, &cache, now, &plan);
+      uint32_t maxAge = planned ? plan.maxAgeSeconds : FIXED_MAX_AGE;
+      int32_t age = ForecastCache_Age(&cache, now);
+      if (age < 0 || (uint32_t)age >= maxAge) {
+        fetch(&cache, weather, h, errors);
+        result.fetches++;
+        Cadence_Plan(&CONFIG, &cache, now, &plan);
+      }
+      ForecastCache_Window(&cache, now, OFFSETS, 1, &shown);
+
+      uint32_t interval = planned ? Cadence_SkipQuiet(&CONFIG, now, plan.intervalSeconds) : FIXED_INTERVAL;
+      nextWake = h + (int)((interval + 3599) / 3600);
+    }
+
+    // Judge the panel while someone may look at it
+    int minute = (h % 24) * 60;
+    bool quiet = QUIET[0].startMinute > QUIET[0].endMinute
+                   ? minute >= QUIET[0].startMinute || minute < QUIET[0].endMinute
+                   : minute >= QUIET[0].startMinute && minute < QUIET[0].endMinute;
+    if (!quiet) {
+      result.awakeHours++;
+      result.wrongIconHours += weatherIcon(shown.iconNumber) != weatherIcon(weather[h].icon);
+      result.temperatureError += fabs(shown.temperature - weather[h].temperature) / 100.0;
+    }
+  }
+  result.temperatureError /= result.awakeHours;
+  return result;
+}
+
+static void printResult(const char* name, const Result& result) {
+  printf("%-8s %6d wakes  %5d fetches  %5d wrong-icon hours  %.2f degrees mean error\n", name, result.wakes,
+         result.fetches, result.wrongIconHours, result.temperatureError);
+}
+
+int main(int argc, char** argv) {
+  std::vector<Hour> weather;
+  bool recorded = argc > 1;
+  if (recorded) {
+    if (!loadYear(argv[1], weather)) {
+      printf("Cannot read hourly weather from %s\n", argv[1]);
+      return 1;
+    }
+  } else {
+    syntheticYear(weather, YEAR_HOURS + FORECAST_CACHE_HOURS);
+  }
+
+  Result fixed = simulate(weather, false, !recorded);
+  Result planned = simulate(weather, true, !recorded);
+  printf("%d hours, %d judged outside quiet hours\n", (int)weather.size() - FORECAST_CACHE_HOURS,
+         fixed.awakeHours);
+  printResult("fixed", fixed);
+  printResult("planned", planned);
+  printf("saved    %6d wakes (%.0f%%), %d fetches (%.0f%%)\n", fixed.wakes - planned.wakes,
+         100.0 * (fixed.wakes - planned.wakes) / fixed.wakes, fixed.fetches - planned.fetches,
+         100.0 * (fixed.fetches - planned.fetches) / fixed.fetches);
+  return 0;
+}
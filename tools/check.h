@@ -0,0 +1,39 @@
+#ifndef _TOOLS_CHECK_H_
+#define _TOOLS_CHECK_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Check helpers shared by the host tools
+ *
+ * Each tool is one program including this header once: check() prints
+ * what failed and counts it in failures, which main() reports as
+ * "%d checks FAILED" with exit code 1. nextRandom() is the xorshift32
+ * generator the tools seed with a fixed state, so every run replays the
+ * same inputs.
+ */
+
+static int failures __attribute__((unused)) = 0;
+
+static inline void check(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+/**
+ * Steps a xorshift32 state
+ *
+ * @param state Generator state, not 0
+ * @return The next state
+ */
+static inline uint32_t nextRandom(uint32_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+#endif
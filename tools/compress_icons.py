@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+Compresses the weather icons in src/icons.h into src/icons_rle.h.
+
+The output uses the row-wise PackBits format decoded by AssetCodec.cpp,
+with a restart point every ASSET_RESTART_INTERVAL rows.
+The compression ratio of every icon is printed and written to the header.
+
+Usage:
+    python3 tools/compress_icons.py
+"""
+
+import os
+import re
+import sys
+
+ICON_WIDTH = 128
+ICON_HEIGHT = 128
+RESTART_INTERVAL = 16  # Must match ASSET_RESTART_INTERVAL in AssetCodec.h
+MAX_LITERAL = 128
+MIN_REPEAT = 3
+MAX_REPEAT = 130
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+SOURCE = os.path.join(ROOT, "src", "icons.h")
+OUTPUT = os.path.join(ROOT, "src", "icons_rle.h")
+
+
+def encode_row(row):
+    """PackBits-encodes one row (same algorithm as Asset_EncodeRow)."""
+    out = bytearray()
+    i = 0
+    n = len(row)
+    while i < n:
+        run = 1
+        while i + run < n and run < MAX_REPEAT and row[i + run] == row[i]:
+            run += 1
+        if run >= MIN_REPEAT:
+            out.append(0x80 + run - MIN_REPEAT)
+            out.append(row[i])
+            i += run
+            continue
+        start = i
+        while i < n and i - start < MAX_LITERAL:
+            if i + 2 < n and row[i] == row[i + 1] == row[i + 2]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += row[start:i]
+    return out
+
+
+def encode_asset(data, width, height):
+    row_bytes = (width + 7) // 8
+    stream = bytearray()
+    restarts = []
+    for y in range(height):
+        if y % RESTART_INTERVAL == 0:
+            restarts.append(len(stream))
+        stream += encode_row(data[y * row_bytes:(y + 1) * row_bytes])
+    return stream, restarts
+
+
+def parse_icons(text):
+    """Returns a list of (name, bytes) from the Weather_Num initializer."""
+    body = text[text.index("Weather_Num"):]
+    icons = []
+    for match in re.finditer(r"//\s*([^\n]+)\n\s*\{(.*?)\}", body, re.S):
+        name = match.group(1).strip()
+        values = re.sub(r"/\*.*?\*/", "", match.group(2), flags=re.S)
+        data = bytes(int(v, 16) for v in re.findall(r"0[xX][0-9a-fA-F]+", values))
+        if len(data) != ICON_WIDTH * ICON_HEIGHT // 8:
+            sys.exit("Unexpected size for icon '%s': %d bytes" % (name, len(data)))
+        icons.append((name, data))
+    return icons
+
+
+def format_bytes(data, indent="    "):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ",".join("0X%02X" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    with open(SOURCE, encoding="utf-8") as f:
+        icons = parse_icons(f.read())
+
+    out = []
+    out.append("#ifndef _ICONS_RLE_H_")
+    out.append("#define _ICONS_RLE_H_")
+    out.append("")
+    out.append("/**")
+    out.append(" * Compressed version of the weather icons in icons.h")
+    out.append(" *")
+    out.append(" * Generated by tools/compress_icons.py. Do not edit by hand.")
+    out.append(" *")
+
+    blocks = []
+    total_raw = 0
+    total_packed = 0
+    for name, data in icons:
+        ident = re.sub(r"[^0-9a-zA-Z]+", "_", name).lower()
+        stream, restarts = encode_asset(data, ICON_WIDTH, ICON_HEIGHT)
+        packed = len(stream) + 2 * len(restarts)
+        total_raw += len(data)
+        total_packed += packed
+        ratio = len(data) / packed
+        print("%-14s %5d -> %5d bytes (%.2f:1)" % (name, len(data), packed, ratio))
+        out.append(" *   %-14s %5d -> %5d bytes (%.2f:1)" % (name, len(data), packed, ratio))
+
+        block = []
+        block.append("// %s" % name)
+        block.append("static const uint16_t icon_%s_restarts[] = {" % ident)
+        block.append("    " + ",".join(str(r) for r in restarts) + ",")
+        block.append("};")
+        block.append("static const uint8_t icon_%s_data[] = {" % ident)
+        block.append(format_bytes(stream))
+        block.append("};")
+        blocks.append((ident, len(stream), "\n".join(block)))
+
+    ratio = total_raw / total_packed
+    print("%-14s %5d -> %5d bytes (%.2f:1)" % ("total", total_raw, total_packed, ratio))
+    out.append(" *   %-14s %5d -> %5d bytes (%.2f:1)" % ("total", total_raw, total_packed, ratio))
+    out.append(" */")
+    out.append("")
+    out.append('#include "AssetCodec.h"')
+    out.append("")
+    for _, _, block in blocks:
+        out.append(block)
+        out.append("")
+    out.append("const COMPRESSED_ASSET Weather_Icons[%d] = {" % len(blocks))
+    for ident, size, _ in blocks:
+        out.append("    {%d, %d, %d, icon_%s_restarts, icon_%s_data},"
+                   % (ICON_WIDTH, ICON_HEIGHT, size, ident, ident))
+    out.append("};")
+    out.append("")
+    out.append("#endif")
+    out.append("")
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,217 @@
+/**
+ * Checks that the forecast tables and formatting allocate nothing
+ *
+ * Replaces the global operator new and delete with counting versions,
+ * then looks up every OpenWeatherMap icon code and condition id and
+ * formats forecast columns, and checks that none of it allocated. The
+ * icon codes are compared with the std::map the firmware used before,
+ * whose own allocations are reported, and every condition id must give
+ * the icon of the code the API sends with it. A few lookups are also
+ * evaluated at compile time. Temperatures kept by ForecastCache must
+ * round to the same whole degrees as the parsed ones, at the .45 to .50
+ * boundaries too, without allocating. Then times both lookups. Exits with
+ * 1 on a failure.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/forecast_alloc_check.cpp src/Forecast.cpp src/ForecastCache.cpp \
+ *       -o forecast_alloc_check
+ *   ./forecast_alloc_check
+ */
+
+#include <chrono>
+#include <map>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "Forecast.h"
+#include "ForecastCache.h"
+#include "check.h"
+
+static size_t allocations = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+  allocatedBytes += size;
+  void* ptr = malloc(size != 0 ? size : 1);
+  if (ptr == NULL) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+// Not inlined, so the compiler does not pair the free() with a new expression
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  free(ptr);
+}
+
+// Evaluated by the compiler: the tables need no start-up code
+static_assert(Forecast_IconFromCode("50n") == ICON_MIST, "icon code table");
+static_assert(Forecast_IconFromCode("99d") == ICON_UNKNOWN, "icon code table");
+static_assert(Forecast_IconFromConditionId(800, true) == ICON_CLEAR_NIGHT, "condition id table");
+static_assert(Forecast_IconFromConditionId(212, false) == ICON_THUNDERSTORM, "condition id table");
+
+/**
+ * Condition ids of the API and the icon code sent with each (day)
+ */
+static const struct {
+  uint16_t id;
+  const char* icon;
+} CONDITIONS[] = {
+  {200, "11d"}, {201, "11d"}, {202, "11d"}, {210, "11d"}, {211, "11d"}, {212, "11d"}, {221, "11d"}, {230, "11d"},
+  {231, "11d"}, {232, "11d"}, {300, "09d"}, {301, "09d"}, {302, "09d"}, {310, "09d"}, {311, "09d"}, {312, "09d"},
+  {313, "09d"}, {314, "09d"}, {321, "09d"}, {500, "10d"}, {501, "10d"}, {502, "10d"}, {503, "10d"}, {504, "10d"},
+  {511, "13d"}, {520, "09d"}, {521, "09d"}, {522, "09d"}, {531, "09d"}, {600, "13d"}, {601, "13d"}, {602, "13d"},
+  {611, "13d"}, {612, "13d"}, {613, "13d"}, {615, "13d"}, {616, "13d"}, {620, "13d"}, {621, "13d"}, {622, "13d"},
+  {701, "50d"}, {711, "50d"}, {721, "50d"}, {731, "50d"}, {741, "50d"}, {751, "50d"}, {761, "50d"}, {762, "50d"},
+  {771, "50d"}, {781, "50d"}, {800, "01d"}, {801, "02d"}, {802, "03d"}, {803, "04d"}, {804, "04d"}
+};
+static const int CONDITION_COUNT = sizeof(CONDITIONS) / sizeof(CONDITIONS[0]);
+
+/**
+ * The table the firmware built on the heap before
+ */
+static std::map<std::string, uint8_t>* oldMappings() {
+  return new std::map<std::string, uint8_t>({
+    {"01d", ICON_CLEAR_DAY}, {"01n", ICON_CLEAR_NIGHT}, {"02d", ICON_CLOUDS}, {"02n", ICON_CLOUDS},
+    {"03d", ICON_CLOUDS}, {"03n", ICON_CLOUDS}, {"04d", ICON_CLOUDS}, {"04n", ICON_CLOUDS},
+    {"09d", ICON_RAIN}, {"09n", ICON_RAIN}, {"10d", ICON_RAIN}, {"10n", ICON_RAIN},
+    {"11d", ICON_THUNDERSTORM}, {"11n", ICON_THUNDERSTORM}, {"13d", ICON_SNOW}, {"13n", ICON_SNOW},
+    {"50d", ICON_MIST}, {"50n", ICON_MIST}
+  });
+}
+
+static void checkLookups(const std::map<std::string, uint8_t>& old) {
+  // Every two-digit code, day and night, and malformed codes
+  char code[4] = {0, 0, 0, 0};
+  size_t before = allocations;
+  bool same = true;
+  for (int number = 0; number < 100; number++) {
+    for (int night = 0; night < 2; night++) {
+      code[0] = (char)('0' + number / 10);
+      code[1] = (char)('0' + number % 10);
+      code[2] = night ? 'n' : 'd';
+      uint8_t icon = Forecast_IconFromCode(code);
+      size_t counted = allocations;
+      std::map<std::string, uint8_t>::const_iterator match = old.find(code);
+      allocations = counted;  // The std::string key of the old lookup is not ours
+      same = same && icon == (match != old.end() ? match->second : (uint8_t)ICON_UNKNOWN);
+    }
+  }
+  static const char* const MALFORMED[] = {"", "0", "1", "x1d", "-1d", "5:d", "a0n"};
+  for (size_t i = 0; i < sizeof(MALFORMED) / sizeof(MALFORMED[0]); i++) {
+    same = same && Forecast_IconFromCode(MALFORMED[i]) == ICON_UNKNOWN;
+  }
+  same = same && Forecast_IconFromCode(NULL) == ICON_UNKNOWN;
+  check(same, "every icon code maps as in the old table");
+
+  // Condition ids agree with the icon code the API sends with them
+  for (int i = 0; i < CONDITION_COUNT; i++) {
+    char night[4];
+    snprintf(night, sizeof(night), "%.2sn", CONDITIONS[i].icon);
+    check(Forecast_IconFromConditionId(CONDITIONS[i].id, false) == Forecast_IconFromCode(CONDITIONS[i].icon),
+          "a condition id gives the icon of its code by day");
+    check(Forecast_IconFromConditionId(CONDITIONS[i].id, true) == Forecast_IconFromCode(night),
+          "a condition id gives the icon of its code by night");
+  }
+  check(Forecast_IconFromConditionId(0, false) == ICON_UNKNOWN && Forecast_IconFromConditionId(999, false) ==
+        ICON_UNKNOWN && Forecast_IconFromConditionId(65535, true) == ICON_UNKNOWN, "unknown condition ids");
+  check(allocations == before, "lookups allocate nothing");
+}
+
+static void checkFormatting() {
+  size_t before = allocations;
+  ForecastSlotText text;
+  uint32_t fingerprints = 0;
+  for (int i = 0; i < 1000; i++) {
+    ForecastInfo info = {1767225600 + i * 3600, (int16_t)(i * 37 % 8000 - 3000), (uint8_t)(i % 101),
+                         (uint8_t)(i % ICON_COUNT)};
+    Forecast_FormatSlot(&text, &info, 9 * 3600, i % 2 ? 'F' : 'C', i % 3 != 0, i % 5 == 0 ? info.time - 7200 : 0);
+    fingerprints ^= Forecast_Fingerprint(&text);
+  }
+  check(fingerprints != 0 || text.iconNumber != ICON_UNKNOWN, "the columns were formatted");
+  check(allocations == before, "formatting a column allocates nothing");
+}
+
+/**
+ * Every temperature from -40 to 40 degrees, as the first hour and as a
+ * delta from the hour before
+ */
+static void checkCacheRounding() {
+  size_t before = allocations;
+  static const int16_t BOUNDARY[] = {245, 249, 250, -245, -249, -250, 5, -5, 45, -45, 50, -50};
+  for (size_t i = 0; i < sizeof(BOUNDARY) / sizeof(BOUNDARY[0]); i++) {
+    ForecastCache cache;
+    ForecastInfo info = {1767225600, BOUNDARY[i], 0, ICON_CLEAR_DAY};
+    ForecastCache_Begin(&cache, &info);
+    ForecastCache_Append(&cache, &info);
+    ForecastCache_Get(&cache, 0, &info);
+    check(Forecast_RoundTemperature(info.temperature) == Forecast_RoundTemperature(BOUNDARY[i]),
+          "a cached x.45 to x.50 degrees shows as the parsed one");
+  }
+
+  bool same = true;
+  for (int temperature = -4000; temperature <= 4000; temperature++) {
+    ForecastCache cache;
+    ForecastInfo info = {1767225600, (int16_t)temperature, 0, ICON_CLEAR_DAY};
+    ForecastCache_Begin(&cache, &info);
+    ForecastCache_Append(&cache, &info);
+    // Steps within the int8 range of the deltas
+    static const int STEPS[] = {0, 1, -1, 37, -55, 450, -1000, 1234, -1271};
+    int previous = temperature;
+    for (size_t i = 0; i < sizeof(STEPS) / sizeof(STEPS[0]) && same; i++) {
+      previous += STEPS[i];
+      ForecastInfo hour = {(int32_t)(info.time + (i + 1) * 3600), (int16_t)previous, 0, ICON_CLEAR_DAY};
+      ForecastInfo cached;
+      same = ForecastCache_Append(&cache, &hour) && ForecastCache_Get(&cache, cache.count - 1, &cached) &&
+             Forecast_RoundTemperature(cached.temperature) == Forecast_RoundTemperature(hour.temperature);
+    }
+  }
+  check(same, "every cached temperature shows as the parsed one");
+  check(allocations == before, "the forecast cache allocates nothing");
+}
+
+int main() {
+  size_t before = allocations, beforeBytes = allocatedBytes;
+  std::map<std::string, uint8_t>* old = oldMappings();
+  printf("Old std::map of icon codes: %u allocations, %u bytes\n", (unsigned)(allocations - before),
+         (unsigned)(allocatedBytes - beforeBytes));
+
+  checkLookups(*old);
+  checkFormatting();
+  checkCacheRounding();
+
+  // Time of one icon code lookup, the table against the std::map with its String key
+  static const char* const CODES[] = {"01d", "01n", "02d", "03n", "04d", "09n", "10d", "11n", "13d", "50n"};
+  const int rounds = 1000000;
+  volatile uint32_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    sink = sink + Forecast_IconFromCode(CODES[i % 10]);
+  }
+  double tableNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    sink = sink + old->find(std::string(CODES[i % 10]))->second;
+  }
+  double mapNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+  printf("Icon code lookup: table %.1f ns, std::map %.1f ns on the host\n", tableNs, mapNs);
+  delete old;
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * Compression ratio and speed of the frame snapshot codec
+ *
+ * Renders a corpus of forecast frames with the device layout
+ * (ForecastView), encodes and decodes each one with FrameCodec, and
+ * reports the encoded sizes, how many frames fit the RTC snapshot, and
+ * the time per frame. A blank frame and a noise frame show the best and
+ * worst cases. Exits with 1 if any frame does not decode to itself.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -pthread -Isrc tools/frame_codec_bench.cpp src/FrameCodec.cpp src/FrameOps.cpp \
+ *       src/EPD.cpp src/AssetCodec.cpp src/Forecast.cpp src/ForecastView.cpp src/TileRender.cpp \
+ *       src/Pipeline.cpp -o frame_codec_bench
+ *   ./frame_codec_bench [frames] [capacity]
+ *
+ * capacity is the RTC snapshot size, FRAME_SNAPSHOT_CAPACITY in main.cpp.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EPD.h"
+#include "Forecast.h"
+#include "ForecastView.h"
+#include "FrameCodec.h"
+#include "FrameOps.h"
+#include "TileRender.h"
+#include "icons_rle.h"
+#include "check.h"
+
+static const int ROW_BYTES = EPD_W / 8;
+static const int BUFFER_SIZE = ROW_BYTES * EPD_H;
+static const size_t ENCODED_CAPACITY = FRAME_CODEC_MAX_SIZE(ROW_BYTES, EPD_H);
+
+/**
+ * Renders one frame of a random forecast
+ */
+static void renderFixture(uint32_t* random, uint8_t* frame, const COMPRESSED_ASSET** icons) {
+  ForecastSlotText slots[FORECAST_VIEW_COLUMNS];
+  int32_t now = 1749681000 + (int32_t)(nextRandom(random) % (365 * 86400));
+  for (int i = 0; i < FORECAST_VIEW_COLUMNS; i++) {
+    ForecastInfo info;
+    info.time = now + i * 3 * 3600;
+    info.temperature = (int16_t)((int)(nextRandom(random) % 5000) - 1500);
+    info.pop = (uint8_t)(nextRandom(random) % 101);
+    info.iconNumber = (uint8_t)(nextRandom(random) % ICON_COUNT);
+    Forecast_FormatSlot(&slots[i], &info, 9 * 3600, 'C', i != 0, i == 0 && nextRandom(random) % 8 == 0 ? now : 0);
+  }
+  ForecastView view = {slots, FORECAST_VIEW_ALL_COLUMNS, true, icons, NULL, NULL, false, 0};
+  Paint_NewImage(frame, EPD_W, EPD_H, Rotation, WHITE);
+  TileRender_Frame(ForecastView_Draw, &view, 1, 1);
+}
+
+/**
+ * Encodes and decodes one frame
+ *
+ * @return Encoded size, or 0 if the frame did not come back unchanged
+ */
+static size_t roundTrip(const uint8_t* frame, uint8_t* encoded, uint8_t* decoded, double* encodeUs, double* decodeUs) {
+  auto start = std::chrono::steady_clock::now();
+  size_t length = FrameCodec_Encode(frame, ROW_BYTES, EPD_H, encoded, ENCODED_CAPACITY);
+  auto middle = std::chrono::steady_clock::now();
+  bool ok = length > 0 && FrameCodec_Decode(encoded, length, decoded, ROW_BYTES, EPD_H);
+  auto end = std::chrono::steady_clock::now();
+  *encodeUs += std::chrono::duration<double, std::micro>(middle - start).count();
+  *decodeUs += std::chrono::duration<double, std::micro>(end - middle).count();
+  return ok && memcmp(frame, decoded, BUFFER_SIZE) == 0 ? length : 0;
+}
+
+int main(int argc, char** argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 1000;
+  size_t capacity = argc > 2 ? (size_t)atoi(argv[2]) : 4096;
+  if (frames <= 0) {
+    frames = 1000;
+  }
+
+  const COMPRESSED_ASSET* icons[ICON_COUNT];
+  for (int i = 0; i < ICON_COUNT; i++) {
+    icons[i] = &Weather_Icons[i];
+  }
+
+  alignas(FRAMEOPS_ALIGN) static uint8_t frame[BUFFER_SIZE];
+  alignas(FRAMEOPS_ALIGN) static uint8_t decoded[BUFFER_SIZE];
+  std::vector<uint8_t> encoded(ENCODED_CAPACITY);
+  std::vector<size_t> sizes;
+  double encodeUs = 0, decodeUs = 0;
+  int fits = 0;
+
+  uint32_t random = 0x12345678;
+  for (int f = 0; f < frames; f++) {
+    renderFixture(&random, frame, icons);
+    size_t length = roundTrip(frame, encoded.data(), decoded, &encodeUs, &decodeUs);
+    if (length == 0) {
+      failures++;
+      continue;
+    }
+    sizes.push_back(length);
+    fits += length <= capacity;
+  }
+
+  // Best and worst cases
+  double unusedUs = 0;
+  memset(frame, WHITE, BUFFER_SIZE);
+  size_t blank = roundTrip(frame, encoded.data(), decoded, &unusedUs, &unusedUs);
+  for (int i = 0; i < BUFFER_SIZE; i++) {
+    frame[i] = (uint8_t)nextRandom(&random);
+  }
+  size_t noise = roundTrip(frame, encoded.data(), decoded, &unusedUs, &unusedUs);
+  failures += (blank == 0) + (noise == 0);
+
+  if (!sizes.empty()) {
+    std::sort(sizes.begin(), sizes.end());
+    double total = 0;
+    for (size_t s : sizes) {
+      total += s;
+    }
+    double mean = total / sizes.size();
+    printf("%u forecast frames of %d bytes\n", (unsigned)sizes.size(), BUFFER_SIZE);
+    printf("encoded    min %5u  median %5u  mean %7.1f  max %5u bytes\n", (unsigned)sizes.front(),
+           (unsigned)sizes[sizes.size() / 2], mean, (unsigned)sizes.back());
+    printf("ratio      mean %.1f:1, worst %.1f:1\n", BUFFER_SIZE / mean, (double)BUFFER_SIZE / sizes.back());
+    printf("RTC slot   %d of %d frames fit %u bytes\n", fits, frames, (unsigned)capacity);
+    printf("time       encode %.1f us, decode %.1f us per frame\n", encodeUs / frames, decodeUs / frames);
+  }
+  printf("blank      %u bytes\n", (unsigned)blank);
+  printf("noise      %u bytes, bound %u\n", (unsigned)noise, (unsigned)ENCODED_CAPACITY);
+
+  if (failures > 0) {
+    printf("FAILED: %d frames did not decode to themselves\n", failures);
+    return 1;
+  }
+  printf("All frames decode to themselves\n");
+  return 0;
+}
@@ -0,0 +1,231 @@
+/**
+ * Equivalence check and benchmark of the FrameOps kernels
+ *
+ * First compares every kernel against a plain byte loop over random
+ * buffers of every alignment and many lengths, then times each kernel
+ * on frame-sized buffers against the byte loop. Exits with 1 if any
+ * result differs.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/frameops_bench.cpp src/FrameOps.cpp -o frameops_bench
+ *   ./frameops_bench [iterations]
+ *
+ * Built with the ESP32-S3 toolchain and -DFRAMEOPS_USE_PIE, the same
+ * program checks and times the PIE kernels.
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FrameOps.h"
+#include "check.h"
+
+static const int ROW_BYTES = 100;  // EPD_W / 8
+static const int ROWS = 272;       // EPD_H
+static const int FRAME_BYTES = ROW_BYTES * ROWS;
+static const int MAX_LENGTH = 300;
+
+static void fillRandom(uint32_t *random, uint8_t *buffer, size_t length, bool sparse)
+{
+  for (size_t i = 0; i < length; i++) {
+    uint32_t r = nextRandom(random);
+    buffer[i] = sparse && (r & 0xF00) != 0 ? 0xFF : (uint8_t)r;  // Mostly white like a rendered frame
+  }
+}
+
+static void checkKernel(bool ok, const char *kernel, size_t offset, size_t length)
+{
+  if (!ok) {
+    printf("FAILED: %s at offset %u, length %u\n", kernel, (unsigned)offset, (unsigned)length);
+    failures++;
+  }
+}
+
+// Reference implementations
+
+static void referenceInvert(uint8_t *dst, const uint8_t *src, size_t length)
+{
+  for (size_t i = 0; i < length; i++) {
+    dst[i] = ~src[i];
+  }
+}
+
+static uint16_t referenceXorDiff(uint8_t *diff, const uint8_t *a, const uint8_t *b, int rowBytes, int rows,
+                                 uint8_t *dirtyRows)
+{
+  uint16_t dirty = 0;
+  memset(dirtyRows, 0, (rows + 7) / 8);
+  for (int r = 0; r < rows; r++) {
+    bool differs = false;
+    for (int i = 0; i < rowBytes; i++) {
+      diff[r * rowBytes + i] = a[r * rowBytes + i] ^ b[r * rowBytes + i];
+      differs |= diff[r * rowBytes + i] != 0;
+    }
+    if (differs) {
+      dirty++;
+      dirtyRows[r / 8] |= 1 << (r % 8);
+    }
+  }
+  return dirty;
+}
+
+static uint32_t referencePopcount(const uint8_t *src, size_t length)
+{
+  uint32_t count = 0;
+  for (size_t i = 0; i < length; i++) {
+    for (int bit = 0; bit < 8; bit++) {
+      count += (src[i] >> bit) & 1;
+    }
+  }
+  return count;
+}
+
+static void referenceTranspose(uint8_t *dst, const uint8_t *src, int rows, int cols, int stride)
+{
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      dst[c * rows + r] = src[r * stride + c];
+    }
+  }
+}
+
+/**
+ * Runs every kernel at every alignment of its buffers
+ */
+static void checkEquivalence()
+{
+  static uint8_t a[MAX_LENGTH + 64], b[MAX_LENGTH + 64], out[MAX_LENGTH + 64], expected[MAX_LENGTH + 64];
+  uint8_t dirty[(MAX_LENGTH + 7) / 8], expectedDirty[(MAX_LENGTH + 7) / 8];
+  uint32_t random = 0x9E3779B9;
+
+  for (size_t length = 0; length <= MAX_LENGTH; length += length < 40 ? 1 : 13) {
+    for (size_t offset = 0; offset < FRAMEOPS_ALIGN; offset++) {
+      size_t other = (offset * 7) % FRAMEOPS_ALIGN;  // Also pair buffers with different alignments
+
+      fillRandom(&random, out, sizeof(out), false);
+      memcpy(expected, out, sizeof(out));
+      FrameOps_Fill(out + offset, (uint8_t)length, length);
+      memset(expected + offset, (uint8_t)length, length);
+      checkKernel(memcmp(out, expected, sizeof(out)) == 0, "fill", offset, length);
+
+      for (int same = 0; same < 2; same++) {
+        size_t srcOffset = same ? offset : other;
+        fillRandom(&random, a, sizeof(a), false);
+        fillRandom(&random, out, sizeof(out), false);
+        memcpy(expected, out, sizeof(out));
+        FrameOps_Invert(out + offset, a + srcOffset, length);
+        referenceInvert(expected + offset, a + srcOffset, length);
+        checkKernel(memcmp(out, expected, sizeof(out)) == 0, "invert", offset, length);
+      }
+      memcpy(expected, a, sizeof(a));
+      FrameOps_Invert(a + offset, a + offset, length);
+      referenceInvert(expected + offset, expected + offset, length);
+      checkKernel(memcmp(a, expected, sizeof(a)) == 0, "invert in place", offset, length);
+
+      fillRandom(&random, a, sizeof(a), false);
+      checkKernel(FrameOps_Popcount(a + offset, length) == referencePopcount(a + offset, length), "popcount", offset,
+                  length);
+
+      // Square-ish shapes for the row diff, with some rows left identical
+      int rowBytes = length < 8 ? (int)length : (int)length / 8 + 1;
+      int rows = rowBytes > 0 ? (int)length / rowBytes : 0;
+      fillRandom(&random, a, sizeof(a), true);
+      memcpy(b, a, sizeof(a));
+      for (int r = 0; r < rows; r += 2) {
+        b[other + r * rowBytes + nextRandom(&random) % rowBytes] ^= 1 << (nextRandom(&random) % 8);
+      }
+      for (int withDiff = 0; withDiff < 2; withDiff++) {
+        uint16_t count = FrameOps_XorDiff(withDiff ? out + offset : NULL, a + other, b + other, rowBytes, rows, dirty);
+        uint16_t expectedCount = referenceXorDiff(expected + offset, a + other, b + other, rowBytes, rows, expectedDirty);
+        checkKernel(count == expectedCount && memcmp(dirty, expectedDirty, (rows + 7) / 8) == 0, "xor diff rows",
+                  offset, length);
+        if (withDiff) {
+          checkKernel(memcmp(out + offset, expected + offset, rows * rowBytes) == 0, "xor diff", offset, length);
+        }
+      }
+
+      int cols = rowBytes;
+      int stride = cols + (int)(offset % 3);
+      rows = cols > 0 ? (int)length / stride : 0;
+      FrameOps_Transpose(out, a + offset, rows, cols, stride);
+      referenceTranspose(expected, a + offset, rows, cols, stride);
+      checkKernel(memcmp(out, expected, rows * cols) == 0, "transpose", offset, length);
+    }
+  }
+}
+
+/**
+ * Prints the time of one kernel and of its byte loop
+ */
+template <typename Kernel, typename Reference>
+static void bench(const char *name, int iterations, Kernel kernel, Reference reference)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    kernel();
+  }
+  double kernelUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    reference();
+  }
+  double referenceUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  printf("%-10s %9.2f us/frame   byte loop %9.2f us/frame   %5.1fx\n", name, kernelUs / iterations,
+         referenceUs / iterations, referenceUs / kernelUs);
+}
+
+int main(int argc, char **argv)
+{
+  int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+  if (iterations <= 0) {
+    iterations = 2000;
+  }
+
+  printf("FrameOps kernels: %s\n", FrameOps_Name());
+  checkEquivalence();
+  if (failures > 0) {
+    printf("%d mismatches against the byte loops\n", failures);
+    return 1;
+  }
+  printf("All kernels match the byte loops\n");
+
+  alignas(FRAMEOPS_ALIGN) static uint8_t a[FRAME_BYTES], b[FRAME_BYTES], out[FRAME_BYTES];
+  uint8_t dirty[(ROWS + 7) / 8];
+  volatile uint32_t sink = 0;  // Keeps results alive
+  uint32_t random = 0x12345678;
+  fillRandom(&random, a, FRAME_BYTES, true);
+  memcpy(b, a, FRAME_BYTES);
+  for (int r = 0; r < ROWS; r += 5) {
+    b[r * ROW_BYTES + r % ROW_BYTES] ^= 0x10;
+  }
+
+  // Inputs change between iterations through out, so the calls cannot be hoisted
+  bench("fill", iterations,
+        [&] { FrameOps_Fill(out, (uint8_t)sink, FRAME_BYTES); sink += out[sink % FRAME_BYTES]; },
+        [&] { for (int i = 0; i < FRAME_BYTES; i++) ((volatile uint8_t *)out)[i] = (uint8_t)sink; sink += out[0]; });
+  bench("invert", iterations,
+        [&] { FrameOps_Invert(out, out, FRAME_BYTES); sink += out[0]; },
+        [&] { for (int i = 0; i < FRAME_BYTES; i++) ((volatile uint8_t *)out)[i] = ~out[i]; sink += out[0]; });
+  bench("xor diff", iterations,
+        [&] { sink += FrameOps_XorDiff(out, a, b, ROW_BYTES, ROWS, dirty); },
+        [&] {
+          uint16_t count = 0;
+          for (int r = 0; r < ROWS; r++) {
+            uint8_t any = 0;
+            for (int i = 0; i < ROW_BYTES; i++) {
+              ((volatile uint8_t *)out)[r * ROW_BYTES + i] = a[r * ROW_BYTES + i] ^ b[r * ROW_BYTES + i];
+              any |= out[r * ROW_BYTES + i];
+            }
+            count += any != 0;
+          }
+          sink += count;
+        });
+  bench("popcount", iterations,
+        [&] { sink += FrameOps_Popcount(a, FRAME_BYTES); a[sink % FRAME_BYTES] ^= 1; },
+        [&] { sink += referencePopcount(a, FRAME_BYTES); a[sink % FRAME_BYTES] ^= 1; });
+  bench("transpose", iterations,
+        [&] { FrameOps_Transpose(out, a, ROWS, ROW_BYTES / 2, ROW_BYTES); sink += out[sink % FRAME_BYTES]; },
+        [&] { referenceTranspose(out, a, ROWS, ROW_BYTES / 2, ROW_BYTES); sink += out[sink % FRAME_BYTES]; });
+  return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * Decode throughput of the compressed weather icons
+ *
+ * Decodes every icon of icons_rle.h row by row with AssetCodec and
+ * compares the rows with the uncompressed bitmaps of icons.h, also when
+ * decoding starts at a restart point or skips rows. Then draws each icon
+ * into a frame with EPD_ShowCompressedPicture and with EPD_ShowPicture
+ * from the uncompressed bitmap, at byte-aligned and unaligned columns and
+ * across the gap between the driver ICs, and checks that both frames are
+ * the same. Reports the decode throughput and the time per icon drawn
+ * both ways. Exits with 1 if any row or frame differs.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/icon_decode_bench.cpp src/EPD.cpp src/AssetCodec.cpp src/FrameOps.cpp \
+ *       -o icon_decode_bench
+ *   ./icon_decode_bench [iterations]
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "EPD.h"
+#include "icons.h"
+#include "icons_rle.h"
+#include "check.h"
+
+static const int ICONS = sizeof(Weather_Icons) / sizeof(Weather_Icons[0]);
+static const int BUFFER_SIZE = EPD_W / 8 * EPD_H;
+
+// Icon positions: byte-aligned, unaligned, and across the gap at column 396
+static const uint16_t POSITIONS[][2] = {{0, 0}, {8, 72}, {3, 10}, {330, 100}, {389, 40}, {460, 144}, {671, 5}};
+static const int POSITION_COUNT = sizeof(POSITIONS) / sizeof(POSITIONS[0]);
+
+/**
+ * Compares the decoded rows of every icon with icons.h
+ */
+static void checkRows() {
+  uint8_t row[EPD_W / 8];
+  for (int i = 0; i < ICONS; i++) {
+    const COMPRESSED_ASSET* asset = &Weather_Icons[i];
+    uint16_t rowBytes = Asset_RowBytes(asset);
+    check((size_t)rowBytes * asset->height == sizeof(Weather_Num[i]), "an icon has the size of its bitmap");
+
+    // From the start, from every restart point, and from rows between them
+    for (uint16_t first = 0; first < asset->height; first += ASSET_RESTART_INTERVAL / 2) {
+      ASSET_DECODER dec;
+      Asset_DecoderInit(&dec, asset, first);
+      uint16_t y = first;
+      bool same = true;
+      while (Asset_DecodeRow(&dec, row)) {
+        same = same && y < asset->height && memcmp(row, Weather_Num[i] + y * rowBytes, rowBytes) == 0;
+        y++;
+      }
+      check(same && y == asset->height, "the rows decode to the bitmap");
+    }
+
+    // Every other row skipped
+    ASSET_DECODER dec;
+    Asset_DecoderInit(&dec, asset, 0);
+    bool same = true;
+    for (uint16_t y = 0; y < asset->height; y += 2) {
+      same = same && Asset_DecodeRow(&dec, row) && memcmp(row, Weather_Num[i] + y * rowBytes, rowBytes) == 0;
+      same = same && (y + 1 >= asset->height || Asset_SkipRow(&dec));
+    }
+    check(same && !Asset_DecodeRow(&dec, row), "skipped rows keep the decoder in step");
+  }
+}
+
+/**
+ * Draws every icon at every position both ways and compares the frames
+ */
+static void checkFrames(uint8_t* compressed, uint8_t* uncompressed) {
+  for (int i = 0; i < ICONS; i++) {
+    const COMPRESSED_ASSET* asset = &Weather_Icons[i];
+    for (int p = 0; p < POSITION_COUNT; p++) {
+      Paint_NewImage(compressed, EPD_W, EPD_H, Rotation, WHITE);
+      Paint_Clear(WHITE);
+      EPD_ShowCompressedPicture(POSITIONS[p][0], POSITIONS[p][1], asset, BLACK);
+      Paint_NewImage(uncompressed, EPD_W, EPD_H, Rotation, WHITE);
+      Paint_Clear(WHITE);
+      EPD_ShowPicture(POSITIONS[p][0], POSITIONS[p][1], asset->width, asset->height, Weather_Num[i], BLACK);
+      check(memcmp(compressed, uncompressed, BUFFER_SIZE) == 0, "a compressed icon draws as the bitmap");
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+  if (iterations <= 0) {
+    iterations = 2000;
+  }
+
+  static uint8_t compressed[BUFFER_SIZE];
+  static uint8_t uncompressed[BUFFER_SIZE];
+  checkRows();
+  checkFrames(compressed, uncompressed);
+
+  // Decode alone
+  uint8_t row[EPD_W / 8];
+  size_t compressedBytes = 0, decodedBytes = 0;
+  volatile uint8_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int n = 0; n < iterations; n++) {
+    for (int i = 0; i < ICONS; i++) {
+      ASSET_DECODER dec;
+      Asset_DecoderInit(&dec, &Weather_Icons[i], 0);
+      while (Asset_DecodeRow(&dec, row)) {
+        sink = sink ^ row[0];
+      }
+    }
+  }
+  double decodeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  for (int i = 0; i < ICONS; i++) {
+    compressedBytes += Weather_Icons[i].dataSize;
+    decodedBytes += sizeof(Weather_Num[i]);
+  }
+
+  // Drawn into the frame, at an unaligned column
+  Paint_NewImage(compressed, EPD_W, EPD_H, Rotation, WHITE);
+  start = std::chrono::steady_clock::now();
+  for (int n = 0; n < iterations; n++) {
+    for (int i = 0; i < ICONS; i++) {
+      EPD_ShowCompressedPicture(3 + i * 8, 10, &Weather_Icons[i], BLACK);
+    }
+  }
+  double compressedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  Paint_NewImage(uncompressed, EPD_W, EPD_H, Rotation, WHITE);
+  start = std::chrono::steady_clock::now();
+  for (int n = 0; n < iterations; n++) {
+    for (int i = 0; i < ICONS; i++) {
+      EPD_ShowPicture(3 + i * 8, 10, Weather_Icons[i].width, Weather_Icons[i].height, Weather_Num[i], BLACK);
+    }
+  }
+  double uncompressedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  check(memcmp(compressed, uncompressed, BUFFER_SIZE) == 0, "the timed frames are the same");
+
+  int drawn = iterations * ICONS;
+  printf("%d icons, %u bytes of compressed stream, %u bytes decoded (%.2f:1)\n", ICONS, (unsigned)compressedBytes,
+         (unsigned)decodedBytes, (double)decodedBytes / compressedBytes);
+  printf("decode     %.2f us per icon, %.0f MB/s decoded on the host\n", decodeUs / drawn,
+         decodedBytes * (double)iterations / decodeUs);
+  printf("draw       compressed %.2f us, uncompressed %.2f us per icon on the host\n", compressedUs / drawn,
+         uncompressedUs / drawn);
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
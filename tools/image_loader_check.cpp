@@ -0,0 +1,292 @@
+/**
+ * Checks the image loader on the host against EPD_ShowPicture
+ *
+ * Builds fixture images in memory from random bitmaps: PBM (P4) with and
+ * without header comments, 1-bpp BMP bottom-up and top-down, with either
+ * palette order and with a larger (BITMAPV5) header, and 8-bit PGM (P5)
+ * of pure black and white under both dither modes. Each is drawn with
+ * Image_Load into a cleared frame, at offsets on either side of the gap
+ * between the driver ICs and in both colors, and must match the frame
+ * EPD_ShowPicture draws from the same bitmap byte for byte. Then feeds
+ * malformed and truncated headers, which must be rejected without
+ * reading past the header, and times a full-screen PBM. Exits with 1 on
+ * a failure.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/image_loader_check.cpp src/ImageLoader.cpp src/Dither.cpp src/EPD.cpp \
+ *       src/AssetCodec.cpp src/FrameOps.cpp -o image_loader_check
+ *   ./image_loader_check
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "EPD.h"
+#include "ImageLoader.h"
+#include "check.h"
+
+static const int BUFFER_SIZE = EPD_W / 8 * EPD_H;
+
+static uint8_t expected[BUFFER_SIZE];
+static uint8_t actual[BUFFER_SIZE];
+
+struct MemoryReader {
+  const std::vector<uint8_t>* data;
+  size_t position;
+};
+
+static size_t readMemory(void* context, uint8_t* buffer, size_t length) {
+  MemoryReader* reader = (MemoryReader*)context;
+  size_t left = reader->data->size() - reader->position;
+  if (length > left) {
+    length = left;
+  }
+  memcpy(buffer, reader->data->data() + reader->position, length);
+  reader->position += length;
+  return length;
+}
+
+/**
+ * Bitmap in the EPD_ShowPicture format: rows MSB first, 1 = dark
+ */
+struct Bitmap {
+  uint16_t width;
+  uint16_t height;
+  std::vector<uint8_t> bits;
+
+  int rowBytes() const { return (width + 7) / 8; }
+  bool dark(int x, int y) const { return bits[y * rowBytes() + x / 8] & (0x80 >> (x % 8)); }
+};
+
+static Bitmap randomBitmap(uint16_t width, uint16_t height, uint32_t* random) {
+  Bitmap bitmap = {width, height, std::vector<uint8_t>((width + 7) / 8 * height)};
+  for (size_t i = 0; i < bitmap.bits.size(); i++) {
+    bitmap.bits[i] = (uint8_t)nextRandom(random);
+  }
+  // Padding bits past the width are not part of the image
+  if (width % 8 != 0) {
+    for (int y = 0; y < height; y++) {
+      bitmap.bits[y * bitmap.rowBytes() + bitmap.rowBytes() - 1] &= (uint8_t)(0xFF00 >> (width % 8));
+    }
+  }
+  return bitmap;
+}
+
+static void put16(std::vector<uint8_t>& out, uint32_t value) {
+  out.push_back(value & 0xFF);
+  out.push_back((value >> 8) & 0xFF);
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t value) {
+  put16(out, value & 0xFFFF);
+  put16(out, value >> 16);
+}
+
+static std::vector<uint8_t> pbm(const Bitmap& bitmap, bool comments) {
+  std::string header = comments ? "P4\n# fixture\n" + std::to_string(bitmap.width) + " # width\n" +
+                                      std::to_string(bitmap.height) + "\n"
+                                : "P4 " + std::to_string(bitmap.width) + " " + std::to_string(bitmap.height) + "\n";
+  std::vector<uint8_t> out(header.begin(), header.end());
+  out.insert(out.end(), bitmap.bits.begin(), bitmap.bits.end());
+  return out;
+}
+
+static std::vector<uint8_t> pgm(const Bitmap& bitmap, uint32_t maxval) {
+  std::string header = "P5\n" + std::to_string(bitmap.width) + " " + std::to_string(bitmap.height) + "\n" +
+                       std::to_string(maxval) + "\n";
+  std::vector<uint8_t> out(header.begin(), header.end());
+  for (int y = 0; y < bitmap.height; y++) {
+    for (int x = 0; x < bitmap.width; x++) {
+      out.push_back(bitmap.dark(x, y) ? 0 : maxval);
+    }
+  }
+  return out;
+}
+
+/**
+ * 1-bpp BMP
+ *
+ * @param darkFirst Palette color 0 is black, so set bits are light
+ * @param dibSize 40 for BITMAPINFOHEADER, 124 for BITMAPV5HEADER
+ */
+static std::vector<uint8_t> bmp(const Bitmap& bitmap, bool bottomUp, bool darkFirst, uint32_t dibSize) {
+  int stride = (bitmap.rowBytes() + 3) / 4 * 4;
+  uint32_t dataOffset = 14 + dibSize + 8;
+  std::vector<uint8_t> out = {'B', 'M'};
+  put32(out, dataOffset + stride * bitmap.height);
+  put32(out, 0);
+  put32(out, dataOffset);
+  put32(out, dibSize);
+  put32(out, bitmap.width);
+  put32(out, bottomUp ? bitmap.height : -(int32_t)bitmap.height);
+  put16(out, 1);
+  put16(out, 1);
+  put32(out, 0);
+  put32(out, stride * bitmap.height);
+  put32(out, 2835);
+  put32(out, 2835);
+  put32(out, 2);
+  put32(out, 2);
+  out.resize(14 + dibSize, 0);
+  uint32_t dark = 0x000000, light = 0xFFFFFF;
+  put32(out, darkFirst ? dark : light);
+  put32(out, darkFirst ? light : dark);
+  for (int r = 0; r < bitmap.height; r++) {
+    int y = bottomUp ? bitmap.height - 1 - r : r;
+    for (int i = 0; i < stride; i++) {
+      uint8_t byte = i < bitmap.rowBytes() ? bitmap.bits[y * bitmap.rowBytes() + i] : 0;
+      out.push_back(darkFirst ? (uint8_t)~byte : byte);
+    }
+  }
+  return out;
+}
+
+/**
+ * Draws the image at (x, y) and compares with EPD_ShowPicture of the bitmap
+ */
+static void checkImage(const std::vector<uint8_t>& image, const Bitmap& bitmap, uint16_t x, uint16_t y, uint16_t color,
+                       const char* what) {
+  Paint_NewImage(expected, EPD_W, EPD_H, Rotation, WHITE);
+  Paint_Clear(WHITE);
+  EPD_ShowPicture(x, y, bitmap.width, bitmap.height, bitmap.bits.data(), color);
+
+  Paint_NewImage(actual, EPD_W, EPD_H, Rotation, WHITE);
+  Paint_Clear(WHITE);
+  MemoryReader source = {&image, 0};
+  IMAGE_READER reader = {&source, readMemory};
+  IMAGE_INFO info = {0, 0};
+  bool loaded = Image_Load(&reader, x, y, color, &info);
+
+  check(loaded, what);
+  check(info.width == bitmap.width && info.height == bitmap.height, what);
+  check(memcmp(expected, actual, BUFFER_SIZE) == 0, what);
+}
+
+/**
+ * Loads an image that must be rejected
+ *
+ * @param maxRead Bytes the loader may read before giving up
+ */
+static void checkRejected(const std::vector<uint8_t>& image, size_t maxRead, const char* what) {
+  Paint_NewImage(actual, EPD_W, EPD_H, Rotation, WHITE);
+  MemoryReader source = {&image, 0};
+  IMAGE_READER reader = {&source, readMemory};
+  check(!Image_Load(&reader, 0, 0, BLACK, NULL), what);
+  check(source.position <= maxRead, what);
+}
+
+static void checkFixtures() {
+  static const uint16_t SIZES[][2] = {{1, 1}, {8, 3}, {37, 29}, {100, 48}, {396, 10}, {IMAGE_MAX_WIDTH, 16}};
+  static const uint16_t OFFSETS[][2] = {{0, 0}, {3, 7}, {390, 100}, {400, 250}};
+  static const uint16_t COLORS[] = {BLACK, WHITE};
+  uint32_t random = 0x9E3779B9;
+
+  for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+    Bitmap bitmap = randomBitmap(SIZES[s][0], SIZES[s][1], &random);
+    for (size_t o = 0; o < sizeof(OFFSETS) / sizeof(OFFSETS[0]); o++) {
+      uint16_t x = OFFSETS[o][0], y = OFFSETS[o][1];
+      for (size_t c = 0; c < sizeof(COLORS) / sizeof(COLORS[0]); c++) {
+        uint16_t color = COLORS[c];
+        checkImage(pbm(bitmap, false), bitmap, x, y, color, "a PBM matches EPD_ShowPicture");
+        checkImage(pbm(bitmap, true), bitmap, x, y, color, "a PBM with comments matches EPD_ShowPicture");
+        checkImage(bmp(bitmap, true, false, 40), bitmap, x, y, color, "a bottom-up BMP matches EPD_ShowPicture");
+        checkImage(bmp(bitmap, false, false, 40), bitmap, x, y, color, "a top-down BMP matches EPD_ShowPicture");
+        checkImage(bmp(bitmap, true, true, 40), bitmap, x, y, color,
+                   "a BMP with black as color 0 matches EPD_ShowPicture");
+        checkImage(bmp(bitmap, false, true, 124), bitmap, x, y, color,
+                   "a BMP with a V5 header matches EPD_ShowPicture");
+      }
+
+      // Grayscale is always drawn dark on light
+      Image_SetDitherMode(DITHER_FLOYD_STEINBERG);
+      checkImage(pgm(bitmap, 255), bitmap, x, y, WHITE, "a black and white PGM matches after error diffusion");
+      checkImage(pgm(bitmap, 15), bitmap, x, y, WHITE, "a PGM with maxval 15 is rescaled");
+      Image_SetDitherMode(DITHER_ORDERED);
+      checkImage(pgm(bitmap, 255), bitmap, x, y, WHITE, "a black and white PGM matches after ordered dithering");
+    }
+  }
+  Image_SetDitherMode(DITHER_FLOYD_STEINBERG);
+}
+
+static void setBmp32(std::vector<uint8_t>& image, size_t offset, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    image[offset + i] = (value >> (i * 8)) & 0xFF;
+  }
+}
+
+static void checkMalformed() {
+  uint32_t random = 0x1234567;
+  Bitmap bitmap = randomBitmap(64, 16, &random);
+  const std::vector<uint8_t> good = bmp(bitmap, true, false, 40);
+  const size_t headers = 14 + 40;
+
+  std::vector<uint8_t> image = good;
+  setBmp32(image, 14, 0xFFFFFFF0);
+  checkRejected(image, headers, "a DIB size near 4 GB is rejected from the header");
+
+  image = good;
+  setBmp32(image, 14, 0xFFFFFFE9);  // dibSize - 40 + 8 + 54 wraps to 0
+  setBmp32(image, 10, 62);
+  checkRejected(image, headers, "a DIB size that wraps the offset arithmetic is rejected");
+
+  image = good;
+  setBmp32(image, 10, 20);
+  checkRejected(image, headers, "pixel data inside the headers is rejected");
+
+  image = good;
+  setBmp32(image, 22, 0x80000000);
+  checkRejected(image, headers, "the most negative height is rejected");
+
+  image = good;
+  setBmp32(image, 18, IMAGE_MAX_WIDTH + 1);
+  checkRejected(image, headers, "a BMP wider than IMAGE_MAX_WIDTH is rejected");
+
+  image = good;
+  image[28] = 8;
+  checkRejected(image, headers, "a BMP of another depth is rejected");
+
+  image = good;
+  image.resize(image.size() - 1);
+  checkRejected(image, image.size(), "a truncated BMP fails");
+
+  Bitmap wide = randomBitmap(IMAGE_MAX_WIDTH, 1, &random);
+  image = pgm(wide, 255);
+  image[3] = '9';  // Width 900
+  checkRejected(image, 16, "a PGM wider than IMAGE_MAX_WIDTH is rejected");
+
+  std::string text = "P4 99999999 1\n";
+  checkRejected(std::vector<uint8_t>(text.begin(), text.end()), text.size(), "an oversized PBM number is rejected");
+  text = "P5 8 8 256\n";
+  checkRejected(std::vector<uint8_t>(text.begin(), text.end()), text.size(), "a 16-bit PGM is rejected");
+  text = "GIF89a";
+  checkRejected(std::vector<uint8_t>(text.begin(), text.end()), 2, "an unknown format is rejected");
+}
+
+int main() {
+  checkFixtures();
+  checkMalformed();
+
+  // Time of a full-screen PBM
+  uint32_t random = 0xC0FFEE;
+  Bitmap screen = randomBitmap(EPD_W, EPD_H, &random);
+  std::vector<uint8_t> image = pbm(screen, false);
+  Paint_NewImage(actual, EPD_W, EPD_H, Rotation, WHITE);
+  const int rounds = 200;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    MemoryReader source = {&image, 0};
+    IMAGE_READER reader = {&source, readMemory};
+    Image_Load(&reader, 0, 0, BLACK, NULL);
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+  printf("Full-screen PBM (%ux%u) loaded in %.1f us on the host\n", (unsigned)EPD_W, (unsigned)EPD_H, us);
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
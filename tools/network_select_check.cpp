@@ -0,0 +1,267 @@
+/**
+ * Checks the Wi-Fi network selection on the host
+ *
+ * Drives Network_Rank and Network_Connect with a scripted NETWORK_DRIVER
+ * standing in for the radio: a set of access points that can be visible
+ * or hidden, up or down, and moved to another channel. Each scenario runs
+ * one or more wakes against the same RTC state and checks the ranking and
+ * the order of the radio operations (direct joins, scans, searching
+ * joins), and that the radio time of a wake stays within the deadlines,
+ * also when every access point is down. Prints the operations of every
+ * wake and exits with 1 on a failure.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/network_select_check.cpp src/NetworkSelect.cpp -o network_select_check
+ *   ./network_select_check
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "NetworkSelect.h"
+#include "check.h"
+
+static const uint32_t DIRECT_TIMEOUT_MS = 3000;
+static const uint32_t SEARCH_TIMEOUT_MS = 10000;
+static const uint32_t TOTAL_TIMEOUT_MS = 20000;
+static const uint32_t SCAN_MS = 2500;         // Active scan of every channel
+static const uint32_t JOIN_MS = 1000;         // Successful join
+
+struct AccessPoint {
+  const char* ssid;
+  uint8_t bssid[6];
+  uint8_t channel;
+  int8_t rssi;
+  bool hidden;                      // Joins only by SSID search, never in a scan
+  bool up;
+};
+
+/**
+ * Scripted radio: joins succeed when an access point of the SSID is up
+ * and, for a direct join, has the requested BSSID and channel
+ */
+struct FakeRadio {
+  std::vector<AccessPoint> aps;
+  std::vector<int> scanned;         // Indexes into aps of the last scan
+  const AccessPoint* joined;
+  std::string log;                  // Operations of the wake, e.g. "D:home S:cafe scan"
+  uint32_t elapsedMs;               // Radio time of the wake: scans, joins, and the deadlines of failed joins
+  uint32_t searchMs;                // Part of it in searching joins
+};
+
+static bool fakeConnect(void* context, const NETWORK_CREDENTIAL* credential, const uint8_t* bssid, uint8_t channel,
+                        uint32_t timeoutMs) {
+  FakeRadio* radio = (FakeRadio*)context;
+  radio->log += std::string(bssid != NULL ? " D:" : " S:") + credential->ssid;
+  const AccessPoint* best = NULL;
+  for (const AccessPoint& ap : radio->aps) {
+    if (!ap.up || strcmp(ap.ssid, credential->ssid) != 0) {
+      continue;
+    }
+    if (bssid != NULL && (memcmp(ap.bssid, bssid, 6) != 0 || ap.channel != channel)) {
+      continue;
+    }
+    if (best == NULL || ap.rssi > best->rssi) {
+      best = &ap;
+    }
+  }
+  radio->joined = best;
+  uint32_t spent = best != NULL ? (JOIN_MS < timeoutMs ? JOIN_MS : timeoutMs) : timeoutMs;
+  radio->elapsedMs += spent;
+  radio->searchMs += bssid == NULL ? spent : 0;
+  return best != NULL;
+}
+
+static int fakeScan(void* context) {
+  FakeRadio* radio = (FakeRadio*)context;
+  radio->log += " scan";
+  radio->elapsedMs += SCAN_MS;
+  radio->scanned.clear();
+  for (size_t i = 0; i < radio->aps.size(); i++) {
+    if (radio->aps[i].up && !radio->aps[i].hidden) {
+      radio->scanned.push_back((int)i);
+    }
+  }
+  return (int)radio->scanned.size();
+}
+
+static bool fakeScanResult(void* context, int index, NETWORK_SCAN_RESULT* result) {
+  FakeRadio* radio = (FakeRadio*)context;
+  const AccessPoint& ap = radio->aps[radio->scanned[index]];
+  result->ssidHash = Network_HashSsid(ap.ssid);
+  result->rssi = ap.rssi;
+  result->channel = ap.channel;
+  memcpy(result->bssid, ap.bssid, 6);
+  return true;
+}
+
+static void fakeStatus(void* context, int8_t* rssi, uint8_t* bssid, uint8_t* channel) {
+  FakeRadio* radio = (FakeRadio*)context;
+  *rssi = radio->joined->rssi;
+  memcpy(bssid, radio->joined->bssid, 6);
+  *channel = radio->joined->channel;
+}
+
+static uint32_t fakeMillis(void* context) {
+  return ((FakeRadio*)context)->elapsedMs;
+}
+
+static NETWORK_CREDENTIAL credential(const char* ssid) {
+  NETWORK_CREDENTIAL result;
+  memset(&result, 0, sizeof(result));
+  strncpy(result.ssid, ssid, NETWORK_SSID_SIZE - 1);
+  strncpy(result.password, "password", NETWORK_PASSWORD_SIZE - 1);
+  return result;
+}
+
+/**
+ * One wake: connects and returns the SSID joined, or "" when offline
+ */
+static std::string wake(NETWORK_STATE* state, FakeRadio* radio, const std::vector<NETWORK_CREDENTIAL>& credentials) {
+  NETWORK_DRIVER driver = {radio, fakeConnect, fakeScan, fakeScanResult, fakeStatus, fakeMillis};
+  radio->log.clear();
+  radio->elapsedMs = 0;
+  radio->searchMs = 0;
+  int index = Network_Connect(state, credentials.data(), (int)credentials.size(), &driver, DIRECT_TIMEOUT_MS,
+                              SEARCH_TIMEOUT_MS, TOTAL_TIMEOUT_MS);
+  std::string joined = index >= 0 ? credentials[index].ssid : "";
+  printf("  %-40s -> %-8s %5u ms\n", radio->log.c_str() + 1, index >= 0 ? joined.c_str() : "offline",
+         (unsigned)radio->elapsedMs);
+  check(radio->elapsedMs <= TOTAL_TIMEOUT_MS + SCAN_MS, "a wake ends by the deadline, or the scan running at it");
+  check(radio->searchMs <= SEARCH_TIMEOUT_MS, "the searching joins share one deadline");
+  return joined;
+}
+
+static void checkRanking() {
+  printf("ranking\n");
+  std::vector<NETWORK_CREDENTIAL> credentials = {credential("home"), credential("office"), credential("phone")};
+  NETWORK_STATE state;
+  memset(&state, 0, sizeof(state));
+  Network_InitState(&state);
+  NETWORK_CANDIDATE candidates[NETWORK_MAX_CREDENTIALS];
+  check(Network_Rank(&state, credentials.data(), 3, candidates) == 0, "nothing is ranked without scan or history");
+
+  // Scan: office strongest, then home; phone unseen
+  state.scanCount = 2;
+  state.scan[0] = {Network_HashSsid("office"), -50, 6, {2, 0, 0, 0, 0, 1}};
+  state.scan[1] = {Network_HashSsid("home"), -60, 1, {1, 0, 0, 0, 0, 1}};
+  int found = Network_Rank(&state, credentials.data(), 3, candidates);
+  check(found == 2 && candidates[0].credential == 1 && candidates[1].credential == 0, "scanned networks rank by signal");
+
+  // History: phone connected before at -40, ranked below the scan after the unseen penalty
+  state.history[0] = {Network_HashSsid("phone"), -40, 0, 11, {3, 0, 0, 0, 0, 1}, 0};
+  found = Network_Rank(&state, credentials.data(), 3, candidates);
+  check(found == 3 && candidates[0].credential == 1 && candidates[1].credential == 0 && candidates[2].credential == 2,
+        "a network missing from the scan ranks by its history, lowered");
+
+  // Failures: office failed twice, drops below home
+  state.history[1] = {Network_HashSsid("office"), -50, 2, 6, {2, 0, 0, 0, 0, 1}, 0};
+  found = Network_Rank(&state, credentials.data(), 3, candidates);
+  check(candidates[0].credential == 0, "consecutive failures lower a network");
+}
+
+static void checkFallbacks() {
+  std::vector<NETWORK_CREDENTIAL> credentials = {credential("home"), credential("phone")};
+  NETWORK_STATE state;
+  memset(&state, 0, sizeof(state));
+  FakeRadio radio;
+  radio.aps = {
+    {"home", {1, 0, 0, 0, 0, 1}, 1, -60, false, true},
+    {"phone", {3, 0, 0, 0, 0, 1}, 11, -45, true, true}
+  };
+
+  printf("first wake, no state\n");
+  check(wake(&state, &radio, credentials) == "home", "the first wake joins the scanned network");
+  check(radio.log == " scan D:home", "the first wake scans, then joins directly");
+
+  printf("second wake\n");
+  check(wake(&state, &radio, credentials) == "home", "the next wake joins the cached access point");
+  check(radio.log == " D:home", "the next wake joins without scanning");
+
+  printf("home moved to channel 6\n");
+  radio.aps[0].channel = 6;
+  check(wake(&state, &radio, credentials) == "home", "a network that moved is found by the scan");
+  check(radio.log == " D:home scan D:home", "the direct join, the scan, then a direct join to the new channel");
+
+  printf("home down, only the hidden phone is up\n");
+  radio.aps[0].up = false;
+  check(wake(&state, &radio, credentials) == "phone", "a hidden network never joined is searched for");
+  check(radio.log == " D:home scan S:phone", "a network joined before and missing from the scan is not searched for");
+
+  printf("the hidden phone moved to channel 1\n");
+  radio.aps[1].channel = 1;
+  check(wake(&state, &radio, credentials) == "phone", "a network last joined while hidden is searched for");
+  check(radio.log == " D:phone D:home scan S:phone", "the direct joins, the scan, then the search");
+
+  printf("everything down\n");
+  radio.aps[1].up = false;
+  check(wake(&state, &radio, credentials) == "", "no network joins when every access point is down");
+  check(radio.log == " D:phone D:home scan S:phone", "only the hidden network is searched for");
+
+  printf("home back on its new channel\n");
+  radio.aps[0].up = true;
+  check(wake(&state, &radio, credentials) == "home", "the device comes back online");
+  check(wake(&state, &radio, credentials) == "home" && radio.log == " D:home",
+        "the new access point is cached for direct joins");
+}
+
+/**
+ * Every access point down: the radio time of a wake, with networks
+ * joined before and with networks never joined
+ */
+static void checkAllDown() {
+  std::vector<NETWORK_CREDENTIAL> credentials = {credential("home"), credential("office"), credential("cafe")};
+  NETWORK_STATE state;
+  memset(&state, 0, sizeof(state));
+  FakeRadio radio;
+  radio.aps = {
+    {"home", {1, 0, 0, 0, 0, 1}, 1, -60, false, true},
+    {"office", {2, 0, 0, 0, 0, 1}, 6, -55, false, true},
+    {"cafe", {4, 0, 0, 0, 0, 1}, 11, -70, false, true}
+  };
+
+  printf("three visible networks, each joined once\n");
+  for (size_t i = 0; i < radio.aps.size(); i++) {
+    for (size_t j = 0; j < radio.aps.size(); j++) {
+      radio.aps[j].up = i == j;
+    }
+    wake(&state, &radio, credentials);
+  }
+
+  printf("all three down, on every retry\n");
+  for (AccessPoint& ap : radio.aps) {
+    ap.up = false;
+  }
+  for (int retry = 0; retry < 3; retry++) {
+    check(wake(&state, &radio, credentials) == "", "no network joins when every access point is down");
+    check(radio.searchMs == 0, "networks joined before and missing from the scan are not searched for");
+    check(radio.elapsedMs <= 2 * NETWORK_MAX_CANDIDATES * DIRECT_TIMEOUT_MS + SCAN_MS,
+          "a wake with every known network down costs the direct joins and one scan");
+  }
+
+  printf("eight networks never joined, all down\n");
+  std::vector<NETWORK_CREDENTIAL> unknown;
+  for (int i = 0; i < NETWORK_MAX_CREDENTIALS; i++) {
+    char ssid[8];
+    snprintf(ssid, sizeof(ssid), "net%d", i);
+    unknown.push_back(credential(ssid));
+  }
+  NETWORK_STATE fresh;
+  memset(&fresh, 0, sizeof(fresh));
+  check(wake(&fresh, &radio, unknown) == "", "no network joins");
+  check(radio.elapsedMs <= SCAN_MS + SEARCH_TIMEOUT_MS, "networks never joined share the search deadline");
+}
+
+int main() {
+  checkRanking();
+  checkFallbacks();
+  checkAllDown();
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
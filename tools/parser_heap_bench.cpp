@@ -0,0 +1,382 @@
+/**
+ * Host benchmark of the heap used to parse a One Call response
+ *
+ * Parses the same response two ways and reports the peak memory of each:
+ *
+ * - String: the way the firmware parsed before the parse stage. The body
+ *   is held as a String, copied into the global jsonBuffer, and
+ *   deserialized in full, every field of every entry included.
+ * - Stream: the parse stage. The body passes through the chunk queue, and
+ *   each "current" or "hourly" entry is deserialized on its own with the entry
+ *   filter into the arena, which is rewound after the entry is read.
+ *
+ * Both read dt, temp, pop and the first weather id and icon of every
+ * entry, which must agree. The responses are TEST_WEATHER_DATA, the one
+ * the firmware shows in test mode, and a synthetic 48-hour one with every
+ * field OpenWeatherMap sends; a saved response given as the first
+ * argument (e.g. curl output of the request URL) replaces the synthetic
+ * one. Then checks that the stream peak does not grow with the number of
+ * hourly entries. Exits with 1 on a failure.
+ *
+ * ArduinoJson comes from the PlatformIO library folder, filled by the
+ * first "pio run".
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc -Itest -I.pio/libdeps/esp32-s3-devkitc-1/ArduinoJson/src \
+ *       tools/parser_heap_bench.cpp src/Arena.cpp -o parser_heap_bench
+ *   ./parser_heap_bench [response.json]
+ */
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <ArduinoJson.h>
+#include "Arena.h"
+#include "ArenaAllocator.h"
+#include "Pipeline.h"
+#include "testdata.h"
+#include "check.h"
+
+static const size_t CHUNK_QUEUE_DEPTH = 4;  // As in main.cpp
+static const size_t ARENA_SIZE = 256 * 1024;
+
+static uint8_t arenaBuffer[ARENA_SIZE];
+
+/**
+ * Heap allocator that tracks the bytes in use and their peak
+ */
+class CountingAllocator : public ArduinoJson::Allocator {
+ public:
+  CountingAllocator() : current(0), peak(0) {}
+
+  void* allocate(size_t size) override {
+    size_t* block = (size_t*)malloc(sizeof(max_align_t) + size);
+    if (block == NULL) {
+      return NULL;
+    }
+    *block = size;
+    add(size);
+    return (uint8_t*)block + sizeof(max_align_t);
+  }
+
+  void deallocate(void* ptr) override {
+    if (ptr != NULL) {
+      size_t* block = (size_t*)((uint8_t*)ptr - sizeof(max_align_t));
+      current -= *block;
+      free(block);
+    }
+  }
+
+  void* reallocate(void* ptr, size_t size) override {
+    if (ptr == NULL) {
+      return allocate(size);
+    }
+    size_t* block = (size_t*)((uint8_t*)ptr - sizeof(max_align_t));
+    size_t old = *block;
+    block = (size_t*)realloc(block, sizeof(max_align_t) + size);
+    if (block == NULL) {
+      return NULL;
+    }
+    *block = size;
+    current -= old;
+    add(size);
+    return (uint8_t*)block + sizeof(max_align_t);
+  }
+
+  size_t current;
+  size_t peak;
+
+ private:
+  void add(size_t size) {
+    current += size;
+    peak = current > peak ? current : peak;
+  }
+};
+
+/**
+ * Fields the firmware reads from an entry
+ */
+struct Entry {
+  int32_t dt;
+  int32_t temp;  // 1/100 degrees
+  int32_t pop;   // Percent
+  uint16_t id;
+  char icon[4];
+};
+
+static bool sameEntry(const Entry& a, const Entry& b) {
+  return a.dt == b.dt && a.temp == b.temp && a.pop == b.pop && a.id == b.id && strcmp(a.icon, b.icon) == 0;
+}
+
+/**
+ * Reads an entry as readWeatherInfo does
+ */
+static Entry readEntry(JsonVariantConst entry) {
+  Entry result;
+  result.dt = entry["dt"].as<int32_t>();
+  result.temp = (int32_t)lround(entry["temp"].as<float>() * 100);
+  result.pop = (int32_t)lround(entry["pop"].as<float>() * 100);
+  result.id = entry["weather"][0]["id"].as<uint16_t>();
+  const char* icon = entry["weather"][0]["icon"].as<const char*>();
+  snprintf(result.icon, sizeof(result.icon), "%s", icon != NULL ? icon : "");
+  return result;
+}
+
+/**
+ * Reader over the body with the interface of the parse stage's PipeReader:
+ * read()/readBytes() for ArduinoJson, peek() and find() for the stage
+ */
+class BodyReader {
+ public:
+  explicit BodyReader(const std::string& body) : body_(body), position_(0) {}
+
+  int read() {
+    int c = peek();
+    if (c >= 0) {
+      position_++;
+    }
+    return c;
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = read();
+      if (c < 0) {
+        break;
+      }
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+
+  int peek() {
+    return position_ < body_.size() ? (uint8_t)body_[position_] : -1;
+  }
+
+  bool find(const char* target) {
+    size_t length = strlen(target), matched = 0;
+    while (matched < length) {
+      int c = read();
+      if (c < 0) {
+        return false;
+      }
+      matched = c == target[matched] ? matched + 1 : (c == target[0] ? 1 : 0);
+    }
+    return true;
+  }
+
+ private:
+  const std::string& body_;
+  size_t position_;
+};
+
+static int skipWhitespace(BodyReader& reader) {
+  int c = reader.peek();
+  while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+    reader.read();
+    c = reader.peek();
+  }
+  return c;
+}
+
+/**
+ * The old parse: the body as a String, its copy in jsonBuffer, and the whole document
+ *
+ * @return Peak heap in bytes
+ */
+static size_t parseString(const std::string& body, std::vector<Entry>& entries) {
+  CountingAllocator heap;
+  char* payload = (char*)heap.allocate(body.size() + 1);     // http.getString()
+  memcpy(payload, body.c_str(), body.size() + 1);
+  char* jsonBuffer = (char*)heap.allocate(body.size() + 1);  // jsonBuffer = jsonData
+  memcpy(jsonBuffer, payload, body.size() + 1);
+  {
+    JsonDocument doc(&heap);
+    DeserializationError error = deserializeJson(doc, (const char*)payload);
+    check(error == DeserializationError::Ok, "the String parse reads the response");
+    entries.push_back(readEntry(doc["current"].as<JsonVariantConst>()));
+    for (JsonVariantConst entry : doc["hourly"].as<JsonArrayConst>()) {
+      entries.push_back(readEntry(entry));
+    }
+  }
+  heap.deallocate(jsonBuffer);
+  heap.deallocate(payload);
+  check(heap.current == 0, "the String parse frees everything");
+  return heap.peak;
+}
+
+/**
+ * The parse stage: one filtered entry at a time in the arena
+ *
+ * @return Arena high-water mark in bytes
+ */
+static size_t parseStream(const std::string& body, std::vector<Entry>& entries) {
+  ARENA arena;
+  Arena_Init(&arena, arenaBuffer, sizeof(arenaBuffer));
+  BodyReader reader(body);
+
+  ArenaAllocator allocator(&arena);
+  JsonDocument filter(&allocator);
+  filter["dt"] = true;
+  filter["temp"] = true;
+  filter["pop"] = true;
+  filter["weather"][0]["id"] = true;
+  filter["weather"][0]["icon"] = true;
+
+  bool parsed = false;
+  if (reader.find("\"current\"") && reader.find(":")) {
+    int c = ':';
+    do {
+      ARENA_MARK mark = Arena_Mark(&arena);
+      DeserializationError error;
+      {
+        JsonDocument entry(&allocator);
+        error = deserializeJson(entry, reader, DeserializationOption::Filter(filter));
+        if (error == DeserializationError::Ok) {
+          entries.push_back(readEntry(entry.as<JsonVariantConst>()));
+        }
+      }
+      Arena_Rewind(&arena, mark);
+      if (error != DeserializationError::Ok) {
+        break;
+      }
+
+      // After "current", move into the "hourly" array
+      if (entries.size() == 1 && !(reader.find("\"hourly\"") && reader.find("["))) {
+        break;
+      }
+      c = skipWhitespace(reader);
+      if (c == ',') {
+        reader.read();
+        c = skipWhitespace(reader);
+      }
+      parsed = c == ']';
+    } while (c != ']' && c >= 0);
+  }
+  check(parsed, "the stream parse reads the response");
+  return arena.highWater;
+}
+
+/**
+ * Synthetic One Call 3.0 response, with every field of the real one
+ */
+static std::string syntheticResponse(int hours) {
+  static const struct {
+    uint16_t id;
+    const char* main;
+    const char* description;
+    const char* icon;
+  } CONDITIONS[] = {
+    {800, "Clear", "clear sky", "01d"}, {802, "Clouds", "scattered clouds", "03n"},
+    {500, "Rain", "light rain", "10d"}, {601, "Snow", "snow", "13n"}, {211, "Thunderstorm", "thunderstorm", "11d"}
+  };
+  const int32_t start = 1767225600;
+  char text[640];
+  std::string body = "{\"lat\":35.6895,\"lon\":139.6917,\"timezone\":\"Asia/Tokyo\",\"timezone_offset\":32400,";
+
+  for (int i = -1; i < hours; i++) {
+    const int n = i < 0 ? 0 : i;
+    const int k = (n * 7 + 3) % 5;
+    int32_t dt = i < 0 ? start + 1234 : start + n * 3600;
+    snprintf(text, sizeof(text),
+             "{\"dt\":%d,%s\"temp\":%.2f,\"feels_like\":%.2f,\"pressure\":%d,\"humidity\":%d,\"dew_point\":%.2f,"
+             "\"uvi\":%.2f,\"clouds\":%d,\"visibility\":10000,\"wind_speed\":%.2f,\"wind_deg\":%d,\"wind_gust\":%.2f,"
+             "\"weather\":[{\"id\":%d,\"main\":\"%s\",\"description\":\"%s\",\"icon\":\"%s\"}]%s%s}",
+             (int)dt, i < 0 ? "\"sunrise\":1767217380,\"sunset\":1767253020," : "", 5.5 + n * 0.37 - (n % 7) * 0.9,
+             3.1 + n * 0.3, 1012 + n % 9, 40 + n % 50, -2.5 + n * 0.11, (n % 12) * 0.41, (n * 13) % 100,
+             1.5 + (n % 8) * 0.7, (n * 37) % 360, 3.2 + (n % 5) * 1.1, CONDITIONS[k].id, CONDITIONS[k].main,
+             CONDITIONS[k].description, CONDITIONS[k].icon, i < 0 ? "" : ",\"pop\":",
+             i < 0 ? "" : std::to_string(((n * 17) % 101) / 100.0).substr(0, 4).c_str());
+    if (i < 0) {
+      body += std::string("\"current\":") + text + ",\"hourly\":[";
+    } else {
+      body += text;
+      body += i + 1 < hours ? "," : "]}";
+    }
+  }
+  return body;
+}
+
+static bool readFile(const char* path, std::string& body) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    return false;
+  }
+  char buffer[4096];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    body.append(buffer, length);
+  }
+  fclose(file);
+  return true;
+}
+
+/**
+ * Parses one response both ways and reports the peaks
+ */
+static void report(const char* name, const std::string& body) {
+  std::vector<Entry> fromString, fromStream;
+  const int rounds = 200;
+  size_t stringPeak = 0, streamPeak = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    fromString.clear();
+    stringPeak = parseString(body, fromString);
+  }
+  double stringUs =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    fromStream.clear();
+    streamPeak = parseStream(body, fromStream);
+  }
+  double streamUs =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+  bool same = fromString.size() == fromStream.size();
+  for (size_t i = 0; same && i < fromString.size(); i++) {
+    same = sameEntry(fromString[i], fromStream[i]);
+  }
+  check(fromString.size() > 1, "the response has hourly entries");
+  check(same, "both parses read the same entries");
+
+  size_t queue = CHUNK_QUEUE_DEPTH * sizeof(PipeChunk);
+  printf("%s: %u bytes, %u entries\n", name, (unsigned)body.size(), (unsigned)fromString.size());
+  printf("%-8s %10s %10s\n", "parse", "peak B", "time us");
+  printf("%-8s %10u %10.1f\n", "String", (unsigned)stringPeak, stringUs);
+  printf("%-8s %10u %10.1f  (+%u B of chunk queue)\n", "Stream", (unsigned)streamPeak, streamUs, (unsigned)queue);
+  check(stringPeak > 2 * body.size(), "the String parse holds the body twice");
+  check(streamPeak + queue < stringPeak / 2, "the stream parse needs under half the memory");
+}
+
+int main(int argc, char** argv) {
+  std::string body;
+  if (argc > 1 && !readFile(argv[1], body)) {
+    printf("Cannot read %s\n", argv[1]);
+    return 1;
+  }
+
+  report("TEST_WEATHER_DATA", TEST_WEATHER_DATA);
+  report(argc > 1 ? argv[1] : "Synthetic 48-hour response", body.empty() ? syntheticResponse(48) : body);
+
+  // The stream peak is one entry, whatever the length of the series
+  std::vector<Entry> few, many;
+  size_t fewPeak = parseStream(syntheticResponse(6), few);
+  size_t manyPeak = parseStream(syntheticResponse(96), many);
+  printf("Stream peak with 6 and 96 hourly entries: %u and %u B\n", (unsigned)fewPeak, (unsigned)manyPeak);
+  check(manyPeak <= fewPeak + 256, "the stream peak does not grow with the response");
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
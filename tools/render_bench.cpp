@@ -0,0 +1,110 @@
+/**
+ * Host benchmark of the tile-parallel forecast renderer
+ *
+ * Renders fixture frames of random forecasts with the device layout
+ * (ForecastView), first in one pass and then with TileRender_Frame on
+ * 1, 2, 4 and 8 threads. Prints frames per second for each thread count,
+ * and fails if any frame differs from the one-pass rendering by a byte.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -pthread -Isrc tools/render_bench.cpp src/EPD.cpp src/AssetCodec.cpp \
+ *       src/Forecast.cpp src/ForecastView.cpp src/TileRender.cpp src/Pipeline.cpp src/FrameOps.cpp \
+ *       -o render_bench
+ *   ./render_bench [frames]
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EPD.h"
+#include "Forecast.h"
+#include "ForecastView.h"
+#include "TileRender.h"
+#include "icons_rle.h"
+#include "check.h"
+
+static const int BUFFER_SIZE = EPD_W / 8 * EPD_H;
+static const int THREAD_COUNTS[] = {1, 2, 4, 8};
+
+/**
+ * Deterministic pseudo-random numbers, so every run renders the same frames
+ */
+/**
+ * Builds the column text of one fixture frame
+ */
+static void makeFixture(uint32_t* random, ForecastSlotText* slots) {
+  int32_t now = 1749681000 + (int32_t)(nextRandom(random) % (365 * 86400));
+  for (int i = 0; i < FORECAST_VIEW_COLUMNS; i++) {
+    ForecastInfo info;
+    info.time = now + i * 3 * 3600;
+    info.temperature = (int16_t)((int)(nextRandom(random) % 5000) - 1500);
+    info.pop = (uint8_t)(nextRandom(random) % 101);
+    info.iconNumber = (uint8_t)(nextRandom(random) % ICON_COUNT);
+    Forecast_FormatSlot(&slots[i], &info, 9 * 3600, 'C', i != 0, i == 0 && nextRandom(random) % 8 == 0 ? now : 0);
+  }
+}
+
+/**
+ * Renders one frame into a buffer
+ */
+static void renderFrame(uint8_t* buffer, const ForecastView* view, uint8_t tiles, uint8_t threads) {
+  Paint_NewImage(buffer, EPD_W, EPD_H, Rotation, WHITE);
+  TileRender_Frame(ForecastView_Draw, (void*)view, tiles, threads);
+}
+
+int main(int argc, char** argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 2000;
+  if (frames <= 0) {
+    frames = 2000;
+  }
+
+  const COMPRESSED_ASSET* icons[ICON_COUNT];
+  for (int i = 0; i < ICON_COUNT; i++) {
+    icons[i] = &Weather_Icons[i];
+  }
+
+  std::vector<ForecastSlotText> fixtures(frames * FORECAST_VIEW_COLUMNS);
+  uint32_t random = 0x12345678;
+  for (int f = 0; f < frames; f++) {
+    makeFixture(&random, &fixtures[f * FORECAST_VIEW_COLUMNS]);
+  }
+
+  // Reference frames, drawn in one pass
+  std::vector<uint8_t> reference((size_t)frames * BUFFER_SIZE);
+  auto start = std::chrono::steady_clock::now();
+  for (int f = 0; f < frames; f++) {
+    ForecastView view = {&fixtures[f * FORECAST_VIEW_COLUMNS], FORECAST_VIEW_ALL_COLUMNS, true, icons,
+                         NULL, NULL, false, 0};
+    renderFrame(&reference[(size_t)f * BUFFER_SIZE], &view, 1, 1);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%d frames, %d bytes each\n", frames, BUFFER_SIZE);
+  printf("one pass   %8.1f frames/s\n", frames / seconds);
+
+  uint8_t* buffer = (uint8_t*)malloc(BUFFER_SIZE);
+  int mismatches = 0;
+  for (int threads : THREAD_COUNTS) {
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+      ForecastView view = {&fixtures[f * FORECAST_VIEW_COLUMNS], FORECAST_VIEW_ALL_COLUMNS, true, icons,
+                         NULL, NULL, false, 0};
+      memset(buffer, 0xA5, BUFFER_SIZE);  // Every byte must be drawn
+      renderFrame(buffer, &view, threads * 2, threads);
+      if (memcmp(buffer, &reference[(size_t)f * BUFFER_SIZE], BUFFER_SIZE) != 0) {
+        mismatches++;
+      }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%d thread%s  %8.1f frames/s\n", threads, threads == 1 ? " " : "s", frames / seconds);
+  }
+  free(buffer);
+
+  if (mismatches > 0) {
+    printf("FAILED: %d frames differ from the one-pass rendering\n", mismatches);
+    return 1;
+  }
+  printf("All frames identical to the one-pass rendering\n");
+  return 0;
+}
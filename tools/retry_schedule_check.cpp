@@ -0,0 +1,182 @@
+/**
+ * Checks the retry schedule on the host with a simulated clock
+ *
+ * Steps RetryPolicy through the wakes of a device, the way retryUpdateLater
+ * does: the classification of each status code; the backoff of
+ * consecutive transient failures, each delay in the upper half of its
+ * doubled step up to the update interval; the reset after a success; the
+ * stop on fatal errors; Retry-After on 429 in seconds and as an HTTP date,
+ * which is ignored while the time is unknown; and the state kept across
+ * Retry_Init. Then replays outages of 1 to 12 hours and reports the
+ * attempts made and how long after the end of each the device updated,
+ * and checks that devices failing together spread their retries. Exits
+ * with 1 on a failure.
+ *
+ * The settings mirror config.template.h: RETRY_INTERVAL_MINUTES 15,
+ * INTERVAL_IN_MINUTES 60.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/retry_schedule_check.cpp src/RetryPolicy.cpp -o retry_schedule_check
+ *   ./retry_schedule_check
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "RetryPolicy.h"
+#include "check.h"
+
+static const RetryConfig CONFIG = {15 * 60, 60 * 60};
+static const int32_t START = 1767225600;  // 2026-01-01 00:00 UTC
+
+static void fresh(RetryState* state, uint32_t seed) {
+  memset(state, 0, sizeof(*state));
+  Retry_Init(state, seed);
+}
+
+static void checkClassify() {
+  check(Retry_Classify(200) == RETRY_NONE, "200 is success");
+  check(Retry_Classify(400) == RETRY_FATAL && Retry_Classify(401) == RETRY_FATAL && Retry_Classify(404) == RETRY_FATAL,
+        "400, 401 and 404 are fatal");
+  check(Retry_Classify(429) == RETRY_RATE_LIMITED, "429 is rate limited");
+  check(Retry_Classify(500) == RETRY_TRANSIENT && Retry_Classify(503) == RETRY_TRANSIENT, "5xx is transient");
+  check(Retry_Classify(-1) == RETRY_TRANSIENT && Retry_Classify(RETRY_CODE_NO_NETWORK) == RETRY_TRANSIENT &&
+        Retry_Classify(RETRY_CODE_BAD_RESPONSE) == RETRY_TRANSIENT,
+        "transport, Wi-Fi and parse failures are transient");
+}
+
+static void checkBackoff() {
+  static const uint32_t STEPS[] = {900, 1800, 3600, 3600, 3600, 3600};
+  for (uint32_t seed = 1; seed <= 200; seed++) {
+    RetryState state;
+    fresh(&state, seed);
+    for (size_t i = 0; i < sizeof(STEPS) / sizeof(STEPS[0]); i++) {
+      RetryDecision decision = Retry_OnFailure(&state, &CONFIG, 503, -1);
+      check(decision.errorClass == RETRY_TRANSIENT, "a 503 is retried");
+      check(decision.delaySeconds >= STEPS[i] - STEPS[i] / 2 && decision.delaySeconds <= STEPS[i],
+            "each delay is in the upper half of its doubled step");
+    }
+    check(state.attempts == 6 && state.lastCode == 503, "the failures are counted");
+
+    Retry_OnSuccess(&state);
+    RetryDecision decision = Retry_OnFailure(&state, &CONFIG, -1, -1);
+    check(decision.delaySeconds >= 450 && decision.delaySeconds <= 900, "a success starts the backoff over");
+  }
+
+  RetryState state;
+  fresh(&state, 7);
+  for (int i = 0; i < 70000; i++) {
+    Retry_OnFailure(&state, &CONFIG, 500, -1);
+  }
+  RetryDecision decision = Retry_OnFailure(&state, &CONFIG, 500, -1);
+  check(state.attempts == UINT16_MAX && decision.delaySeconds <= 3600, "the count saturates and the cap holds");
+
+  fresh(&state, 7);
+  decision = Retry_OnFailure(&state, &CONFIG, 401, -1);
+  check(decision.errorClass == RETRY_FATAL && decision.delaySeconds == 0, "a fatal error is not retried");
+}
+
+static void checkRetryAfter() {
+  const int32_t now = START + 5000;
+  check(Retry_ParseRetryAfter("120", now) == 120, "delay-seconds");
+  check(Retry_ParseRetryAfter(" 0", now) == 0, "zero delay-seconds with leading space");
+  check(Retry_ParseRetryAfter("999999999999", now) == RETRY_AFTER_LIMIT, "long delay-seconds are clamped");
+  check(Retry_ParseRetryAfter("Thu, 01 Jan 2026 01:30:00 GMT", now) == 400, "an HTTP date");
+  check(Retry_ParseRetryAfter("Wed, 31 Dec 2025 23:00:00 GMT", now) == 0, "a date in the past");
+  check(Retry_ParseRetryAfter("Thu, 01 Jan 2026 01:30:00 GMT", 0) == -1, "a date while the time is unknown");
+  check(Retry_ParseRetryAfter("Thu, 01 Foo 2026 01:30:00 GMT", now) == -1, "an unknown month");
+  check(Retry_ParseRetryAfter("soon", now) == -1 && Retry_ParseRetryAfter("", now) == -1 &&
+        Retry_ParseRetryAfter(NULL, now) == -1, "invalid values");
+  check(Retry_ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT") == 784111777, "the RFC 9110 example date");
+
+  RetryState state;
+  fresh(&state, 99);
+  for (int i = 0; i < 100; i++) {
+    RetryDecision decision = Retry_OnFailure(&state, &CONFIG, 429, 600);
+    check(decision.errorClass == RETRY_RATE_LIMITED && decision.delaySeconds >= 600 && decision.delaySeconds <= 661,
+          "Retry-After replaces the backoff, plus up to 10%");
+  }
+  RetryDecision decision = Retry_OnFailure(&state, &CONFIG, 429, RETRY_AFTER_LIMIT * 4);
+  check(decision.delaySeconds >= RETRY_AFTER_LIMIT && decision.delaySeconds <= RETRY_AFTER_LIMIT * 11 / 10 + 1,
+        "a long Retry-After is clamped to a day");
+  decision = Retry_OnFailure(&state, &CONFIG, 429, -1);
+  check(decision.delaySeconds <= CONFIG.maxSeconds, "a 429 without Retry-After backs off");
+}
+
+static void checkInit() {
+  RetryState state;
+  fresh(&state, 0);
+  check(state.random != 0, "a zero seed still jitters");
+  Retry_OnFailure(&state, &CONFIG, 500, -1);
+  Retry_OnFailure(&state, &CONFIG, 500, -1);
+  Retry_Init(&state, 1234);
+  check(state.attempts == 2, "a valid state survives Retry_Init after deep sleep");
+  state.magic ^= 1;
+  Retry_Init(&state, 1234);
+  check(state.attempts == 0 && state.random == 1234, "a damaged state starts over");
+}
+
+/**
+ * Simulated outage: wakes retry on the schedule until the service is back
+ *
+ * @return Seconds from the end of the outage to the update
+ */
+static int32_t outage(uint32_t seed, int32_t outageSeconds, int* attempts) {
+  RetryState state;
+  fresh(&state, seed);
+  int32_t now = START;
+  *attempts = 0;
+  while (now < START + outageSeconds) {
+    (*attempts)++;
+    now += Retry_OnFailure(&state, &CONFIG, 503, -1).delaySeconds;
+  }
+  Retry_OnSuccess(&state);
+  return now - (START + outageSeconds);
+}
+
+static void checkOutages() {
+  static const int HOURS[] = {1, 2, 4, 12};
+  printf("outage h  attempts  mean late s  worst late s\n");
+  for (size_t i = 0; i < sizeof(HOURS) / sizeof(HOURS[0]); i++) {
+    int32_t worst = 0;
+    double mean = 0, meanAttempts = 0;
+    const int devices = 1000;
+    for (int device = 1; device <= devices; device++) {
+      int attempts;
+      int32_t late = outage(device * 2654435761U, HOURS[i] * 3600, &attempts);
+      worst = late > worst ? late : worst;
+      mean += late;
+      meanAttempts += attempts;
+    }
+    printf("%8d  %8.1f  %11.0f  %12d\n", HOURS[i], meanAttempts / devices, mean / devices, (int)worst);
+    check(worst <= (int32_t)CONFIG.maxSeconds, "the update follows the end of an outage within an interval");
+    check(meanAttempts / devices <= HOURS[i] * 2 + 2, "an outage costs about one attempt per interval");
+  }
+
+  // Devices failing at the same moment do not retry at the same second
+  RetryState a, b;
+  fresh(&a, 0x1111);
+  fresh(&b, 0x2222);
+  int together = 0;
+  int32_t timeA = START, timeB = START;
+  for (int i = 0; i < 50; i++) {
+    timeA += Retry_OnFailure(&a, &CONFIG, 503, -1).delaySeconds;
+    timeB += Retry_OnFailure(&b, &CONFIG, 503, -1).delaySeconds;
+    together += timeA == timeB;
+  }
+  check(together <= 1, "jitter spreads the retries of devices that failed together");
+}
+
+int main() {
+  checkClassify();
+  checkBackoff();
+  checkRetryAfter();
+  checkInit();
+  checkOutages();
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * Checks the state store on the host
+ *
+ * Runs records the size of the device's through boot cycles: a commit
+ * and a warm load keep everything; a damaged record is cleared alone; a
+ * damaged header, a cold start, another build or a changed table clear
+ * everything and restore the mirrored record from the file backend; a
+ * damaged or outdated mirror is not restored; and the backend is written
+ * only when a mirrored record changes. Then times a load. Exits with 1 on
+ * a failure.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/state_store_check.cpp src/StateStore.cpp -o state_store_check
+ *   ./state_store_check [directory for the mirror files, default /tmp]
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include "StateStore.h"
+#include "check.h"
+
+static const uint32_t BUILD = 0x1234;
+
+// Stand-ins for the device's records: forecast cache, frame snapshot, small states
+static uint8_t forecast[400];
+static uint8_t frame[4108];
+static uint8_t retry[16];
+static uint8_t schedule[24];
+static uint8_t battery[12];
+
+static StateStore store;
+static StateRecord records[] = {
+  {"forecast", 1, sizeof(forecast), forecast, true},
+  {"frame", 1, sizeof(frame), frame, false},
+  {"retry", 1, sizeof(retry), retry, false},
+  {"schedule", 1, sizeof(schedule), schedule, false},
+  {"battery", 1, sizeof(battery), battery, false}
+};
+static const int RECORD_COUNT = sizeof(records) / sizeof(records[0]);
+
+static StateBackend files;
+static int writes = 0;
+
+/**
+ * File backend that counts the writes
+ */
+static bool countingWrite(void*, const char* key, const void* data, size_t size) {
+  writes++;
+  return files.write(files.context, key, data, size);
+}
+
+static bool passRead(void*, const char* key, void* data, size_t size) {
+  return files.read(files.context, key, data, size);
+}
+
+static void fill(uint8_t seed) {
+  for (int i = 0; i < RECORD_COUNT; i++) {
+    uint8_t* bytes = (uint8_t*)records[i].data;
+    for (size_t j = 0; j < records[i].size; j++) {
+      bytes[j] = (uint8_t)(seed + i * 31 + j * 7);
+    }
+  }
+}
+
+static bool filled(int record, uint8_t seed) {
+  const uint8_t* bytes = (const uint8_t*)records[record].data;
+  for (size_t j = 0; j < records[record].size; j++) {
+    if (bytes[j] != (uint8_t)(seed + record * 31 + j * 7)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool zeros(int record) {
+  const uint8_t* bytes = (const uint8_t*)records[record].data;
+  for (size_t j = 0; j < records[record].size; j++) {
+    if (bytes[j] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  StateStore_FileBackend(&files, argc > 1 ? argv[1] : "/tmp");
+  StateBackend backend = {passRead, countingWrite, NULL};
+
+  check(StateStore_Crc32(0, "123456789", 9) == 0xCBF43926, "CRC-32 of the check string");
+  check(StateStore_Crc32(StateStore_Crc32(0, "1234", 4), "56789", 5) == 0xCBF43926, "CRC-32 continues");
+
+  // First boot: nothing to keep
+  memset(&store, 0xA5, sizeof(store));  // RTC memory after power-up
+  StateLoadResult result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, true, &backend);
+  check(!result.warm && result.cleared == RECORD_COUNT, "the first boot clears every record");
+
+  // A wake fills the records, then sleeps
+  fill(1);
+  writes = 0;
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  check(writes == 2, "the changed mirrored record is written, data and header");
+
+  // Warm wake
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, false, &backend);
+  check(result.warm && result.kept == RECORD_COUNT, "a warm wake keeps every record");
+  for (int i = 0; i < RECORD_COUNT; i++) {
+    check(filled(i, 1), "kept records are unchanged");
+  }
+  writes = 0;
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  check(writes == 0, "an unchanged mirrored record is not written again");
+
+  // A damaged record is cleared alone
+  frame[100] ^= 1;
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, false, &backend);
+  check(result.warm && result.cleared == 1 && result.kept == RECORD_COUNT - 1, "only the damaged record is cleared");
+  check(zeros(1) && filled(0, 1) && filled(2, 1), "the damaged record is zeros, the others kept");
+
+  // A damaged mirrored record comes back from the backend
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  forecast[0] ^= 0x80;
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, false, &backend);
+  check(result.restored == 1 && filled(0, 1), "a damaged mirrored record is restored");
+
+  // Cold starts: reset, damaged header, another build, another table
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, true, &backend);
+  check(!result.warm && result.restored == 1 && filled(0, 1) && zeros(2), "a cold start keeps only the mirror");
+
+  fill(2);
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  ((uint8_t*)&store)[5] ^= 1;
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, false, &backend);
+  check(!result.warm && filled(0, 2) && zeros(4), "a damaged header clears every record");
+
+  fill(3);
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD + 1, false, &backend);
+  check(!result.warm && filled(0, 3) && zeros(3), "another build clears every record");
+
+  fill(4);
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  records[2].version = 2;
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD + 1, false, &backend);
+  check(!result.warm && filled(0, 4) && zeros(2), "a changed record version clears every record");
+  records[2].version = 1;
+
+  // Mirrors that do not match are not restored
+  fill(5);
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  records[0].version = 2;
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, true, &backend);
+  check(result.restored == 0 && zeros(0), "a mirror of another version is not restored");
+  records[0].version = 1;
+
+  fill(6);
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  uint8_t stale[sizeof(forecast)];
+  memset(stale, 0x5A, sizeof(stale));
+  files.write(files.context, "forecast", stale, sizeof(stale));  // Data written, header of the old data
+  result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, true, &backend);
+  check(result.restored == 0 && zeros(0), "a mirror failing its CRC is not restored");
+
+  // Time of a warm load, every byte checked
+  fill(7);
+  StateStore_Commit(&store, records, RECORD_COUNT, &backend);
+  const int rounds = 2000;
+  size_t bytes = 0;
+  for (int i = 0; i < RECORD_COUNT; i++) {
+    bytes += records[i].size;
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    result = StateStore_Load(&store, records, RECORD_COUNT, BUILD, false, &backend);
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+  check(result.kept == RECORD_COUNT, "repeated loads keep every record");
+  printf("Warm load of %u bytes in %u records: %.1f us on the host\n", (unsigned)bytes, (unsigned)RECORD_COUNT, us);
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * Simulates four weeks of aligned wakes with a drifting local clock
+ *
+ * Runs the device's wake loop against WakeScheduler: each wake takes a
+ * random 8 to 20 s from wake-up to the display refresh, syncs with the
+ * Date header of a response (whole seconds, 50 to 500 ms behind the
+ * response), and sleeps for WakeScheduler_SleepUs. The local clock drifts
+ * by a fixed rate plus a daily swing of 60 ppm, as the RTC slow clock
+ * does with the temperature. After the first day, reports how far each
+ * wake-up lands from where the scheduler aimed it (the hour less the
+ * learned lead) and how far each refresh lands from the hour, which also
+ * includes the wake's own spread in length. Checks that the wake-ups stay
+ * within a few seconds for drift inside WAKE_MAX_DRIFT_PPM, that drift outside
+ * it is not learned, and that a Date off by minutes leaves the estimate
+ * alone; the next wake-up still follows that Date, and the one after is
+ * back on the hour. Exits with 1 on a failure.
+ *
+ * The settings mirror config.template.h: hourly updates on the hour,
+ * TIMEZONE_OFFSET 9.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Isrc tools/wake_schedule_sim.cpp src/WakeScheduler.cpp -o wake_schedule_sim
+ *   ./wake_schedule_sim
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "WakeScheduler.h"
+#include "check.h"
+
+static const int32_t UTC_OFFSET = 9 * 3600;
+static const double START = 1767225600.0 + 1234.5;  // 2026-01-01, mid-hour
+static const uint32_t INTERVAL = 3600;
+static const uint32_t ALIGN = 3600;
+static const int DAYS = 28;
+static const double SWING_PPM = 60;
+
+static double uniform(uint32_t* random, double low, double high) {
+  return low + (high - low) * (nextRandom(random) % 1000001) / 1000000.0;
+}
+
+/**
+ * Wall time and the device's local clock, which runs fast by the drift
+ */
+struct Clocks {
+  double wall;          // Seconds (UTC)
+  double localUs;       // Local clock, 0 at power-up
+  double basePpm;
+};
+
+static void advance(Clocks* clocks, double seconds) {
+  // Small steps, so the daily swing is followed
+  while (seconds > 0) {
+    double step = seconds < 60 ? seconds : 60;
+    double ppm = clocks->basePpm + SWING_PPM * sin(2 * M_PI * clocks->wall / 86400);
+    clocks->localUs += step * 1e6 * (1 + ppm / 1e6);
+    clocks->wall += step;
+    seconds -= step;
+  }
+}
+
+/**
+ * Sleeps a local clock duration
+ */
+static void sleepLocal(Clocks* clocks, uint64_t sleepUs) {
+  double targetUs = clocks->localUs + (double)sleepUs;
+  while (targetUs - clocks->localUs > 1) {
+    double ppm = clocks->basePpm + SWING_PPM * sin(2 * M_PI * clocks->wall / 86400);
+    double step = (targetUs - clocks->localUs) / 1e6 / (1 + ppm / 1e6);
+    advance(clocks, step < 60 ? step : 60);
+  }
+}
+
+struct Result {
+  double wakeWorstS;    // Largest distance of a wake-up from its aim
+  double refreshWorstS; // Largest distance of a refresh from the hour
+  double refreshMeanS;
+  int32_t driftPpm;     // Learned at the end
+};
+
+/**
+ * One run of DAYS days
+ *
+ * @param basePpm Fixed part of the drift
+ * @param badDateWake Wake whose Date is two minutes late, -1 for none
+ */
+static Result run(double basePpm, int badDateWake) {
+  Clocks clocks = {START, 0, basePpm};
+  WakeSchedule schedule;
+  memset(&schedule, 0, sizeof(schedule));
+  WakeScheduler_Init(&schedule);
+  uint32_t random = 0x2545F491;
+
+  Result result = {0, 0, 0, 0};
+  int counted = 0;
+  int32_t driftBefore = 0;
+  double aim = 0;       // Wall time the scheduler aimed the wake-up at
+  for (int wake = 0; clocks.wall < START + DAYS * 86400.0; wake++) {
+    double wakeLocalUs = clocks.localUs;
+    bool judged = clocks.wall > START + 86400;
+    if (judged) {
+      double error = fabs(clocks.wall - aim);
+      result.wakeWorstS = error > result.wakeWorstS ? error : result.wakeWorstS;
+    }
+    double leadS = uniform(&random, 8, 20);
+
+    // Request: the response arrives a few seconds into the wake
+    advance(&clocks, uniform(&random, 3, 6));
+    double dateWall = clocks.wall - uniform(&random, 0.05, 0.5);
+    int32_t date = (int32_t)floor(dateWall) + (wake == badDateWake ? 120 : 0);
+    if (wake == badDateWake) {
+      driftBefore = schedule.driftPpm;
+    }
+    WakeScheduler_Sync(&schedule, date, (int64_t)clocks.localUs);
+    if (wake == badDateWake) {
+      check(schedule.driftPpm == driftBefore, "a Date two minutes off does not change the drift estimate");
+    }
+
+    // Refresh
+    double refreshWall = clocks.wall + (leadS - (clocks.localUs - wakeLocalUs) / 1e6);
+    advance(&clocks, refreshWall - clocks.wall);
+    double local = clocks.wall + UTC_OFFSET;
+    double offset = local - floor(local / ALIGN + 0.5) * ALIGN;
+    if (judged) {
+      result.refreshWorstS = fabs(offset) > result.refreshWorstS ? fabs(offset) : result.refreshWorstS;
+      result.refreshMeanS += fabs(offset);
+      counted++;
+    }
+    WakeScheduler_RecordLead(&schedule, (uint32_t)((clocks.localUs - wakeLocalUs) / 1000));
+
+    // Shut down, then sleep
+    advance(&clocks, 1);
+    double boundary = floor((clocks.wall + UTC_OFFSET + INTERVAL - ALIGN / 2) / ALIGN + 1) * ALIGN - UTC_OFFSET;
+    aim = boundary - schedule.leadMs / 1000.0;
+    sleepLocal(&clocks, WakeScheduler_SleepUs(&schedule, (int64_t)clocks.localUs, UTC_OFFSET, INTERVAL, ALIGN));
+  }
+
+  result.refreshMeanS = counted > 0 ? result.refreshMeanS / counted : 0;
+  result.driftPpm = schedule.driftPpm;
+  return result;
+}
+
+int main() {
+  static const double DRIFTS[] = {0, 150, -150, 400, -400};
+  printf("drift ppm  learned ppm  wake-up worst s  refresh mean s  refresh worst s\n");
+  for (size_t i = 0; i < sizeof(DRIFTS) / sizeof(DRIFTS[0]); i++) {
+    Result result = run(DRIFTS[i], -1);
+    printf("%9.0f  %11d  %15.2f  %14.2f  %15.2f\n", DRIFTS[i], (int)result.driftPpm, result.wakeWorstS,
+           result.refreshMeanS, result.refreshWorstS);
+    check(fabs(result.driftPpm - DRIFTS[i]) < SWING_PPM, "the drift is learned");
+    check(result.wakeWorstS < 3, "every wake-up lands within 3 s of its aim");
+    check(result.refreshWorstS < 13, "every refresh lands within the spread of the wake length of the hour");
+  }
+
+  // Beyond the gate: nothing is learned, and each wake snaps back to the grid from the last sync
+  Result fast = run(2000, -1);
+  printf("%9.0f  %11d  %15.2f  %14.2f  %15.2f  beyond WAKE_MAX_DRIFT_PPM\n", 2000.0, (int)fast.driftPpm,
+         fast.wakeWorstS, fast.refreshMeanS, fast.refreshWorstS);
+  check(fast.driftPpm == 0, "drift beyond WAKE_MAX_DRIFT_PPM is not learned");
+  check(fast.wakeWorstS < 0.002 * INTERVAL + 1, "an unlearned drift costs no more than one interval of it");
+
+  Result bad = run(150, 200);
+  printf("%9.0f  %11d  %15.2f  %14.2f  %15.2f  one Date two minutes late\n", 150.0, (int)bad.driftPpm,
+         bad.wakeWorstS, bad.refreshMeanS, bad.refreshWorstS);
+
+  if (failures > 0) {
+    printf("%d checks FAILED\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}